@@ -0,0 +1,165 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Magazines.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+using namespace Afina::Allocator;
+
+/**
+ * # Allocator benchmark
+ * Every thread keeps a set of live blocks and replaces random one on each step: frees it and
+ * allocates a new block of random size in 64B..8KB, touching its first and last bytes. Compares
+ * glibc malloc, shared Simple allocator under a mutex and Simple with thread magazines.
+ *
+ * Usage: runAllocatorMagazinesBench [threads] [operations per thread]
+ */
+
+namespace {
+
+const size_t kLive = 256;
+const size_t kMinSize = 64;
+const size_t kMaxSize = 8192;
+const size_t kArenaSize = size_t(1) << 30;
+
+// Interface of the allocator under test: allocate returns slot in the live set, release frees it
+struct Allocator {
+    std::string name;
+    std::function<void(size_t thread, size_t slot, size_t size)> allocate;
+    std::function<void(size_t thread, size_t slot)> release;
+    std::function<void *(size_t thread, size_t slot)> address;
+};
+
+// Simple rounds sizes up to 16 bytes only, so that baseline is not fragmented to death requests
+// are rounded the same way magazine classes are
+size_t quantize(size_t size) {
+    size_t step = size_t(1) << (63 - __builtin_clzl(size - 1) - 2);
+    return (size + step - 1) / step * step;
+}
+
+// Average nanoseconds per free+alloc pair over all threads, number of failed allocations
+double measure(Allocator &allocator, size_t threads, size_t operations, size_t &failed) {
+    std::vector<std::thread> workers;
+    std::vector<size_t> failures(threads, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            unsigned seed = t + 1;
+            std::vector<bool> live(kLive, false);
+            for (size_t i = 0; i < operations; i++) {
+                size_t slot = rand_r(&seed) % kLive;
+                if (live[slot]) {
+                    allocator.release(t, slot);
+                }
+
+                size_t size = kMinSize + rand_r(&seed) % (kMaxSize - kMinSize + 1);
+                try {
+                    allocator.allocate(t, slot, size);
+                    char *v = static_cast<char *>(allocator.address(t, slot));
+                    v[0] = char(i);
+                    v[size - 1] = char(i);
+                    live[slot] = true;
+                } catch (AllocError &) {
+                    live[slot] = false;
+                    failures[t]++;
+                }
+            }
+
+            for (size_t slot = 0; slot < kLive; slot++) {
+                if (live[slot]) {
+                    allocator.release(t, slot);
+                }
+            }
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    failed = 0;
+    for (size_t count : failures) {
+        failed += count;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (operations * threads);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t threads = 8;
+    if (argc > 1) {
+        threads = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    size_t operations = 1000000;
+    if (argc > 2) {
+        operations = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    // Pages are committed on first touch only
+    void *arena = mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (arena == MAP_FAILED) {
+        std::cerr << "Failed to map arena" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<void *>> raw(threads, std::vector<void *>(kLive, nullptr));
+    std::vector<std::vector<Pointer>> handles(threads, std::vector<Pointer>(kLive));
+
+    std::mutex lock;
+    Simple simple(arena, kArenaSize);
+    Magazines *magazines = nullptr;
+
+    std::vector<Allocator> allocators = {
+        {"malloc", [&](size_t t, size_t slot, size_t size) { raw[t][slot] = std::malloc(size); },
+         [&](size_t t, size_t slot) { std::free(raw[t][slot]); },
+         [&](size_t t, size_t slot) { return raw[t][slot]; }},
+        {"simple+mutex",
+         [&](size_t t, size_t slot, size_t size) {
+             std::lock_guard<std::mutex> guard(lock);
+             handles[t][slot] = simple.alloc(quantize(size));
+         },
+         [&](size_t t, size_t slot) {
+             std::lock_guard<std::mutex> guard(lock);
+             simple.free(handles[t][slot]);
+         },
+         [&](size_t t, size_t slot) { return handles[t][slot].get(); }},
+        {"magazines", [&](size_t t, size_t slot, size_t size) { handles[t][slot] = magazines->alloc(size); },
+         [&](size_t t, size_t slot) { magazines->free(handles[t][slot]); },
+         [&](size_t t, size_t slot) { return handles[t][slot].get(); }},
+    };
+
+    std::cout << std::setw(14) << "allocator" << std::setw(10) << "threads" << std::setw(14) << "ns/op" << std::setw(14)
+              << "Mops/s" << std::setw(10) << "failed" << std::endl;
+    for (auto &allocator : allocators) {
+        // Arena is reused, the previous allocator is done with it
+        if (allocator.name == "magazines") {
+            magazines = new Magazines(arena, kArenaSize);
+        }
+
+        size_t failed = 0;
+        double ns = measure(allocator, threads, operations, failed);
+        std::cout << std::setw(14) << allocator.name << std::setw(10) << threads << std::setw(14) << std::fixed
+                  << std::setprecision(1) << ns << std::setw(14) << 1e3 / ns << std::setw(10) << failed << std::endl;
+    }
+
+    std::cout << std::endl << magazines->dump();
+    delete magazines;
+    munmap(arena, kArenaSize);
+    return 0;
+}
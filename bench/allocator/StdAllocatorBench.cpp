@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include <afina/allocator/Magazines.h>
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/StdAllocator.h>
+
+using namespace Afina::Allocator;
+
+/**
+ * # Standard allocator adapter benchmark
+ * Runs workloads typical for storage on standard containers with std::allocator and with arena
+ * allocators behind StdAllocator:
+ * - map: inserts string keys and values into std::map and erases all of them
+ * - vector: grows std::vector one element at a time
+ * - strings: creates and destroys strings of random length
+ *
+ * Usage: runAllocatorStdAllocatorBench [operations]
+ */
+
+namespace {
+
+const size_t kArenaSize = size_t(1) << 30;
+
+// Allocator of the given type, std::allocator is stateless, arena ones need an arena
+template <typename Alloc> struct Factory {
+    template <typename Arena> static Alloc make(Arena *arena) { return Alloc(*arena); }
+};
+template <typename T> struct Factory<std::allocator<T>> {
+    template <typename Arena> static std::allocator<T> make(Arena *) { return std::allocator<T>(); }
+};
+
+template <template <typename> class Alloc, typename Arena> struct Workloads {
+    typedef std::basic_string<char, std::char_traits<char>, Alloc<char>> String;
+    typedef std::map<String, String, std::less<String>, Alloc<std::pair<const String, String>>> Map;
+
+    static String string(Arena *arena, size_t length, char c) {
+        return String(length, c, Factory<Alloc<char>>::make(arena));
+    }
+
+    static size_t map(Arena *arena, size_t operations) {
+        Map map(std::less<String>(), Factory<Alloc<std::pair<const String, String>>>::make(arena));
+        for (size_t i = 0; i < operations; i++) {
+            String key = string(arena, 24, 'k');
+            key[i % 24] = char('a' + (i / 24) % 26);
+            key.append(std::to_string(i).c_str());
+            map.emplace(std::move(key), string(arena, 64, 'v'));
+        }
+
+        size_t size = map.size();
+        map.clear();
+        return size;
+    }
+
+    static size_t vector(Arena *arena, size_t operations) {
+        std::vector<uint64_t, Alloc<uint64_t>> v(Factory<Alloc<uint64_t>>::make(arena));
+        for (size_t i = 0; i < operations; i++) {
+            v.push_back(i);
+        }
+        return v.size();
+    }
+
+    static size_t strings(Arena *arena, size_t operations) {
+        unsigned seed = 1;
+        size_t total = 0;
+        for (size_t i = 0; i < operations; i++) {
+            String s = string(arena, 16 + rand_r(&seed) % 512, 's');
+            total += s.size();
+        }
+        return total;
+    }
+};
+
+template <typename T> using Std = std::allocator<T>;
+template <typename T> using OverSimple = StdAllocator<T, Simple>;
+template <typename T> using OverMagazines = StdAllocator<T, Magazines>;
+
+// Average nanoseconds per operation
+template <typename F> double measure(F f, size_t operations) {
+    auto start = std::chrono::steady_clock::now();
+    size_t result = f(operations);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Make sure compiler doesn't throw work away
+    if (result == 0) {
+        std::cerr << "unreachable" << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / operations;
+}
+
+template <template <typename> class Alloc, typename Arena> void report(const std::string &name, Arena *arena,
+                                                                        size_t operations) {
+    typedef Workloads<Alloc, Arena> W;
+    double map = measure([arena](size_t n) { return W::map(arena, n); }, operations);
+    double vector = measure([arena](size_t n) { return W::vector(arena, n); }, operations * 10);
+    double strings = measure([arena](size_t n) { return W::strings(arena, n); }, operations * 10);
+
+    std::cout << std::setw(16) << name << std::fixed << std::setprecision(1) << std::setw(12) << map << std::setw(12)
+              << vector << std::setw(12) << strings << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t operations = 200000;
+    if (argc > 1) {
+        operations = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    // Pages are committed on first touch only
+    void *area = mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (area == MAP_FAILED) {
+        std::cerr << "Failed to map arena" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::setw(16) << "allocator" << std::setw(12) << "map ns" << std::setw(12) << "vector ns"
+              << std::setw(12) << "string ns" << std::endl;
+
+    report<Std, Simple>("std::allocator", nullptr, operations);
+    {
+        Simple arena(area, kArenaSize);
+        report<OverSimple, Simple>("simple", &arena, operations);
+    }
+    {
+        Magazines arena(area, kArenaSize);
+        report<OverMagazines, Magazines>("magazines", &arena, operations);
+    }
+
+    munmap(area, kArenaSize);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+/**
+ * # Counters benchmark
+ * Increments a counter from a number of threads at once and reports average cost of an increment:
+ * - shared: single atomic all threads write to
+ * - core_local: per CPU atomics, see CoreLocal
+ * - thread_local: per thread atomics, see ThreadLocal
+ *
+ * Cost of figuring out current CPU is reported separately for CoreLocal::Cpu and sched_getcpu.
+ *
+ * Usage: runConcurrencyCountersBench [threads] [increments]
+ */
+
+namespace {
+
+// Average nanoseconds per call of f(thread) made by all threads together
+template <typename F> double measure(size_t threads, size_t increments, F f) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&f, increments]() {
+            for (size_t i = 0; i < increments; i++) {
+                f();
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (threads * increments);
+}
+
+void report(const std::string &name, double ns, int64_t total, int64_t expected) {
+    std::cout << std::setw(16) << name << std::setw(12) << std::fixed << std::setprecision(2) << ns
+              << (total == expected ? "" : "   (lost increments!)") << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t threads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+        threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    size_t increments = 10000000;
+    if (argc > 2) {
+        increments = std::strtoul(argv[2], nullptr, 10);
+    }
+    const int64_t expected = int64_t(threads) * increments;
+
+    std::cout << std::setw(16) << "counter" << std::setw(12) << "ns/op" << std::endl;
+
+    std::atomic<int64_t> shared(0);
+    double ns = measure(threads, increments, [&shared]() { shared.fetch_add(1, std::memory_order_relaxed); });
+    report("shared", ns, shared.load(), expected);
+
+    CoreLocal<std::atomic<int64_t>> core;
+    core.ForEach([](std::atomic<int64_t> &value) { value.store(0); });
+    ns = measure(threads, increments, [&core]() { core.Local().fetch_add(1, std::memory_order_relaxed); });
+    report("core_local", ns,
+           core.Combine(int64_t(0), [](int64_t sum, std::atomic<int64_t> &value) { return sum + value.load(); }),
+           expected);
+
+    ThreadLocal<std::atomic<int64_t>> thread;
+    ns = measure(threads, increments, [&thread]() { thread.Local().fetch_add(1, std::memory_order_relaxed); });
+    report("thread_local", ns,
+           thread.Combine(int64_t(0), [](int64_t sum, std::atomic<int64_t> &value) { return sum + value.load(); }),
+           expected);
+
+    // Sum of CPU numbers keeps compiler from throwing calls away
+    std::atomic<int64_t> sink(0);
+    ns = measure(1, increments, [&sink]() { sink.fetch_add(CoreLocal<int>::Cpu(), std::memory_order_relaxed); });
+    report("Cpu()", ns, 0, 0);
+    ns = measure(1, increments, [&sink]() { sink.fetch_add(sched_getcpu(), std::memory_order_relaxed); });
+    report("sched_getcpu()", ns, 0, 0);
+
+    return sink.load() < 0 ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <afina/coroutine/Engine.h>
+
+using namespace Afina::Coroutine;
+
+/**
+ * # Coroutine switch latency benchmark
+ * Two coroutines pass control to each other in a loop, each one does it from the bottom of a call chain
+ * of the given depth. Reports average time of a single switch for both engine modes: with copied stack
+ * it grows with the depth, with separate stacks it should not.
+ *
+ * Usage: runCoroutineSwitchBench [switches]
+ */
+
+namespace {
+
+// Bytes each level of the call chain keeps on stack
+const size_t kFrameSize = 128;
+
+struct Run {
+    Engine *engine;
+    size_t switches;
+    void *routines[2];
+};
+
+void ping(Run &run, int self) {
+    for (size_t i = 0; i < run.switches / 2; i++) {
+        run.engine->sched(run.routines[1 - self]);
+    }
+}
+
+// Goes down by depth frames, so that used part of the stack is big enough
+void descend(Run &run, int self, size_t depth) {
+    volatile char frame[kFrameSize];
+    frame[0] = 0;
+    if (depth > 0) {
+        descend(run, self, depth - 1);
+    } else {
+        ping(run, self);
+    }
+    frame[kFrameSize - 1] = frame[0];
+}
+
+void routine(Run &run, int self, size_t depth) { descend(run, self, depth); }
+
+void spawner(Run &run, size_t depth) {
+    run.routines[0] = run.engine->run(routine, run, int(0), size_t(depth));
+    run.routines[1] = run.engine->run(routine, run, int(1), size_t(depth));
+    run.engine->sched(run.routines[0]);
+}
+
+// Average nanoseconds per switch
+double measure(Engine::Mode mode, size_t depth, size_t switches) {
+    Engine engine(mode);
+    Run run{&engine, switches, {nullptr, nullptr}};
+
+    auto start = std::chrono::steady_clock::now();
+    engine.start(spawner, run, size_t(depth));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / switches;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t switches = 1000000;
+    if (argc > 1) {
+        switches = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::vector<size_t> depths = {0, 8, 64, 256};
+
+    std::cout << std::setw(12) << "stack bytes" << std::setw(14) << "copy ns" << std::setw(14) << "separate ns"
+              << std::endl;
+    for (size_t depth : depths) {
+        double copy = measure(Engine::Mode::kCopyStack, depth, switches);
+        double separate = measure(Engine::Mode::kSeparateStack, depth, switches);
+        std::cout << std::setw(12) << depth * kFrameSize << std::setw(14) << std::fixed << std::setprecision(1) << copy
+                  << std::setw(14) << separate << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/logger.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Set.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+/**
+ * # Command tracing overhead benchmark
+ * Executes set and get of the same key in a loop and measures average time of the pair depending
+ * on how commands are traced:
+ * - endl: every command is written to the stream with flush, as commands used to do with std::cout.
+ *   Stream goes to /dev/null here, so that report stays readable
+ * - none: no logger set
+ * - off: logger is set, but trace level is disabled, which is what server runs with normally
+ * - trace: trace level enabled, messages are formatted and dropped by null sink
+ *
+ * Usage: runExecuteTraceBench [operations]
+ */
+
+namespace {
+
+const size_t kKeys = 1024;
+const size_t kValueSize = 64;
+
+struct Mode {
+    std::string name;
+    std::shared_ptr<spdlog::logger> logger;
+    bool endl;
+};
+
+std::string make_key(size_t i) { return "user:session:" + std::to_string(i); }
+
+// Average nanoseconds per set+get pair
+double measure(const Mode &mode, size_t operations) {
+    Backend::SimpleLRU storage(kKeys * Backend::SimpleLRU::EntrySize(make_key(kKeys).size(), kValueSize) * 2);
+    Command::SetLogger(mode.logger);
+    std::ofstream stream("/dev/null");
+
+    std::vector<std::unique_ptr<Set>> sets;
+    std::vector<std::unique_ptr<Get>> gets;
+    for (size_t i = 0; i < kKeys; i++) {
+        sets.emplace_back(new Set(make_key(i), 0, 0));
+        gets.emplace_back(new Get({make_key(i)}));
+    }
+
+    const std::string value(kValueSize, 'x');
+    std::string out;
+    size_t answered = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; i++) {
+        Set &set = *sets[i % kKeys];
+        Get &get = *gets[i % kKeys];
+        if (mode.endl) {
+            stream << "Set(" << set.key() << "): " << value << std::endl;
+        }
+        set.Execute(storage, value, out);
+        answered += out.size();
+
+        if (mode.endl) {
+            stream << "Get(" << get.keys()[0] << " )" << std::endl;
+        }
+        get.Execute(storage, "", out);
+        answered += out.size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Make sure compiler doesn't throw commands away
+    if (answered == 0) {
+        std::cerr << "unreachable" << std::endl;
+    }
+    Command::SetLogger(nullptr);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / operations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t operations = 1000000;
+    if (argc > 1) {
+        operations = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    auto sink = std::make_shared<spdlog::sinks::null_sink_mt>();
+    auto disabled = std::make_shared<spdlog::logger>("execute", sink);
+    disabled->set_level(spdlog::level::warn);
+    auto enabled = std::make_shared<spdlog::logger>("execute", sink);
+    enabled->set_level(spdlog::level::trace);
+
+    std::vector<Mode> modes = {
+        {"endl", nullptr, true},
+        {"none", nullptr, false},
+        {"off", disabled, false},
+        {"trace", enabled, false},
+    };
+
+    std::cout << std::setw(8) << "tracing" << std::setw(14) << "ns/set+get" << std::setw(14) << "kops/s" << std::endl;
+    for (auto &mode : modes) {
+        double ns = measure(mode, operations);
+        std::cout << std::setw(8) << mode.name << std::setw(14) << std::fixed << std::setprecision(1) << ns
+                  << std::setw(14) << 2e6 / ns << std::endl;
+    }
+
+    return 0;
+}
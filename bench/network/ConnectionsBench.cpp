@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Config.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
+#ifdef AFINA_HAVE_IO_URING
+#include "network/uring/ServerImpl.h"
+#endif
+#include "storage/StripedLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Network connections benchmark
+ * Starts every network implementation in a child process and drives it from a single epoll
+ * client holding many concurrent connections. Each connection keeps exactly one request in
+ * flight: set of a small value followed by get of the same key in one packet. Reports number
+ * of round trips per second and round trip latency percentiles.
+ *
+ * Usage: runNetworkConnectionsBench [connections] [duration_ms] [server_threads]
+ */
+
+namespace {
+
+const uint16_t kPort = 18080;
+const size_t kKeys = 1000;
+const size_t kValueSize = 32;
+
+struct Implementation {
+    std::string name;
+    std::function<std::shared_ptr<Afina::Network::Server>(std::shared_ptr<Storage>,
+                                                          std::shared_ptr<Logging::Service>)>
+        create;
+};
+
+struct Client {
+    int socket;
+    std::string request;
+    std::string response;
+    std::chrono::steady_clock::time_point sent;
+};
+
+struct Result {
+    double rps;
+    double p50;
+    double p99;
+    size_t failed;
+};
+
+void raise_fd_limit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Runs server in the current process until SIGTERM arrives, never returns
+void serve(const Implementation &network, uint32_t threads, int ready_fd) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    std::shared_ptr<Logging::Config> config(new Logging::Config);
+    Logging::Appender &console = config->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+    console.color = false;
+
+    Logging::Logger &logger = config->loggers["root"];
+    logger.level = Logging::Logger::Level::CRITICAL;
+    logger.appenders.push_back("console");
+    logger.format = "[%n] [%l] %v";
+
+    std::shared_ptr<Logging::Service> logging(new Logging::ServiceImpl(config));
+    logging->Start();
+
+    std::shared_ptr<Storage> storage(new Backend::StripedLRU(64 * 1024 * 1024));
+    std::shared_ptr<Afina::Network::Server> server = network.create(storage, logging);
+    server->Start(kPort, 1, threads);
+
+    char ok = 1;
+    if (write(ready_fd, &ok, 1) != 1) {
+        _exit(1);
+    }
+
+    int signal;
+    sigwait(&mask, &signal);
+
+    server->Stop();
+    server->Join();
+    logging->Stop();
+    _exit(0);
+}
+
+int connect_to_server() {
+    int s = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (s == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        throw std::runtime_error("Failed to connect: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+    return s;
+}
+
+bool send_request(Client &c) {
+    c.response.clear();
+    c.sent = std::chrono::steady_clock::now();
+    return send(c.socket, c.request.data(), c.request.size(), MSG_NOSIGNAL) == ssize_t(c.request.size());
+}
+
+Result drive(size_t connections, std::chrono::milliseconds duration) {
+    std::vector<Client> clients(connections);
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    const std::string value(kValueSize, 'v');
+    for (size_t i = 0; i < connections; i++) {
+        Client &c = clients[i];
+        c.socket = connect_to_server();
+
+        std::string key = "key" + std::to_string(i % kKeys);
+        c.request = "set " + key + " 0 0 " + std::to_string(kValueSize) + "\r\n" + value + "\r\nget " + key + "\r\n";
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = &c;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, c.socket, &event);
+    }
+
+    size_t failed = 0;
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+
+    for (auto &c : clients) {
+        if (!send_request(c)) {
+            failed++;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + duration;
+    std::vector<struct epoll_event> events(1024);
+    char buffer[4096];
+    while (std::chrono::steady_clock::now() < deadline) {
+        int n = epoll_wait(epoll, events.data(), events.size(), 100);
+        for (int i = 0; i < n; i++) {
+            Client &c = *static_cast<Client *>(events[i].data.ptr);
+            ssize_t got = recv(c.socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (got <= 0) {
+                if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    epoll_ctl(epoll, EPOLL_CTL_DEL, c.socket, nullptr);
+                    failed++;
+                }
+                continue;
+            }
+
+            c.response.append(buffer, got);
+            const std::string end = "END\r\n";
+            if (c.response.size() < end.size() ||
+                c.response.compare(c.response.size() - end.size(), end.size(), end) != 0) {
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration<double, std::micro>(now - c.sent).count());
+            if (!send_request(c)) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, c.socket, nullptr);
+                failed++;
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (auto &c : clients) {
+        close(c.socket);
+    }
+    close(epoll);
+
+    Result result;
+    result.failed = failed;
+    result.rps = latencies.size() / std::chrono::duration<double>(elapsed).count();
+    result.p50 = result.p99 = 0;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.p50 = latencies[latencies.size() / 2];
+        result.p99 = latencies[latencies.size() * 99 / 100];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t connections = 10000;
+    if (argc > 1) {
+        connections = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::chrono::milliseconds duration(3000);
+    if (argc > 2) {
+        duration = std::chrono::milliseconds(std::strtoul(argv[2], nullptr, 10));
+    }
+
+    uint32_t threads = 2;
+    if (argc > 3) {
+        threads = std::strtoul(argv[3], nullptr, 10);
+    }
+
+    raise_fd_limit();
+
+    std::vector<Implementation> networks = {
+        {"st_coroutine",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::STcoroutine::ServerImpl>(ps, pl);
+         }},
+        {"mt_nonblock",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::MTnonblock::ServerImpl>(ps, pl);
+         }},
+        {"mt_reuseport",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                 ps, pl, Afina::Network::MTnonblock::ServerImpl::Mode::kReusePort);
+         }},
+#ifdef AFINA_HAVE_IO_URING
+        {"uring",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::Uring::ServerImpl>(ps, pl);
+         }},
+#endif
+    };
+
+    std::cout << std::setw(14) << "network" << std::setw(14) << "connections" << std::setw(14) << "rtt/sec"
+              << std::setw(14) << "p50 (us)" << std::setw(14) << "p99 (us)" << std::setw(10) << "failed" << std::endl;
+
+    for (auto &network : networks) {
+        int ready[2];
+        if (pipe(ready) == -1) {
+            std::cerr << "Failed to create pipe: " << strerror(errno) << std::endl;
+            return 1;
+        }
+
+        // Server runs in its own process, so that client and server sockets do not share descriptor limit
+        pid_t child = fork();
+        if (child == 0) {
+            close(ready[0]);
+            serve(network, threads, ready[1]);
+        }
+        close(ready[1]);
+
+        char ok = 0;
+        if (read(ready[0], &ok, 1) != 1) {
+            std::cerr << network.name << ": server failed to start" << std::endl;
+            waitpid(child, nullptr, 0);
+            return 1;
+        }
+        close(ready[0]);
+
+        try {
+            Result r = drive(connections, duration);
+            std::cout << std::setw(14) << network.name << std::setw(14) << connections << std::setw(14) << std::fixed
+                      << std::setprecision(0) << r.rps << std::setw(14) << r.p50 << std::setw(14) << r.p99
+                      << std::setw(10) << r.failed << std::endl;
+        } catch (std::runtime_error &ex) {
+            std::cerr << network.name << ": " << ex.what() << std::endl;
+        }
+
+        kill(child, SIGTERM);
+        waitpid(child, nullptr, 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Config.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Network pipeline benchmark
+ * Starts network implementations in a child process and drives them by clients which pipeline a batch
+ * of single key gets in one packet and wait for all responses before sending the next batch. Depth of
+ * the pipeline grows from 1 to max_depth, reports number of gets served per second. Storage with a
+ * global lock is used, so that the lock taken once per batch shows up.
+ *
+ * Usage: runNetworkPipelineBench [max_depth] [duration_ms] [connections]
+ */
+
+namespace {
+
+const uint16_t kPort = 18081;
+const size_t kKeys = 1000;
+const size_t kValueSize = 32;
+
+struct Implementation {
+    std::string name;
+    std::function<std::shared_ptr<Afina::Network::Server>(std::shared_ptr<Storage>,
+                                                          std::shared_ptr<Logging::Service>)>
+        create;
+};
+
+struct Client {
+    int socket;
+    size_t ends;
+    std::string tail;
+};
+
+// Runs server in the current process until SIGTERM arrives, never returns
+void serve(const Implementation &network, int ready_fd) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    std::shared_ptr<Logging::Config> config(new Logging::Config);
+    Logging::Appender &console = config->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+    console.color = false;
+
+    Logging::Logger &logger = config->loggers["root"];
+    logger.level = Logging::Logger::Level::CRITICAL;
+    logger.appenders.push_back("console");
+    logger.format = "[%n] [%l] %v";
+
+    std::shared_ptr<Logging::Service> logging(new Logging::ServiceImpl(config));
+    logging->Start();
+
+    std::shared_ptr<Storage> storage(new Backend::ThreadSafeSimplLRU(64 * 1024 * 1024));
+    const std::string value(kValueSize, 'v');
+    for (size_t i = 0; i < kKeys; i++) {
+        storage->Put("key" + std::to_string(i), value);
+    }
+
+    std::shared_ptr<Afina::Network::Server> server = network.create(storage, logging);
+    server->Start(kPort, 1, 2);
+
+    char ok = 1;
+    if (write(ready_fd, &ok, 1) != 1) {
+        _exit(1);
+    }
+
+    int signal;
+    sigwait(&mask, &signal);
+
+    server->Stop();
+    server->Join();
+    logging->Stop();
+    _exit(0);
+}
+
+int connect_to_server() {
+    int s = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (s == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(s);
+        throw std::runtime_error("Failed to connect: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+    return s;
+}
+
+// Counts "END\r\n" markers in the received data, marker could be split between two reads
+size_t count_ends(Client &c, const char *data, size_t size) {
+    static const std::string end = "END\r\n";
+    std::string chunk = c.tail + std::string(data, size);
+
+    size_t found = 0;
+    for (size_t pos = chunk.find(end); pos != std::string::npos; pos = chunk.find(end, pos + end.size())) {
+        found++;
+    }
+
+    size_t keep = std::min(chunk.size(), end.size() - 1);
+    c.tail = chunk.substr(chunk.size() - keep);
+    return found;
+}
+
+// Gets served per second
+double drive(size_t connections, size_t depth, std::chrono::milliseconds duration) {
+    std::vector<Client> clients(connections);
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    // Batch of gets in one packet, keys differ so that batch isn't a single hot key
+    std::vector<std::string> batches(connections);
+    for (size_t i = 0; i < connections; i++) {
+        Client &c = clients[i];
+        c.socket = connect_to_server();
+        c.ends = 0;
+        for (size_t j = 0; j < depth; j++) {
+            batches[i] += "get key" + std::to_string((i * depth + j) % kKeys) + "\r\n";
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, c.socket, &event);
+    }
+
+    for (size_t i = 0; i < connections; i++) {
+        if (send(clients[i].socket, batches[i].data(), batches[i].size(), MSG_NOSIGNAL) != ssize_t(batches[i].size())) {
+            throw std::runtime_error("Failed to send request");
+        }
+    }
+
+    size_t served = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + duration;
+    std::vector<struct epoll_event> events(connections);
+    std::vector<char> buffer(1 << 16);
+    while (std::chrono::steady_clock::now() < deadline) {
+        int n = epoll_wait(epoll, events.data(), events.size(), 100);
+        for (int i = 0; i < n; i++) {
+            size_t index = events[i].data.u64;
+            Client &c = clients[index];
+            ssize_t got = recv(c.socket, buffer.data(), buffer.size(), MSG_DONTWAIT);
+            if (got <= 0) {
+                if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    throw std::runtime_error("Connection lost");
+                }
+                continue;
+            }
+
+            c.ends += count_ends(c, buffer.data(), got);
+            if (c.ends < depth) {
+                continue;
+            }
+
+            served += depth;
+            c.ends = 0;
+            if (send(c.socket, batches[index].data(), batches[index].size(), MSG_NOSIGNAL) !=
+                ssize_t(batches[index].size())) {
+                throw std::runtime_error("Failed to send request");
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (auto &c : clients) {
+        close(c.socket);
+    }
+    close(epoll);
+    return served / std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t max_depth = 256;
+    if (argc > 1) {
+        max_depth = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::chrono::milliseconds duration(1000);
+    if (argc > 2) {
+        duration = std::chrono::milliseconds(std::strtoul(argv[2], nullptr, 10));
+    }
+
+    size_t connections = 16;
+    if (argc > 3) {
+        connections = std::strtoul(argv[3], nullptr, 10);
+    }
+
+    std::vector<Implementation> networks = {
+        {"st_coroutine",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::STcoroutine::ServerImpl>(ps, pl);
+         }},
+        {"mt_nonblock",
+         [](std::shared_ptr<Storage> ps, std::shared_ptr<Logging::Service> pl) {
+             return std::make_shared<Afina::Network::MTnonblock::ServerImpl>(ps, pl);
+         }},
+    };
+
+    std::cout << std::setw(8) << "depth";
+    for (auto &network : networks) {
+        std::cout << std::setw(16) << network.name;
+    }
+    std::cout << "   (gets/sec)" << std::endl;
+
+    for (size_t depth = 1; depth <= max_depth; depth *= 4) {
+        std::cout << std::setw(8) << depth;
+        for (auto &network : networks) {
+            int ready[2];
+            if (pipe(ready) == -1) {
+                std::cerr << "Failed to create pipe: " << strerror(errno) << std::endl;
+                return 1;
+            }
+
+            pid_t child = fork();
+            if (child == 0) {
+                close(ready[0]);
+                serve(network, ready[1]);
+            }
+            close(ready[1]);
+
+            char ok = 0;
+            if (read(ready[0], &ok, 1) != 1) {
+                std::cerr << network.name << ": server failed to start" << std::endl;
+                waitpid(child, nullptr, 0);
+                return 1;
+            }
+            close(ready[0]);
+
+            try {
+                std::cout << std::setw(16) << std::fixed << std::setprecision(0) << drive(connections, depth, duration)
+                          << std::flush;
+            } catch (std::runtime_error &ex) {
+                std::cout << std::setw(16) << "failed" << std::flush;
+                std::cerr << network.name << ": " << ex.what() << std::endl;
+            }
+
+            kill(child, SIGTERM);
+            waitpid(child, nullptr, 0);
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
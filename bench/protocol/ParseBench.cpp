@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Command.h>
+
+#include "protocol/Parser.h"
+
+using namespace Afina;
+using namespace Afina::Protocol;
+
+/**
+ * # Protocol parser throughput benchmark
+ * Prepares a buffer with pipelined commands of the given kind and parses it through, the way
+ * connection does: parse command line, build command, skip its body. Results are reported for
+ * parsing alone and together with building of commands.
+ *
+ * Usage: runProtocolParseBench [commands]
+ */
+
+namespace {
+
+struct Workload {
+    std::string name;
+    std::string command;
+
+    // Bytes of data block following the command line, including \r\n
+    size_t body;
+};
+
+std::string make_key(size_t i) { return "user:session:" + std::to_string(100000 + i); }
+
+// Nanoseconds per command and parsed megabytes per second
+void measure(Parser::Mode mode, const std::string &input, size_t commands, size_t body, bool build, double &ns,
+             double &mbs) {
+    Parser parser(mode);
+    size_t built = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    const char *data = input.data();
+    size_t size = input.size();
+    while (size > 0) {
+        size_t parsed = 0, body_size = 0;
+        if (!parser.Parse(data, size, parsed)) {
+            std::cerr << "incomplete command in the input" << std::endl;
+            std::exit(1);
+        }
+
+        if (build) {
+            std::unique_ptr<Execute::Command> cmd = parser.Build(body_size);
+            built += cmd ? 1 : 0;
+        }
+        parser.Reset();
+
+        data += parsed + body;
+        size -= parsed + body;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Make sure compiler doesn't throw commands away
+    if (built > commands) {
+        std::cerr << "unreachable" << std::endl;
+    }
+    ns = std::chrono::duration<double, std::nano>(elapsed).count() / commands;
+    mbs = input.size() / std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t commands = 1000000;
+    if (argc > 1) {
+        commands = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::string multiget = "get";
+    for (size_t i = 0; i < 10; i++) {
+        multiget += " " + make_key(i);
+    }
+
+    std::vector<Workload> workloads = {
+        {"get", "get " + make_key(0) + "\r\n", 0},
+        {"multiget", multiget + "\r\n", 0},
+        {"set", "set " + make_key(0) + " 0 3600 32\r\n" + std::string(32, 'x') + "\r\n", 34},
+    };
+
+    std::cout << std::setw(10) << "command" << std::setw(16) << "scalar parse" << std::setw(16) << "vector parse"
+              << std::setw(16) << "scalar +build" << std::setw(16) << "vector +build" << "   (ns/cmd, MB/s)"
+              << std::endl;
+
+    for (auto &w : workloads) {
+        std::string input;
+        input.reserve(w.command.size() * commands);
+        for (size_t i = 0; i < commands; i++) {
+            input += w.command;
+        }
+
+        std::cout << std::setw(10) << w.name;
+        for (bool build : {false, true}) {
+            for (Parser::Mode mode : {Parser::Mode::kScalar, Parser::Mode::kVector}) {
+                double ns, mbs;
+                measure(mode, input, commands, w.body, build, ns, mbs);
+                std::cout << std::setw(9) << std::fixed << std::setprecision(1) << ns << std::setw(7)
+                          << std::setprecision(0) << mbs << std::flush;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
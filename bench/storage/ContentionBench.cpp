@@ -0,0 +1,143 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/ClockLRU.h"
+#include "storage/EpochLRU.h"
+#include "storage/FlatCombineLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+
+/**
+ * # Storage contention benchmark
+ * Runs mixed get/put workload over uniformly distributed keys from a growing number of
+ * threads and reports total throughput of each storage implementation.
+ *
+ * Usage: runStorageContentionBench [max_threads] [duration_ms] [write_percent]
+ */
+
+namespace {
+
+const size_t kKeys = 100000;
+const size_t kValueSize = 64;
+const size_t kStorageSize = 64 * 1024 * 1024;
+
+// By default every 10th operation is an update, the rest are reads
+const unsigned kWritePercent = 10;
+
+struct Engine {
+    std::string name;
+    std::function<std::unique_ptr<Storage>()> create;
+};
+
+std::string make_key(size_t i) { return "key:" + std::to_string(i); }
+
+double run(Storage &storage, size_t threads, std::chrono::milliseconds duration, unsigned write_percent) {
+    std::atomic<bool> running(true);
+    std::vector<uint64_t> ops(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&storage, &running, &ops, t, write_percent]() {
+            const std::string new_value(kValueSize, 'y');
+            std::string value;
+            uint64_t seed = 0x9E3779B97F4A7C15ULL * (t + 1);
+            uint64_t done = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                // xorshift, std::rand would serialize threads on its own lock
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+
+                std::string key = make_key(seed % kKeys);
+                if ((seed >> 32) % 100 < write_percent) {
+                    storage.Put(key, new_value);
+                } else {
+                    storage.Get(key, value);
+                }
+                done++;
+            }
+            ops[t] = done;
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    running = false;
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    uint64_t total = 0;
+    for (auto n : ops) {
+        total += n;
+    }
+    return total * 1000.0 / duration.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t max_threads = 2 * std::thread::hardware_concurrency();
+    if (argc > 1) {
+        max_threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    std::chrono::milliseconds duration(1000);
+    if (argc > 2) {
+        duration = std::chrono::milliseconds(std::strtoul(argv[2], nullptr, 10));
+    }
+
+    unsigned write_percent = kWritePercent;
+    if (argc > 3) {
+        write_percent = std::strtoul(argv[3], nullptr, 10);
+    }
+
+    std::vector<Engine> engines = {
+        {"mt_lru", []() { return std::unique_ptr<Storage>(new ThreadSafeSimplLRU(kStorageSize)); }},
+        {"striped_lru", []() { return std::unique_ptr<Storage>(new StripedLRU(kStorageSize)); }},
+        {"fc_lru", []() { return std::unique_ptr<Storage>(new FlatCombineLRU(kStorageSize)); }},
+        {"clock_lru", []() { return std::unique_ptr<Storage>(new ClockLRU(kStorageSize)); }},
+        {"epoch_lru", []() { return std::unique_ptr<Storage>(new EpochLRU(kStorageSize)); }},
+    };
+
+    std::cout << std::setw(8) << "threads";
+    for (auto &e : engines) {
+        std::cout << std::setw(16) << e.name;
+    }
+    std::cout << "   (ops/sec)" << std::endl;
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::cout << std::setw(8) << threads;
+        for (auto &e : engines) {
+            std::unique_ptr<Storage> storage = e.create();
+
+            const std::string value(kValueSize, 'x');
+            for (size_t i = 0; i < kKeys; i++) {
+                storage->Put(make_key(i), value);
+            }
+
+            std::cout << std::setw(16) << std::fixed << std::setprecision(0)
+                      << run(*storage, threads, duration, write_percent) << std::flush;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
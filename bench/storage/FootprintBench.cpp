@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <malloc.h>
+
+#include <afina/Storage.h>
+
+#include "storage/HashLRU.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+
+/**
+ * # Storage memory footprint benchmark
+ * Fills storage which is large enough to never evict with items of realistic sizes and measures heap
+ * memory it takes, as reported by the allocator. Reports overhead per item on top of key and value
+ * bytes and how many items fit into a gigabyte.
+ *
+ * Sizes:
+ * - small: keys of 10-40 bytes, values of 10-100 bytes
+ * - mixed: the same keys, 60% of values are 10-100 bytes, 30% are up to 1K, 10% up to 4K
+ *
+ * Plain unordered_map of strings is given for comparison.
+ *
+ * Usage: runStorageFootprintBench [items]
+ */
+
+namespace {
+
+const size_t kGigabyte = size_t(1) << 30;
+
+// Storage never evicts anything in this benchmark
+const size_t kStorageSize = size_t(1) << 40;
+
+struct Engine {
+    std::string name;
+    std::function<std::unique_ptr<Storage>()> create;
+};
+
+// Map of strings behind the storage interface, keeps nothing but the map itself
+class MapStorage : public Storage {
+public:
+    bool Put(const std::string &key, const std::string &value, uint32_t) override {
+        _map[key] = value;
+        return true;
+    }
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t) override {
+        return _map.emplace(key, value).second;
+    }
+    bool Set(const std::string &, const std::string &, uint32_t) override { return false; }
+    bool Delete(const std::string &key) override { return _map.erase(key) > 0; }
+    bool Get(const std::string &, std::string &) override { return false; }
+
+private:
+    std::unordered_map<std::string, std::string> _map;
+};
+
+uint64_t next_random(uint64_t &seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+// Large blocks such as index tables are mapped separately, they count too
+size_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+#else
+    struct mallinfo info = mallinfo();
+#endif
+    return size_t(info.uordblks) + size_t(info.hblkhd);
+}
+
+struct Item {
+    std::string key;
+    std::string value;
+};
+
+std::vector<Item> make_items(size_t count, bool mixed) {
+    std::vector<Item> items(count);
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    for (size_t i = 0; i < count; i++) {
+        std::string key = "obj:" + std::to_string(i) + ":";
+        key.resize(10 + next_random(seed) % 31, 'k');
+
+        size_t bucket = next_random(seed) % 10;
+        size_t value_size = 10 + next_random(seed) % 91;
+        if (mixed && bucket >= 9) {
+            value_size = 1000 + next_random(seed) % 3097;
+        } else if (mixed && bucket >= 6) {
+            value_size = 100 + next_random(seed) % 925;
+        }
+
+        items[i].key = std::move(key);
+        items[i].value.assign(value_size, 'v');
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t count = 1000000;
+    if (argc > 1) {
+        count = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::vector<Engine> engines = {
+        {"unordered_map", []() { return std::unique_ptr<Storage>(new MapStorage()); }},
+        {"st_lru", []() { return std::unique_ptr<Storage>(new SimpleLRU(kStorageSize)); }},
+        {"hash_lru", []() { return std::unique_ptr<Storage>(new HashLRU(kStorageSize)); }},
+    };
+
+    std::cout << std::setw(8) << "sizes" << std::setw(16) << "storage" << std::setw(14) << "payload B"
+              << std::setw(14) << "overhead B" << std::setw(14) << "items/GB" << "   (per item)" << std::endl;
+
+    for (bool mixed : {false, true}) {
+        std::vector<Item> items = make_items(count, mixed);
+        size_t payload = 0;
+        for (auto &item : items) {
+            payload += item.key.size() + item.value.size();
+        }
+
+        for (auto &e : engines) {
+            size_t before = heap_in_use();
+            {
+                std::unique_ptr<Storage> storage = e.create();
+                for (auto &item : items) {
+                    storage->Put(item.key, item.value);
+                }
+
+                size_t used = heap_in_use() - before;
+                std::cout << std::setw(8) << (mixed ? "mixed" : "small") << std::setw(16) << e.name << std::fixed
+                          << std::setprecision(1) << std::setw(14) << double(payload) / count << std::setw(14)
+                          << double(used - payload) / count << std::setw(14) << std::setprecision(0)
+                          << double(kGigabyte) * count / used << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
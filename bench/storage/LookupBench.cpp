@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/HashLRU.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+
+/**
+ * # Storage lookup latency benchmark
+ * Fills storage with given number of keys and measures average latency of Get for keys that
+ * are present (hit) and keys that never were stored (miss). Keys are queried in random order
+ * so that results include cache misses on index structures.
+ *
+ * Usage: runStorageLookupBench [lookups]
+ */
+
+namespace {
+
+const size_t kValueSize = 32;
+
+struct Engine {
+    std::string name;
+    std::function<std::unique_ptr<Storage>(size_t)> create;
+};
+
+std::string make_key(size_t i) { return "user:session:" + std::to_string(i); }
+
+uint64_t next_random(uint64_t &seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+// Average nanoseconds per Get over prepared keys
+double measure(Storage &storage, const std::vector<std::string> &keys) {
+    std::string value;
+    size_t found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto &key : keys) {
+        found += storage.Get(key, value) ? 1 : 0;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Make sure compiler doesn't throw lookups away
+    if (found > keys.size()) {
+        std::cerr << "unreachable" << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / keys.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t lookups = 1000000;
+    if (argc > 1) {
+        lookups = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::vector<Engine> engines = {
+        {"st_lru", [](size_t size) { return std::unique_ptr<Storage>(new SimpleLRU(size)); }},
+        {"hash_lru", [](size_t size) { return std::unique_ptr<Storage>(new HashLRU(size)); }},
+    };
+
+    std::cout << std::setw(10) << "keys";
+    for (auto &e : engines) {
+        std::cout << std::setw(14) << e.name + " hit" << std::setw(14) << e.name + " miss";
+    }
+    std::cout << "   (ns/op)" << std::endl;
+
+    for (size_t items = 1000; items <= 1000000; items *= 10) {
+        uint64_t seed = 0x2545F4914F6CDD1DULL;
+        std::vector<std::string> hits, misses;
+        hits.reserve(lookups);
+        misses.reserve(lookups);
+        for (size_t i = 0; i < lookups; i++) {
+            hits.push_back(make_key(next_random(seed) % items));
+            misses.push_back(make_key(items + next_random(seed) % items));
+        }
+
+        std::cout << std::setw(10) << items;
+        for (auto &e : engines) {
+            const std::string value(kValueSize, 'x');
+            std::unique_ptr<Storage> storage = e.create(items * (make_key(items).size() + kValueSize));
+            for (size_t i = 0; i < items; i++) {
+                storage->Put(make_key(i), value);
+            }
+
+            std::cout << std::setw(14) << std::fixed << std::setprecision(1) << measure(*storage, hits)
+                      << std::setw(14) << measure(*storage, misses) << std::flush;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
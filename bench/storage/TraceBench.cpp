@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/ARC.h"
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+
+/**
+ * # Storage hit ratio benchmark
+ * Replays synthetic traces against storages of different sizes the way cache is usually used: Get and
+ * Put of the same key on miss. Reports share of Get calls that hit.
+ *
+ * Traces:
+ * - zipf: keys are drawn from Zipf distribution with skew 0.99, a few keys get most of the requests
+ * - zipf+scan: the same, but every so often comes a scan of keys which are never asked again, as
+ *   large as the largest storage tested
+ * - zipf+shift: popularity is the same, but keys it applies to change a few times, so that recently
+ *   popular keys stop being asked at once
+ *
+ * Storage size is given in percents of the number of distinct keys in Zipf part of the trace.
+ *
+ * Usage: runStorageTraceBench [keys] [requests]
+ */
+
+namespace {
+
+const size_t kValueSize = 32;
+const double kSkew = 0.99;
+
+struct Engine {
+    std::string name;
+    std::function<std::unique_ptr<Storage>(size_t)> create;
+    std::function<size_t(size_t, size_t)> entry_size;
+};
+
+uint64_t next_random(uint64_t &seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+// Keys have the same width so that every entry takes the same amount of memory
+std::string make_key(size_t i) {
+    char key[32];
+    std::snprintf(key, sizeof(key), "key:%010zu", i);
+    return key;
+}
+
+// Draws keys from [0, keys) with Zipf distribution, inverting precomputed CDF
+class Zipf {
+public:
+    Zipf(size_t keys, double skew) : _cdf(keys) {
+        double sum = 0;
+        for (size_t i = 0; i < keys; i++) {
+            sum += 1.0 / std::pow(double(i + 1), skew);
+            _cdf[i] = sum;
+        }
+        for (double &p : _cdf) {
+            p /= sum;
+        }
+    }
+
+    size_t Next(uint64_t &seed) const {
+        double u = double(next_random(seed) >> 11) / double(uint64_t(1) << 53);
+        size_t rank = std::lower_bound(_cdf.begin(), _cdf.end(), u) - _cdf.begin();
+        return std::min(rank, _cdf.size() - 1);
+    }
+
+private:
+    std::vector<double> _cdf;
+};
+
+// Trace of key numbers, scan keys are numbered after all Zipf ones so they never repeat. Trace is split
+// into phases, ranks of each next one are mapped to keys with a different offset
+std::vector<size_t> make_trace(const Zipf &zipf, size_t keys, size_t requests, size_t scan_length, size_t phases) {
+    std::vector<size_t> trace;
+    trace.reserve(requests);
+
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    size_t scanned = keys;
+    size_t phase_length = requests / std::max<size_t>(phases, 1) + 1;
+    while (trace.size() < requests) {
+        // Scan goes after every ten scan lengths of regular requests
+        for (size_t i = 0; i < 10 * std::max<size_t>(scan_length, 1) && trace.size() < requests; i++) {
+            size_t offset = (trace.size() / phase_length) * (keys / 3 + 1);
+            trace.push_back((zipf.Next(seed) + offset) % keys);
+        }
+        for (size_t i = 0; i < scan_length && trace.size() < requests; i++) {
+            trace.push_back(scanned++);
+        }
+    }
+    return trace;
+}
+
+double replay(Storage &storage, const std::vector<size_t> &trace) {
+    const std::string fill(kValueSize, 'x');
+    std::string value;
+    size_t hits = 0;
+    for (size_t number : trace) {
+        std::string key = make_key(number);
+        if (storage.Get(key, value)) {
+            hits++;
+        } else {
+            storage.Put(key, fill);
+        }
+    }
+    return 100.0 * hits / trace.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t keys = 100000;
+    if (argc > 1) {
+        keys = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    size_t requests = 2000000;
+    if (argc > 2) {
+        requests = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    std::vector<Engine> engines = {
+        {"st_lru", [](size_t size) { return std::unique_ptr<Storage>(new SimpleLRU(size)); },
+         SimpleLRU::EntrySize},
+        {"arc", [](size_t size) { return std::unique_ptr<Storage>(new ARC(size)); }, ARC::EntrySize},
+        {"tinylfu", [](size_t size) { return std::unique_ptr<Storage>(new TinyLFU(size)); }, TinyLFU::EntrySize},
+    };
+
+    const std::vector<size_t> percents = {1, 5, 10, 25};
+    const size_t key_size = make_key(0).size();
+    const Zipf zipf(keys, kSkew);
+
+    struct Trace {
+        std::string name;
+        std::vector<size_t> requests;
+    };
+    std::vector<Trace> traces = {
+        {"zipf", make_trace(zipf, keys, requests, 0, 1)},
+        {"zipf+scan", make_trace(zipf, keys, requests, keys * percents.back() / 100, 1)},
+        {"zipf+shift", make_trace(zipf, keys, requests, 0, 8)},
+    };
+
+    std::cout << std::setw(12) << "trace" << std::setw(10) << "size %";
+    for (auto &e : engines) {
+        std::cout << std::setw(12) << e.name;
+    }
+    std::cout << "   (hit %)" << std::endl;
+
+    for (auto &t : traces) {
+        for (size_t percent : percents) {
+            std::cout << std::setw(12) << t.name << std::setw(10) << percent;
+            for (auto &e : engines) {
+                size_t items = std::max<size_t>(keys * percent / 100, 1);
+                std::unique_ptr<Storage> storage = e.create(items * e.entry_size(key_size, kValueSize));
+                std::cout << std::setw(12) << std::fixed << std::setprecision(2) << replay(*storage, t.requests)
+                          << std::flush;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#ifndef AFINA_STATISTICS_H
+#define AFINA_STATISTICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <afina/concurrency/CoreLocal.h>
+
+namespace Afina {
+
+/**
+ * # Server wide statistics
+ * Counters reported by stats command. Every counter is kept per CPU, so that increments on the hot
+ * path don't contend with each other, sum is computed only once statistics is requested. Gauges
+ * such as number of open connections are counters of signed changes, their sum is the current value.
+ *
+ * Number of items and memory they take are reported by the storage itself, see Storage::Usage.
+ */
+class Statistics {
+public:
+    enum Counter {
+        // Number of get requests, each key counts separately
+        kCmdGet,
+
+        // Number of storage requests: set, add, replace, append
+        kCmdSet,
+
+        // Number of keys found and not found by get requests
+        kGetHits,
+        kGetMisses,
+
+        // Number of valid items removed from cache to free memory for new ones
+        kEvictions,
+
+        // Number of open connections and all connections ever accepted
+        kCurrConnections,
+        kTotalConnections,
+
+        kCounters
+    };
+
+    /**
+     * Adds delta to the counter of the current CPU
+     */
+    static inline void Add(Counter counter, int64_t delta = 1) {
+        Instance()._counters.Local().values[counter].fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    /**
+     * Current value of the counter summed over all CPUs. Concurrent increments could be missed
+     */
+    static inline int64_t Get(Counter counter) {
+        return Instance()._counters.Combine(int64_t(0), [counter](int64_t sum, const Counters &local) {
+            return sum + local.values[counter].load(std::memory_order_relaxed);
+        });
+    }
+
+    /**
+     * Number of seconds since statistics was first touched, which happens on the server start
+     */
+    static inline uint64_t Uptime() {
+        auto passed = std::chrono::steady_clock::now() - Instance()._started;
+        return std::chrono::duration_cast<std::chrono::seconds>(passed).count();
+    }
+
+    static inline Statistics &Instance() {
+        static Statistics instance;
+        return instance;
+    }
+
+private:
+    Statistics() : _started(std::chrono::steady_clock::now()) {}
+
+    struct Counters {
+        Counters() {
+            for (auto &value : values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<int64_t> values[kCounters];
+    };
+
+    std::chrono::steady_clock::time_point _started;
+    Concurrency::CoreLocal<Counters> _counters;
+};
+
+} // namespace Afina
+
+#endif // AFINA_STATISTICS_H
@@ -1,18 +1,38 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Afina {
 
+/**
+ * Immutable value which could be shared between storage and responses being sent. Once handed out
+ * buffer never changes, storage replaces it instead
+ */
+using SharedValue = std::shared_ptr<const std::string>;
+
 /**
  *
  */
 class Storage {
 public:
+    /**
+     * Passed as ttl to keep expiration of the existing association as is. New association created
+     * with it never expires
+     */
+    static const uint32_t kKeepTTL = UINT32_MAX;
+
     Storage() {}
     virtual ~Storage() {}
 
+    /**
+     * Starts background activities of the storage, such as reclaiming of expired
+     * entries. Storage could be used without start, but then expired entries are
+     * collected only on access
+     */
     virtual void Start() {}
     virtual void Stop() {}
 
@@ -27,8 +47,10 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param ttl number of seconds association stays valid, 0 means it never expires, kKeepTTL keeps
+     * expiration of the existing association
      */
-    virtual bool Put(const std::string &key, const std::string &value) = 0;
+    virtual bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) = 0;
 
     /**
      * Stores association between given key/value pair if key isn't present in
@@ -38,10 +60,13 @@ public:
      * and doesn't change anything inside. Otherwise new association key->value
      * created and if successfull then true returns.
      *
+     * Expired association is considered to be absent.
+     *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param ttl number of seconds association stays valid, 0 means it never expires
      */
-    virtual bool PutIfAbsent(const std::string &key, const std::string &value) = 0;
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) = 0;
 
     /**
      * Updates existing association between given key/value pair
@@ -53,8 +78,10 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param ttl number of seconds association stays valid, 0 means it never expires, kKeepTTL keeps
+     * the current expiration
      */
-    virtual bool Set(const std::string &key, const std::string &value) = 0;
+    virtual bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) = 0;
 
     /**
      * Removes association for the given key
@@ -77,13 +104,64 @@ public:
      * If there is an association for the given key then method copies value
      * into given output parameter (possibly extends its size) and return true
      *
-     * In case if given key not found method returns false and doesn't perform
-     * any changes on the output parameter
+     * In case if given key not found or its association has expired method
+     * returns false and doesn't perform any changes on the output parameter
      *
      * @param key to retrive1 value for
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Get, but instead of copying value into the output parameter gives out reference
+     * to the immutable buffer. Buffer stays valid as long as reference is held, even if association
+     * gets changed or removed meanwhile.
+     *
+     * Storage which keeps values in shared buffers returns them without copy, by default value
+     * gets copied once into the new buffer
+     *
+     * @param key to retrive value for
+     * @param value output parameter to put reference to
+     */
+    virtual bool GetShared(const std::string &key, SharedValue &value) {
+        std::string copy;
+        if (!Get(key, copy)) {
+            return false;
+        }
+        value = std::make_shared<const std::string>(std::move(copy));
+        return true;
+    }
+
+    /**
+     * Same as GetShared for a number of keys at once: values[i] refers to the value of *keys[i] or is
+     * reset if there is no such key. Storage which synchronizes each call takes its locks once for all
+     * the keys, by default GetShared is called for each key
+     *
+     * @param keys to retrive values for
+     * @param values output parameter, resized to the number of keys
+     * @return number of keys found
+     */
+    virtual size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) {
+        values.resize(keys.size());
+        size_t found = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (GetShared(*keys[i], values[i])) {
+                found++;
+            } else {
+                values[i].reset();
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Reports current number of entries and number of bytes they take from the memory limit.
+     * Used by statistics only, storage which doesn't track it reports zeros
+     *
+     * @param items output parameter for number of entries
+     * @param bytes output parameter for memory taken by entries
+     */
+    virtual void Usage(size_t &items, size_t &bytes) { items = bytes = 0; }
 };
 
 } // namespace Afina
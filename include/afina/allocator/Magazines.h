@@ -0,0 +1,124 @@
+#ifndef AFINA_ALLOCATOR_MAGAZINES_H
+#define AFINA_ALLOCATOR_MAGAZINES_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Thread caching on top of the slab allocator
+ * Wraps Simple allocator shared by many threads. Each thread has magazines: small stacks of free
+ * blocks, one per size class. Blocks are taken from and returned to the own magazine without any
+ * lock; once magazine gets empty or full half of it is refilled from or flushed to the shared
+ * allocator in a single locked batch.
+ *
+ * Blocks larger than the largest class go to the shared allocator right away.
+ *
+ * Blocks cached by a thread are not available to others, so allocation could fail while other
+ * magazines hold free blocks. Magazines of the exited threads are kept until flush(). Both flush() and
+ * defrag() must not run concurrently with any other call
+ */
+class Magazines {
+public:
+    // Largest size served from magazines
+    static const size_t kMaxCached = 8192;
+
+    Magazines(void *base, const size_t size);
+    ~Magazines();
+
+    /**
+     * See Simple::alloc
+     */
+    Pointer alloc(size_t N);
+
+    /**
+     * See Simple::realloc. Block stays in place while the new size fits its class
+     */
+    void realloc(Pointer &p, size_t N);
+
+    /**
+     * See Simple::free, except pointer is not checked before it gets flushed to the shared allocator
+     */
+    void free(Pointer &p);
+
+    /**
+     * See Simple::handle
+     */
+    inline Pointer handle(void *address) const { return _shared.handle(address); }
+
+    /**
+     * Returns all the cached blocks to the shared allocator
+     */
+    void flush();
+
+    /**
+     * Flushes magazines and defragments shared allocator
+     */
+    void defrag();
+
+    /**
+     * Usage of each size class, magazines hit rate and fragmentation of the shared allocator
+     */
+    std::string dump() const;
+
+private:
+    // Size classes: 16 bytes steps up to 128, then 4 classes per each power of two up to kMaxCached
+    static const size_t kClasses = 8 + 4 * 6;
+
+    static size_t ClassOf(size_t size);
+    static size_t ClassSize(size_t cls);
+
+    // Free blocks of a single class cached by thread
+    struct Magazine {
+        std::vector<Pointer> blocks;
+        size_t capacity = 0;
+
+        // Updated by owner only, read by dump()
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> refills{0};
+        std::atomic<uint64_t> flushes{0};
+        std::atomic<size_t> cached{0};
+    };
+
+    struct Cache {
+        Magazine magazines[kClasses];
+    };
+
+    // Cache of the calling thread, created on the first call
+    Cache &Local();
+
+    // Moves blocks between magazine and shared allocator, under lock
+    void Refill(Magazine &magazine, size_t cls);
+    void Flush(Magazine &magazine, size_t count);
+
+    // Distinguishes instances for thread local lookup, addresses could be reused
+    const uint64_t _id;
+
+    // Shared allocator and everything related to caches registration
+    mutable std::mutex _lock;
+    Simple _shared;
+    std::unordered_map<std::thread::id, std::unique_ptr<Cache>> _caches;
+
+    // Blocks going to shared allocator directly
+    std::atomic<uint64_t> _large_allocs{0};
+    std::atomic<uint64_t> _large_frees{0};
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MAGAZINES_H
@@ -7,6 +7,13 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle of the memory block allocated by Simple. Block could be moved by the allocator, so handle
+ * refers to the slot of allocator indirection table, which always holds current block address.
+ *
+ * Copies of the pointer refer to the same block. Address returned by get() is valid until the next
+ * defrag() or realloc() of the block
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +24,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _slot != nullptr ? *_slot : nullptr; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **slot);
+
+    // Slot of the indirection table, nullptr if pointer doesn't refer to any block
+    void **_slot;
 };
 
 } // namespace Allocator
@@ -1,8 +1,9 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
-#include <string>
 #include <cstddef>
+#include <cstdint>
+#include <string>
 
 namespace Afina {
 namespace Allocator {
@@ -18,44 +19,151 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * All the bookkeeping lives inside of the area as well:
+ * - blocks grow from the area start, each one has a small header. Free blocks are kept in lists
+ *   right inside of their headers
+ * - indirection table grows down from the area end. Pointer refers to the table slot, so blocks
+ *   could be moved by defrag() without invalidating pointers
+ *
+ * Small blocks have exact size classes: when class has no free block a slab of several blocks is
+ * carved at once, so that objects of the same size stay together and freed blocks are reused as is.
+ * Free large blocks are kept in bins, four per each power of two. Large block is taken by the best fit
+ * from its own bin, or from the first non empty larger bin. Neither merges free neighbours on free(),
+ * defrag() does it for the whole area at once
+ *
+ * See StdAllocator.h to use it with standard containers
  */
-// TODO: Implements interface to allow usage as C++ allocators
 class Simple {
 public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes aligned by 16 bytes. Throws AllocError with NoMemory type
+     * if there is no contiguous space large enough, defrag() might help in this case
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block keeping its content up to the smaller of the sizes. Block is resized in
+     * place if possible, otherwise it is moved, pointer stays valid anyway. Empty pointer gets a new
+     * block
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block and resets the pointer. Other copies of the pointer become dangling. Throws
+     * AllocError with InvalidFree type if pointer doesn't refer to the block of this allocator
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all the blocks to the start of the area, so that all free space becomes contiguous
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Human readable list of blocks and free space
      */
     std::string dump() const;
 
+    /**
+     * Usable size of the block, could be a bit larger than requested. Pointer must refer to the block of
+     * this allocator, it is not checked here
+     */
+    size_t size(const Pointer &p) const;
+
+    /**
+     * Pointer to the block by its current address, so that blocks could be used by code which keeps
+     * plain addresses. Throws AllocError with InvalidFree type if address is not the block start. Reads
+     * the block only, so it is safe to call concurrently for blocks owned by the caller
+     */
+    Pointer handle(void *address) const;
+
+    struct Usage {
+        // Payload of the allocated blocks
+        size_t used;
+        size_t used_blocks;
+
+        // Payload of the free blocks
+        size_t free;
+        size_t free_blocks;
+
+        // Space never allocated so far or returned back by defrag()
+        size_t unused;
+
+        // Largest block could be allocated without defrag()
+        size_t largest;
+    };
+
+    /**
+     * Walks all the blocks to compute memory usage
+     */
+    Usage usage() const;
+
 private:
+    // Number of exact size classes, small blocks are up to kClasses * 16 bytes
+    static const size_t kClasses = 32;
+
+    // Number of bins of the large blocks, from kClasses * 16 up to 4GB
+    static const size_t kBins = (32 - 9) * 4;
+
+    // Offset of the block from the area start, blocks are addressed this way to keep headers small
+    typedef uint32_t Offset;
+
+    // Header of each block, see Simple.cpp
+    struct Block;
+    inline Block *At(Offset offset) const { return reinterpret_cast<Block *>(_begin + offset); }
+
+    // Allocates block without handle, returns its offset. Throws if there is no space
+    Offset Place(size_t size);
+
+    // Takes block of exactly size bytes from the beginning of the free space
+    bool Bump(size_t size, Offset &offset);
+
+    // Cuts block down to size bytes, the rest becomes free
+    void Split(Offset offset, size_t size);
+
+    // Puts free block to its list, or back to the free space if it is the last one
+    void Release(Offset offset);
+
+    // Puts free block to the list of its size, removes it from there
+    void Link(Offset offset);
+    void Unlink(Offset offset);
+
+    // List of free blocks of the given size
+    Offset &List(size_t size);
+
+    // Bin of the large free blocks of the given size
+    static size_t Bin(size_t size);
+
+    // Gets unused slot of the indirection table
+    void **Handle();
+
+    // Finds block the slot refers to, throws if pointer is invalid
+    Offset Resolve(void **slot) const;
+
     void *_base;
     const size_t _base_len;
+
+    // Area actually used: aligned start of the blocks and end of indirection table
+    char *_begin;
+    char *_end;
+
+    // End of the last block, free space is up to the indirection table
+    Offset _top;
+
+    // Lowest slot of the indirection table and the first unused one
+    void **_handles;
+    void **_free_handle;
+
+    // Lists of free blocks: exact classes of small ones and bins of the large ones
+    Offset _small[kClasses];
+    Offset _large[kBins];
 };
 
 } // namespace Allocator
@@ -0,0 +1,85 @@
+#ifndef AFINA_ALLOCATOR_STD_ALLOCATOR_H
+#define AFINA_ALLOCATOR_STD_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Standard allocator over the arena
+ * Lets standard containers and strings take memory from Simple or Magazines arena, so that memory they
+ * use is bounded by the arena and could be measured precisely:
+ *
+ *   Simple arena(buffer, size);
+ *   std::vector<int, StdAllocator<int>> v{StdAllocator<int>(arena)};
+ *
+ * Containers keep plain addresses, so arena must not be defragmented while any of them is alive, and
+ * arena must outlive them. Out of memory is reported by std::bad_alloc, as containers expect. Allocator
+ * is as thread safe as the arena is: Simple is not, Magazines is
+ */
+template <typename T, typename Arena = Simple> class StdAllocator {
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U> struct rebind { typedef StdAllocator<U, Arena> other; };
+
+    // Containers moved or swapped take the arena along
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    explicit StdAllocator(Arena &arena) noexcept : _arena(&arena) {}
+    template <typename U> StdAllocator(const StdAllocator<U, Arena> &other) noexcept : _arena(other.arena()) {}
+
+    T *allocate(std::size_t n) {
+        static_assert(alignof(T) <= 16, "Arena blocks are aligned by 16 bytes only");
+        if (n > std::size_t(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+
+        try {
+            Pointer p = _arena->alloc(n * sizeof(T));
+            return static_cast<T *>(p.get());
+        } catch (AllocError &) {
+            throw std::bad_alloc();
+        }
+    }
+
+    void deallocate(T *address, std::size_t) noexcept {
+        try {
+            Pointer p = _arena->handle(address);
+            _arena->free(p);
+        } catch (AllocError &) {
+            // Container gives back what it got, never happens
+        }
+    }
+
+    inline Arena *arena() const noexcept { return _arena; }
+
+    template <typename U> bool operator==(const StdAllocator<U, Arena> &other) const noexcept {
+        return _arena == other.arena();
+    }
+    template <typename U> bool operator!=(const StdAllocator<U, Arena> &other) const noexcept {
+        return _arena != other.arena();
+    }
+
+private:
+    Arena *_arena;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_STD_ALLOCATOR_H
@@ -1,10 +1,122 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define AFINA_CONCURRENCY_HAVE_RSEQ
+#endif
+#endif
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Per core instances of T
+ * Every CPU gets its own instance of T in a separate cache line, thread works with the one of the
+ * CPU it runs on. Thread could be moved to another CPU at any moment, so the same instance is
+ * still could be accessed concurrently, T must be ready for that, but it is rare and there is
+ * no cache line bouncing between cores in common case.
+ *
+ * Total value is obtained by going through all instances.
+ *
+ * CPU number comes from the rseq area the kernel keeps up to date for each thread, if libc has
+ * registered one, reading it is a plain load. Otherwise it is sched_getcpu call.
+ */
+template <typename T> class CoreLocal {
+public:
+    static const size_t kCacheLine = 64;
+
+    CoreLocal() : _size(Cores()) {
+        void *memory = nullptr;
+        if (posix_memalign(&memory, kCacheLine, _size * sizeof(Slot)) != 0) {
+            throw std::bad_alloc();
+        }
+
+        _slots = static_cast<Slot *>(memory);
+        for (size_t i = 0; i < _size; i++) {
+            new (&_slots[i]) Slot();
+        }
+    }
+
+    ~CoreLocal() {
+        for (size_t i = 0; i < _size; i++) {
+            _slots[i].~Slot();
+        }
+        free(_slots);
+    }
+
+    /**
+     * Instance of the CPU current thread is running on
+     */
+    inline T &Local() {
+        int cpu = Cpu();
+        return _slots[cpu < 0 ? 0 : size_t(cpu) % _size].value;
+    }
+
+    /**
+     * CPU current thread is running on, negative if it is unknown
+     */
+    static inline int Cpu() {
+#ifdef AFINA_CONCURRENCY_HAVE_RSEQ
+        if (__rseq_size > 0) {
+            const struct rseq *area =
+                reinterpret_cast<const struct rseq *>(static_cast<char *>(__builtin_thread_pointer()) + __rseq_offset);
+            return int(*static_cast<const volatile uint32_t *>(&area->cpu_id));
+        }
+#endif
+        return sched_getcpu();
+    }
+
+    /**
+     * Calls f for the instance of each CPU
+     */
+    template <typename F> void ForEach(F f) {
+        for (size_t i = 0; i < _size; i++) {
+            f(_slots[i].value);
+        }
+    }
+
+    /**
+     * Folds instances of all CPUs into a single value: result = f(result, instance)
+     */
+    template <typename R, typename F> R Combine(R init, F f) {
+        for (size_t i = 0; i < _size; i++) {
+            init = f(init, _slots[i].value);
+        }
+        return init;
+    }
+
+    inline size_t size() const { return _size; }
+
+private:
+    // No copy/move/assign allowed
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal(CoreLocal &&) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+    CoreLocal &operator=(CoreLocal &&) = delete;
+
+    // Instance padded to the whole number of cache lines, so that neighbours never share one
+    struct alignas(kCacheLine) Slot {
+        T value;
+    };
+
+    static size_t Cores() {
+        long cores = sysconf(_SC_NPROCESSORS_CONF);
+        return cores > 0 ? size_t(cores) : 1;
+    }
+
+    size_t _size;
+    Slot *_slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
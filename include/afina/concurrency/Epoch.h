@@ -0,0 +1,123 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Epoch based reclamation
+ * Lets readers walk shared structure without locks while writers unlink and retire its parts: retired
+ * object is destroyed only once no reader could still hold a pointer to it.
+ *
+ * Reader works inside critical section, see Guard, which records the global epoch observed on entry.
+ * Writer first unlinks object so that no new reader finds it, then retires it: object goes to the list
+ * of the current thread tagged by the global epoch. Epoch advances when every thread inside critical
+ * section has observed the current one, so after two advances nobody could have seen the object and
+ * it gets destroyed.
+ *
+ * Critical sections must be short, one stuck reader holds back reclamation of everything retired since
+ * it entered. Sections could be nested. Retired objects of exited thread are kept and collected by the
+ * next thread taking its place, everything left is destroyed along with the manager.
+ */
+class EpochManager {
+    // State of a thread working with the manager, defined below
+    struct Participant;
+
+public:
+    // Retired objects a thread accumulates before it tries to reclaim them
+    static const size_t kCollectThreshold = 64;
+
+    EpochManager() : _epoch(1) {}
+    ~EpochManager() {}
+
+    /**
+     * Critical section of the reader while in scope
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochManager &manager) : _manager(manager), _participant(manager._participants.Local()) {
+            _manager.Enter(_participant);
+        }
+        ~Guard() { _manager.Exit(_participant); }
+
+    private:
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        EpochManager &_manager;
+        Participant &_participant;
+    };
+
+    /**
+     * Starts critical section of the current thread, see Guard
+     */
+    void Enter();
+
+    /**
+     * Ends critical section of the current thread, see Guard
+     */
+    void Exit();
+
+    /**
+     * Schedules destruction of already unlinked object: deleter(ptr) is called once no critical section
+     * started before this call is running
+     */
+    void Retire(void *ptr, void (*deleter)(void *));
+
+    template <typename T> void Retire(T *ptr) {
+        Retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    /**
+     * Tries to advance epoch and destroys objects retired by the current thread which are safe to destroy,
+     * returns number of them
+     */
+    size_t Collect();
+
+    inline uint64_t epoch() const { return _epoch.load(std::memory_order_acquire); }
+
+private:
+    EpochManager(const EpochManager &) = delete;
+    EpochManager &operator=(const EpochManager &) = delete;
+
+    struct Retired {
+        void *ptr;
+        void (*deleter)(void *);
+        uint64_t epoch;
+    };
+
+    struct Participant {
+        ~Participant();
+
+        // Epoch observed on entry shifted left by one with the lowest bit set, zero outside of section
+        std::atomic<uint64_t> state{0};
+
+        // Depth of nested sections, owner thread only
+        size_t nesting = 0;
+
+        // Objects retired by the owner thread, owner only
+        std::vector<Retired> retired;
+    };
+
+    // Critical section bounds for the given thread state
+    void Enter(Participant &p);
+    void Exit(Participant &p);
+
+    // Moves epoch one step forward if every thread in critical section has observed the current one
+    bool TryAdvance();
+
+    std::atomic<uint64_t> _epoch;
+    ThreadLocal<Participant> _participants;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
@@ -1,21 +1,35 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace Afina {
 namespace Concurrency {
 
+// Forward declaration. Do not include real class definition
+// to keep lock free structures out of the public interface
+template <typename T> class InjectionQueue;
+template <typename T> class WorkStealingDeque;
+
 /**
  * # Thread pool
+ * Each worker owns a work stealing deque: tasks submitted from inside of the pool go to the deque of
+ * the submitting worker and are executed in LIFO order, while idle workers steal the oldest tasks from
+ * others. Tasks submitted from outside of the pool go to the shared lock free injection queue.
+ *
+ * Workers which found no work anywhere go to sleep, the only lock in the pool is taken to put them
+ * asleep or to wake them up.
  */
 class Executor {
+public:
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -28,14 +42,20 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
+    /**
+     * @param name of the pool, used for threads naming
+     * @param size number of worker threads
+     * @param queue_size capacity of the injection queue, submissions beyond it are rejected
+     */
+    Executor(std::string name, int size, size_t queue_size = 4096);
     ~Executor();
 
     /**
      * Signal thread pool to stop, it will stop accepting new jobs and close threads just after each become
      * free. All enqueued jobs will be complete.
      *
-     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped
+     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped.
+     * Awaiting from inside of the pool is not allowed
      */
     void Stop(bool await = false);
 
@@ -48,55 +68,92 @@ class Executor {
      */
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
         // Prepare "task"
-        auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
-
-        std::unique_lock<std::mutex> lock(this->mutex);
-        if (state != State::kRun) {
-            return false;
-        }
-
-        // Enqueue new task
-        tasks.push_back(exec);
-        empty_condition.notify_one();
-        return true;
+        return Submit(std::bind(std::forward<F>(func), std::forward<Types>(args)...));
     }
 
+    inline State state() const { return _state.load(std::memory_order_acquire); }
+
 private:
     // No copy/move/assign allowed
-    Executor(const Executor &);            // = delete;
-    Executor(Executor &&);                 // = delete;
-    Executor &operator=(const Executor &); // = delete;
-    Executor &operator=(Executor &&);      // = delete;
+    Executor(const Executor &) = delete;
+    Executor(Executor &&) = delete;
+    Executor &operator=(const Executor &) = delete;
+    Executor &operator=(Executor &&) = delete;
+
+    using Task = std::function<void()>;
+
+    // Per thread state of the pool
+    struct Worker;
+
+    // Worker and injection queue are padded to cache lines, plain new doesn't honour that in C++11,
+    // so they are allocated by posix_memalign and released by this deleter
+    struct AlignedDelete {
+        template <typename T> void operator()(T *object) const {
+            object->~T();
+            free(object);
+        }
+    };
 
     /**
-     * Main function that all pool threads are running. It polls internal task queue and execute tasks
+     * Places task onto the deque of the current worker or onto the injection queue
      */
-    friend void perform(Executor *executor);
+    bool Submit(Task task);
 
     /**
-     * Mutex to protect state below from concurrent modification
+     * Main function that all pool threads are running. It polls internal task queues and execute tasks
      */
-    std::mutex mutex;
+    friend void perform(Executor *executor, Worker *worker);
+
+    // Looks for the next task: own deque, injection queue, deques of other workers
+    Task *Find(Worker &worker);
+
+    // True if there is a task anywhere in the pool
+    bool HasWork() const;
+
+    // Wakes up one sleeping worker if there is any
+    void Notify();
+
+    // Called by the worker which is about to exit
+    void Finished();
+
+    // Worker of the pool current thread belongs to, if any
+    static thread_local Worker *_current;
+
+    std::string _name;
+
+    std::vector<std::unique_ptr<Worker, AlignedDelete>> _workers;
+    std::unique_ptr<InjectionQueue<Task>, AlignedDelete> _injection;
 
     /**
-     * Conditional variable to await new data in case of empty queue
+     * Vector of actual threads that perorm execution
      */
-    std::condition_variable empty_condition;
+    std::vector<std::thread> _threads;
+
+    std::atomic<State> _state;
+
+    // Number of Submit calls in flight, pool could not stop until they are done
+    std::atomic<int> _submitting;
+
+    // Number of workers which are asleep or going to sleep
+    std::atomic<int> _sleeping;
+
+    // Number of workers which are still running
+    int _running;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Mutex to protect sleep/wake up and stop transitions
      */
-    std::vector<std::thread> threads;
+    std::mutex _mutex;
 
     /**
-     * Task queue
+     * Conditional variable to await new tasks in case of empty queues
      */
-    std::deque<std::function<void()>> tasks;
+    std::condition_variable _empty_condition;
 
     /**
-     * Flag to stop bg threads
+     * Conditional variable to await until all workers are stopped
      */
-    State state;
+    std::condition_variable _stop_condition;
 };
 
 } // namespace Concurrency
@@ -1,10 +1,176 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <new>
+#include <thread>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Serializes operations over a sequential data structure without threads taking turns on a lock.
+ * Thread publishes its operation in a slot of its own and then either becomes a combiner, which applies
+ * all pending operations of all threads in one go, or waits until some other combiner applies its
+ * operation. Structure and the combiner flag stay in cache of a single core while it is busy, instead
+ * of bouncing between all contending cores with each operation.
+ *
+ * Op is executed as op(), by one thread at a time, so it could work with the structure without any
+ * synchronization. Exception thrown by op is delivered to the thread which has published it.
+ *
+ * Each thread starts to look for a free slot from the one it used last time, so in common case it
+ * works with the same slot, which lives on its own cache line. If there are more threads than slots
+ * extra ones wait for a slot to be released.
+ */
+template <typename Op> class FlatCombine {
+public:
+    static const size_t kCacheLine = 64;
+
+    // Publication slots, more than number of concurrent threads is expected to be
+    static const size_t kSlots = 128;
+
+    // Combiner goes over slots at most this many times, so it returns to its own work eventually
+    static const size_t kPasses = 4;
+
+    FlatCombine() : _combining(false), _used(0) {
+        void *memory = nullptr;
+        if (posix_memalign(&memory, kCacheLine, kSlots * sizeof(Slot)) != 0) {
+            throw std::bad_alloc();
+        }
+
+        _slots = static_cast<Slot *>(memory);
+        for (size_t i = 0; i < kSlots; i++) {
+            new (&_slots[i]) Slot();
+        }
+    }
+
+    ~FlatCombine() {
+        for (size_t i = 0; i < kSlots; i++) {
+            _slots[i].~Slot();
+        }
+        free(_slots);
+    }
+
+    /**
+     * Applies op and returns once it is done. Effects of all operations applied before are visible to it
+     */
+    void Apply(Op &op) {
+        size_t index = Claim();
+        Slot &slot = _slots[index];
+        slot.op = &op;
+        slot.state.store(kPending, std::memory_order_release);
+
+        // Combiners scan slots up to the highest one ever used
+        size_t used = _used.load(std::memory_order_relaxed);
+        while (used <= index && !_used.compare_exchange_weak(used, index + 1, std::memory_order_release)) {
+        }
+
+        for (unsigned spins = 0; slot.state.load(std::memory_order_acquire) != kDone; spins++) {
+            if (!_combining.load(std::memory_order_relaxed) && !_combining.exchange(true, std::memory_order_acquire)) {
+                // Own slot is pending, so the very first pass applies it
+                Combine();
+                _combining.store(false, std::memory_order_release);
+                continue;
+            }
+            Pause(spins);
+        }
+
+        std::exception_ptr error = slot.error;
+        slot.error = nullptr;
+        slot.op = nullptr;
+        slot.state.store(kFree, std::memory_order_release);
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // No copy/move/assign allowed
+    FlatCombine(const FlatCombine &) = delete;
+    FlatCombine(FlatCombine &&) = delete;
+    FlatCombine &operator=(const FlatCombine &) = delete;
+    FlatCombine &operator=(FlatCombine &&) = delete;
+
+    enum State : uint32_t { kFree, kBusy, kPending, kDone };
+
+    // Operation published by a thread, padded to the whole cache line so that threads don't interfere
+    struct alignas(kCacheLine) Slot {
+        std::atomic<uint32_t> state{kFree};
+        Op *op = nullptr;
+        std::exception_ptr error;
+    };
+
+    // Takes a free slot, starting from the one used by this thread last time
+    size_t Claim() {
+        static thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+        for (unsigned spins = 0;; spins++) {
+            for (size_t i = 0; i < kSlots; i++) {
+                size_t index = (hint + i) % kSlots;
+                uint32_t expected = kFree;
+                if (_slots[index].state.load(std::memory_order_relaxed) == kFree &&
+                    _slots[index].state.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) {
+                    hint = index;
+                    return index;
+                }
+            }
+            Pause(spins);
+        }
+    }
+
+    // Applies pending operations, called by the thread which holds combiner flag
+    void Combine() {
+        for (size_t pass = 0; pass < kPasses; pass++) {
+            size_t applied = 0;
+            size_t used = _used.load(std::memory_order_acquire);
+            for (size_t i = 0; i < used; i++) {
+                Slot &slot = _slots[i];
+                if (slot.state.load(std::memory_order_acquire) != kPending) {
+                    continue;
+                }
+
+                try {
+                    (*slot.op)();
+                } catch (...) {
+                    slot.error = std::current_exception();
+                }
+                slot.state.store(kDone, std::memory_order_release);
+                applied++;
+            }
+
+            if (applied == 0) {
+                break;
+            }
+        }
+    }
+
+    // Busy wait for a short while, then let others run: combiner could be preempted on this very core
+    static void Pause(unsigned spins) {
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Allocated separately, new doesn't respect alignment of Slot
+    Slot *_slots;
+
+    // Some thread is applying operations now
+    std::atomic<bool> _combining;
+
+    // Number of slots ever used, combiner doesn't look beyond it
+    std::atomic<size_t> _used;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,68 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <stdexcept>
+
+#include <pthread.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Reader-writer lock
+ * Any number of threads could hold it shared at once, exclusive owner is the only one. Interface is
+ * the one of C++17 std::shared_mutex, so that std::lock_guard works for exclusive ownership and
+ * SharedLock below for the shared one.
+ *
+ * Writers are preferred where libc allows to choose: once writer waits new readers wait too, otherwise
+ * steady flow of readers never lets it in.
+ */
+class SharedMutex {
+public:
+    SharedMutex() {
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        int err = pthread_rwlock_init(&_lock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+        if (err != 0) {
+            throw std::runtime_error("Failed to init rwlock");
+        }
+    }
+
+    ~SharedMutex() { pthread_rwlock_destroy(&_lock); }
+
+    inline void lock() { pthread_rwlock_wrlock(&_lock); }
+    inline void unlock() { pthread_rwlock_unlock(&_lock); }
+
+    inline void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+    inline void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    SharedMutex(const SharedMutex &) = delete;
+    SharedMutex &operator=(const SharedMutex &) = delete;
+
+    pthread_rwlock_t _lock;
+};
+
+/**
+ * Holds SharedMutex shared while in scope
+ */
+class SharedLock {
+public:
+    explicit SharedLock(SharedMutex &mutex) : _mutex(mutex) { _mutex.lock_shared(); }
+    ~SharedLock() { _mutex.unlock_shared(); }
+
+private:
+    SharedLock(const SharedLock &) = delete;
+    SharedLock &operator=(const SharedLock &) = delete;
+
+    SharedMutex &_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
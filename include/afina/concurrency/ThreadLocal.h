@@ -1,10 +1,158 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include <pthread.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+/**
+ * # Per thread instances of T
+ * Every thread gets its own instance of T in a separate cache line once it first asks for it. Unlike
+ * thread_local variables these belong to the ThreadLocal object: each object has its own set of
+ * instances, which goes away along with it, and all of them could be visited by any thread.
+ *
+ * Instance is value-initialized, so trivial T starts from zero. When thread exits its instance is
+ * kept, so that nothing accumulated in it is lost, and handed over to the next new thread. So number
+ * of instances never exceeds maximal number of threads which have been working with the object at
+ * the same time.
+ *
+ * Owner thread could update its instance while other thread goes through all of them, T must be
+ * ready for that, for example consist of atomics.
+ *
+ * Each object takes a pthread key, number of those is limited by PTHREAD_KEYS_MAX.
+ */
+template <typename T> class ThreadLocal {
+public:
+    static const size_t kCacheLine = 64;
+
+    ThreadLocal() : _slots(nullptr), _size(0) {
+        if (pthread_key_create(&_key, &ThreadLocal::Detach) != 0) {
+            throw std::runtime_error("Failed to create thread local key");
+        }
+    }
+
+    ~ThreadLocal() {
+        // Threads which are still alive won't call Detach anymore
+        pthread_key_delete(_key);
+
+        while (_slots != nullptr) {
+            Slot *slot = _slots;
+            _slots = slot->next;
+            slot->~Slot();
+            free(slot);
+        }
+    }
+
+    /**
+     * Instance of the current thread
+     */
+    inline T &Local() {
+        Slot *slot = static_cast<Slot *>(pthread_getspecific(_key));
+        if (slot == nullptr) {
+            slot = Attach();
+        }
+        return slot->value;
+    }
+
+    /**
+     * Calls f for the instance of each thread
+     */
+    template <typename F> void ForEach(F f) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Slot *slot = _slots; slot != nullptr; slot = slot->next) {
+            f(slot->value);
+        }
+    }
+
+    /**
+     * Folds instances of all threads into a single value: result = f(result, instance)
+     */
+    template <typename R, typename F> R Combine(R init, F f) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Slot *slot = _slots; slot != nullptr; slot = slot->next) {
+            init = f(init, slot->value);
+        }
+        return init;
+    }
+
+    /**
+     * Number of instances created so far
+     */
+    inline size_t size() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _size;
+    }
+
+private:
+    // No copy/move/assign allowed
+    ThreadLocal(const ThreadLocal &) = delete;
+    ThreadLocal(ThreadLocal &&) = delete;
+    ThreadLocal &operator=(const ThreadLocal &) = delete;
+    ThreadLocal &operator=(ThreadLocal &&) = delete;
+
+    // Instance padded to the whole number of cache lines, so that neighbours never share one
+    struct alignas(kCacheLine) Slot {
+        explicit Slot(ThreadLocal *owner) : value(), owner(owner) {}
+
+        T value;
+        ThreadLocal *owner;
+        bool attached = true;
+
+        // All slots of the object
+        Slot *next = nullptr;
+    };
+
+    // Binds current thread to the instance left by some exited thread or to a new one
+    Slot *Attach() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        Slot *slot = _slots;
+        while (slot != nullptr && slot->attached) {
+            slot = slot->next;
+        }
+
+        if (slot != nullptr) {
+            slot->attached = true;
+        } else {
+            void *memory = nullptr;
+            if (posix_memalign(&memory, kCacheLine, sizeof(Slot)) != 0) {
+                throw std::bad_alloc();
+            }
+
+            slot = new (memory) Slot(this);
+            slot->next = _slots;
+            _slots = slot;
+            _size++;
+        }
+
+        if (pthread_setspecific(_key, slot) != 0) {
+            slot->attached = false;
+            throw std::runtime_error("Failed to set thread local value");
+        }
+        return slot;
+    }
+
+    // Called on thread exit: instance stays with the object, ready for the next thread
+    static void Detach(void *value) {
+        Slot *slot = static_cast<Slot *>(value);
+        std::lock_guard<std::mutex> lock(slot->owner->_mutex);
+        slot->attached = false;
+    }
+
+    pthread_key_t _key;
+
+    // Guards list of slots and their attached flags, not the values
+    std::mutex _mutex;
+    Slot *_slots;
+    size_t _size;
+};
 
 } // namespace Concurrency
 } // namespace Afina
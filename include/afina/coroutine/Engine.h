@@ -1,11 +1,15 @@
 #ifndef AFINA_COROUTINE_ENGINE_H
 #define AFINA_COROUTINE_ENGINE_H
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <setjmp.h>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 namespace Afina {
 namespace Coroutine {
@@ -13,8 +17,25 @@ namespace Coroutine {
 /**
  * # Entry point of coroutine library
  * Allows to run coroutine and schedule its execution. Not threadsafe
+ *
+ * Engine works in one of two modes:
+ * - kCopyStack: all coroutines run on the stack of start() caller, on each switch used part of the stack
+ *   is copied aside and the stack of the next coroutine is copied back, so switch costs O(stack depth)
+ * - kSeparateStack: each coroutine runs on its own mmap'ed stack with a guard page below it, switch
+ *   saves and restores a handful of registers only. Coroutine must fit its stack, overflow hits the
+ *   guard page and crashes the process
+ *
+ * Coroutine could block itself, for example waiting for I/O. Blocked coroutine doesn't get control until
+ * somebody unblocks it. Once there is nothing to run but blocked coroutines engine calls unblocker
+ * given on construction, it is supposed to wait for some events and unblock coroutines waiting for them
  */
 class Engine final {
+public:
+    enum class Mode { kCopyStack, kSeparateStack };
+
+    // Default size of a coroutine stack in kSeparateStack mode
+    static const size_t kDefaultStackSize = 256 * 1024;
+
 private:
     /**
      * A single coroutine instance which could be scheduled for execution
@@ -34,9 +55,24 @@ private:
         // Saved coroutine context (registers)
         jmp_buf Environment;
 
+        // kSeparateStack mode: saved stack pointer of the suspended coroutine, registers are kept on the
+        // stack itself. Low/Hight are bounds of the coroutine stack
+        void *Sp = nullptr;
+
+        // kSeparateStack mode: function with all arguments bound to be called on the coroutine stack
+        std::function<void()> Body;
+
+        // Routine is in "blocked" list rather than in "alive"
+        bool Blocked = false;
+
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
         struct context *next = nullptr;
+
+        context() = default;
+        context(const context &) = delete;
+        context &operator=(const context &) = delete;
+        ~context() { delete[] std::get<0>(Stack); }
     } context;
 
     /**
@@ -54,11 +90,90 @@ private:
      */
     context *alive;
 
+    /**
+     * List of routines waiting to be unblocked
+     */
+    context *blocked;
+
     /**
      * Context to be returned finally
      */
     context *idle_ctx;
 
+    Mode _mode;
+    size_t _stack_size;
+
+    /**
+     * Called when no routine is ready to run but some are blocked
+     */
+    std::function<void()> _unblocker;
+
+    /**
+     * kSeparateStack mode: coroutine which is done, its stack could be released only once execution
+     * leaves it
+     */
+    context *_zombie;
+
+    /**
+     * kSeparateStack mode: released stacks ready to be reused by new coroutines
+     */
+    std::vector<char *> _stacks;
+
+    // Builds index sequence of the arguments in C++11
+    template <size_t... I> struct Indices {};
+    template <size_t N, size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+    template <size_t... I> struct MakeIndices<0, I...> {
+        using type = Indices<I...>;
+    };
+
+    template <typename... Ta, size_t... I>
+    static void Call(void (*func)(Ta...), std::tuple<Ta...> &args, Indices<I...>) {
+        func(std::forward<Ta>(std::get<I>(args))...);
+    }
+
+    /**
+     * kSeparateStack mode: allocates stack for the coroutine and prepares it so that the first switch
+     * to the coroutine calls Launch
+     */
+    void Prepare(context &ctx);
+
+    /**
+     * kSeparateStack mode: body of each coroutine, runs on the coroutine stack
+     */
+    static void Launch(Engine *engine, context *ctx);
+
+    /**
+     * kSeparateStack mode: runs coroutines from the start() caller stack until all of them are done
+     */
+    void Serve(context *main);
+
+    /**
+     * kSeparateStack mode: releases coroutine which is done
+     */
+    void Reap();
+
+    /**
+     * Removes coroutine from the list it belongs to
+     */
+    void Unlink(context &ctx);
+
+    /**
+     * Puts coroutine to the head of the given list
+     */
+    void Link(context &ctx, context *&list);
+
+    /**
+     * Runs on behalf of idle context: calls unblocker until some routine is ready to run. Returns false if
+     * there is nothing to run and never will be
+     */
+    bool Idle();
+
+    /**
+     * Releases coroutines which are still blocked once start() is about to return, nobody is going to
+     * unblock them anymore
+     */
+    void Shutdown();
+
 protected:
     /**
      * Save stack of the current coroutine in the given context
@@ -73,12 +188,22 @@ protected:
     /**
      * Suspend current coroutine execution and execute given context
      */
-    // void Enter(context& ctx);
+    void Enter(context &ctx);
 
 public:
-    Engine() : StackBottom(0), cur_routine(nullptr), alive(nullptr) {}
+    /**
+     * @param mode how coroutines stacks are kept, see above
+     * @param stack_size size of each coroutine stack in kSeparateStack mode
+     * @param unblocker called when all coroutines are blocked, without it blocked coroutines are never
+     * resumed once nothing else is left
+     */
+    Engine(Mode mode = Mode::kCopyStack, size_t stack_size = kDefaultStackSize,
+           std::function<void()> unblocker = nullptr);
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
+    ~Engine();
+
+    inline Mode mode() const { return _mode; }
 
     /**
      * Gives up current routine execution and let engine to schedule other one. It is not defined when
@@ -99,6 +224,22 @@ public:
      */
     void sched(void *routine);
 
+    /**
+     * Blocks the given routine, so that it is not scheduled until unblock is called for it. If routine is not
+     * specified current one gets blocked and control passes to any other routine ready to run
+     */
+    void block(void *routine = nullptr);
+
+    /**
+     * Makes blocked routine ready to run again. Doesn't pass control to it
+     */
+    void unblock(void *routine);
+
+    /**
+     * Routine which is running now, nullptr outside of coroutines
+     */
+    inline void *current() const { return cur_routine != idle_ctx ? cur_routine : nullptr; }
+
     /**
      * Entry point into the engine. Prepare all internal mechanics and starts given function which is
      * considered as main.
@@ -118,16 +259,25 @@ public:
         void *pc = run(main, std::forward<Ta>(args)...);
         idle_ctx = new context();
 
-        if (setjmp(idle_ctx->Environment) > 0) {
-            // Here: correct finish of the coroutine section
-            yield();
+        if (_mode == Mode::kSeparateStack) {
+            // Caller stack is not shared with coroutines, it just waits for them here
+            Serve(static_cast<context *>(pc));
+        } else if (setjmp(idle_ctx->Environment) > 0) {
+            // Here: correct finish of the coroutine section or everybody is blocked
+            cur_routine = idle_ctx;
+            if (Idle()) {
+                yield();
+            }
         } else if (pc != nullptr) {
             Store(*idle_ctx);
             sched(pc);
         }
 
         // Shutdown runtime
+        cur_routine = nullptr;
+        Shutdown();
         delete idle_ctx;
+        idle_ctx = nullptr;
         this->StackBottom = 0;
     }
 
@@ -144,6 +294,16 @@ public:
         // New coroutine context that carries around all information enough to call function
         context *pc = new context();
 
+        if (_mode == Mode::kSeparateStack) {
+            // Coroutine doesn't see this stack, so arguments are kept along with the function. Note that
+            // references are kept as references, values are copied
+            std::tuple<Ta...> bound(std::forward<Ta>(args)...);
+            pc->Body = [func, bound]() mutable { Call(func, bound, typename MakeIndices<sizeof...(Ta)>::type()); };
+            Prepare(*pc);
+            Link(*pc, alive);
+            return pc;
+        }
+
         // Store current state right here, i.e just before enter new coroutine, later, once it gets scheduled
         // execution starts here. Note that we have to acquire stack of the current function call to ensure
         // that function parameters will be passed along
@@ -173,7 +333,6 @@ public:
             // current coroutine finished, and the pointer is not relevant now
             cur_routine = nullptr;
             pc->prev = pc->next = nullptr;
-            delete std::get<0>(pc->Stack);
             delete pc;
 
             // We cannot return here, as this function "returned" once already, so here we must select some other
@@ -188,11 +347,7 @@ public:
         Store(*pc);
 
         // Add routine as alive double-linked list
-        pc->next = alive;
-        alive = pc;
-        if (pc->next != nullptr) {
-            pc->next->prev = pc;
-        }
+        Link(*pc, alive);
 
         return pc;
     }
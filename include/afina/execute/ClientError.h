@@ -0,0 +1,34 @@
+#ifndef AFINA_EXECUTE_CLIENT_ERROR_H
+#define AFINA_EXECUTE_CLIENT_ERROR_H
+
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Command client got wrong
+ * Parser builds it in place of the command which is well formed but breaks protocol limits, so
+ * that argument is still consumed and connection goes on with the next command.
+ *
+ * Command writes "CLIENT_ERROR <message>" to the output and doesn't touch the storage.
+ */
+class ClientError : public Command {
+public:
+    ClientError(const std::string &message) : _message(message) {}
+    ~ClientError() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    const std::string &message() const { return _message; }
+
+private:
+    std::string _message;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_CLIENT_ERROR_H
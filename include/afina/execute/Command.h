@@ -1,14 +1,21 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <memory>
 #include <string>
 
+namespace spdlog {
+class logger;
+} // namespace spdlog
+
 namespace Afina {
 
 class Storage;
 
 namespace Execute {
 
+class Response;
+
 /**
  *
  *
@@ -19,6 +26,23 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as above, but result could reference values right from the storage instead of
+     * copying them. By default result of the method above is used
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Response &out);
+
+    /**
+     * Sets logger all commands trace their execution to. Tracing goes on trace level, so unless it is
+     * enabled for the logger it costs a single level check. Must be set before commands are executed,
+     * without logger there is no tracing at all
+     */
+    static void SetLogger(std::shared_ptr<spdlog::logger> logger);
+
+protected:
+    // See SetLogger
+    static std::shared_ptr<spdlog::logger> _logger;
 };
 
 } // namespace Execute
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include <afina/Storage.h>
+
 #include "Command.h"
 
 namespace Afina {
@@ -41,6 +43,15 @@ public:
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    // Values are referenced from the storage, see Response.h
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+    /**
+     * Builds response out of values looked up already, values[i] belongs to keys()[i] and is empty if there
+     * is no such key. Allows to look up keys of a number of get commands with a single storage call
+     */
+    void Respond(const SharedValue *values, Response &out) const;
+
 private:
     std::vector<std::string> _keys;
 };
@@ -22,6 +22,15 @@ public:
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    /**
+     * Converts memcached expiration time into number of seconds entry must live. Expiration time
+     * up to 30 days is relative to the current time, bigger values are absolute unix time, 0
+     * means entry never expires.
+     *
+     * @return false if entry is already expired and must not be stored at all
+     */
+    bool ttl(uint32_t &out) const;
+
 protected:
     const std::string _key;
     const uint32_t _flags;
@@ -0,0 +1,60 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Response assembled from pieces
+ * Sequence of segments to be sent one after another: text produced by the command and values
+ * referenced right from the storage. Network layer sends segments with a single writev or a chain of
+ * sends, so value bytes are never copied on the way to the socket
+ */
+class Response {
+public:
+    struct Segment {
+        std::string text;
+        SharedValue value;
+
+        inline const char *data() const { return value ? value->data() : text.data(); }
+        inline size_t size() const { return value ? value->size() : text.size(); }
+    };
+
+    /**
+     * Appends text, it gets merged with the previous text segment if there is any
+     */
+    void Append(const char *data, size_t size);
+    inline void Append(const std::string &text) { Append(text.data(), text.size()); }
+
+    /**
+     * Appends value without copying it
+     */
+    void Append(SharedValue value);
+
+    inline bool empty() const { return _segments.empty(); }
+    inline std::vector<Segment> &segments() { return _segments; }
+
+    /**
+     * Total number of bytes in all segments
+     */
+    size_t size() const;
+
+    /**
+     * Joins all segments into the single string
+     */
+    std::string str() const;
+
+private:
+    std::vector<Segment> _segments;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
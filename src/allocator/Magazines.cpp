@@ -0,0 +1,265 @@
+#include <afina/allocator/Magazines.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+namespace {
+
+// Magazine of a class holds about this much memory, but no less than kMinBlocks and no more than
+// kMaxBlocks blocks
+const size_t kMagazineBytes = 128 * 1024;
+const size_t kMinBlocks = 8;
+const size_t kMaxBlocks = 64;
+
+std::atomic<uint64_t> next_id(1);
+
+// Cache of the instance used by the current thread last time
+struct LastUsed {
+    uint64_t owner = 0;
+    void *cache = nullptr;
+};
+thread_local LastUsed last_used;
+
+} // namespace
+
+// See Magazines.h
+size_t Magazines::ClassOf(size_t size) {
+    if (size <= 128) {
+        return size == 0 ? 0 : (size - 1) / 16;
+    }
+
+    // Size is in (2^k, 2^(k+1)], split into 4 steps of 2^(k-2)
+    size_t k = 63 - __builtin_clzl(size - 1);
+    size_t step = (size - (size_t(1) << k) - 1) >> (k - 2);
+    return 8 + (k - 7) * 4 + step;
+}
+
+// See Magazines.h
+size_t Magazines::ClassSize(size_t cls) {
+    if (cls < 8) {
+        return (cls + 1) * 16;
+    }
+
+    size_t k = 7 + (cls - 8) / 4;
+    size_t step = (cls - 8) % 4;
+    return (size_t(1) << k) + ((step + 1) << (k - 2));
+}
+
+// See Magazines.h
+Magazines::Magazines(void *base, size_t size) : _id(next_id.fetch_add(1)), _shared(base, size) {}
+
+// See Magazines.h
+Magazines::~Magazines() {}
+
+// See Magazines.h
+Pointer Magazines::alloc(size_t N) {
+    if (N > kMaxCached) {
+        std::lock_guard<std::mutex> lock(_lock);
+        Pointer p = _shared.alloc(N);
+        _large_allocs.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    size_t cls = ClassOf(N);
+    Magazine &magazine = Local().magazines[cls];
+    if (magazine.blocks.empty()) {
+        std::lock_guard<std::mutex> lock(_lock);
+        Refill(magazine, cls);
+    } else {
+        magazine.hits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Pointer p = std::move(magazine.blocks.back());
+    magazine.blocks.pop_back();
+    magazine.allocs.fetch_add(1, std::memory_order_relaxed);
+    magazine.cached.store(magazine.blocks.size(), std::memory_order_relaxed);
+    return p;
+}
+
+// See Magazines.h
+void Magazines::realloc(Pointer &p, size_t N) {
+    if (p.get() == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    size_t size = _shared.size(p);
+    if (N <= size) {
+        return;
+    }
+
+    if (size > kMaxCached && N > kMaxCached) {
+        std::lock_guard<std::mutex> lock(_lock);
+        _shared.realloc(p, N);
+        return;
+    }
+
+    Pointer moved = alloc(N);
+    std::memcpy(moved.get(), p.get(), size);
+    free(p);
+    p = moved;
+}
+
+// See Magazines.h
+void Magazines::free(Pointer &p) {
+    if (p.get() == nullptr) {
+        return;
+    }
+
+    size_t size = _shared.size(p);
+    if (size > kMaxCached) {
+        std::lock_guard<std::mutex> lock(_lock);
+        _shared.free(p);
+        _large_frees.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Block could be a bit larger than its class, it goes to the largest class it could serve
+    size_t cls = ClassOf(size);
+    if (ClassSize(cls) > size) {
+        cls--;
+    }
+
+    Magazine &magazine = Local().magazines[cls];
+    if (magazine.blocks.size() >= magazine.capacity) {
+        std::lock_guard<std::mutex> lock(_lock);
+        Flush(magazine, magazine.capacity / 2);
+    }
+
+    magazine.blocks.push_back(std::move(p));
+    p = Pointer();
+    magazine.frees.fetch_add(1, std::memory_order_relaxed);
+    magazine.cached.store(magazine.blocks.size(), std::memory_order_relaxed);
+}
+
+// See Magazines.h
+void Magazines::flush() {
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto &cache : _caches) {
+        for (auto &magazine : cache.second->magazines) {
+            Flush(magazine, magazine.blocks.size());
+        }
+    }
+}
+
+// See Magazines.h
+void Magazines::defrag() {
+    flush();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _shared.defrag();
+}
+
+// See Magazines.h
+std::string Magazines::dump() const {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::stringstream out;
+    out << std::setw(6) << "class" << std::setw(8) << "size" << std::setw(10) << "in use" << std::setw(10) << "cached"
+        << std::setw(12) << "allocs" << std::setw(10) << "hit %" << std::setw(10) << "refills" << std::setw(10)
+        << "flushes" << '\n';
+
+    uint64_t total_allocs = 0, total_hits = 0;
+    for (size_t cls = 0; cls < kClasses; cls++) {
+        int64_t in_use = 0;
+        uint64_t allocs = 0, hits = 0, refills = 0, flushes = 0, cached = 0;
+        for (auto &cache : _caches) {
+            const Magazine &magazine = cache.second->magazines[cls];
+            allocs += magazine.allocs.load(std::memory_order_relaxed);
+            in_use += magazine.allocs.load(std::memory_order_relaxed) - magazine.frees.load(std::memory_order_relaxed);
+            hits += magazine.hits.load(std::memory_order_relaxed);
+            refills += magazine.refills.load(std::memory_order_relaxed);
+            flushes += magazine.flushes.load(std::memory_order_relaxed);
+            cached += magazine.cached.load(std::memory_order_relaxed);
+        }
+
+        total_allocs += allocs;
+        total_hits += hits;
+        if (allocs == 0 && cached == 0) {
+            continue;
+        }
+
+        out << std::setw(6) << cls << std::setw(8) << ClassSize(cls) << std::setw(10) << in_use << std::setw(10)
+            << cached << std::setw(12) << allocs << std::setw(10) << std::fixed << std::setprecision(1)
+            << (allocs > 0 ? 100.0 * hits / allocs : 0.0) << std::setw(10) << refills << std::setw(10) << flushes
+            << '\n';
+    }
+
+    out << "large: " << _large_allocs.load(std::memory_order_relaxed) - _large_frees.load(std::memory_order_relaxed)
+        << " in use, " << _large_allocs.load(std::memory_order_relaxed) << " allocs\n";
+    out << "magazines: " << _caches.size() << " threads, hit rate " << std::fixed << std::setprecision(1)
+        << (total_allocs > 0 ? 100.0 * total_hits / total_allocs : 0.0) << "%\n";
+
+    // Fragmentation is the share of free memory which can't be used for the largest block
+    Simple::Usage usage = _shared.usage();
+    size_t available = usage.free + usage.unused;
+    out << "shared: " << usage.used << " bytes in " << usage.used_blocks << " blocks, " << usage.free << " bytes in "
+        << usage.free_blocks << " free blocks, " << usage.unused << " bytes unused, largest " << usage.largest
+        << ", fragmentation " << std::setprecision(1)
+        << (available > 0 ? 100.0 * (1.0 - double(usage.largest) / available) : 0.0) << "%\n";
+    return out.str();
+}
+
+// See Magazines.h
+Magazines::Cache &Magazines::Local() {
+    if (last_used.owner == _id) {
+        return *static_cast<Cache *>(last_used.cache);
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    std::unique_ptr<Cache> &cache = _caches[std::this_thread::get_id()];
+    if (!cache) {
+        cache.reset(new Cache());
+        for (size_t cls = 0; cls < kClasses; cls++) {
+            Magazine &magazine = cache->magazines[cls];
+            magazine.capacity = std::min(kMaxBlocks, std::max(kMinBlocks, kMagazineBytes / ClassSize(cls)));
+            magazine.blocks.reserve(magazine.capacity);
+        }
+    }
+
+    last_used.owner = _id;
+    last_used.cache = cache.get();
+    return *cache;
+}
+
+// See Magazines.h
+void Magazines::Refill(Magazine &magazine, size_t cls) {
+    // Half of the magazine, so that the following frees don't flush it right away
+    size_t count = std::max(size_t(1), magazine.capacity / 2);
+    for (size_t i = 0; i < count; i++) {
+        try {
+            magazine.blocks.push_back(_shared.alloc(ClassSize(cls)));
+        } catch (AllocError &) {
+            if (magazine.blocks.empty()) {
+                throw;
+            }
+            break;
+        }
+    }
+    magazine.refills.fetch_add(1, std::memory_order_relaxed);
+}
+
+// See Magazines.h
+void Magazines::Flush(Magazine &magazine, size_t count) {
+    // The oldest blocks go first, recently freed ones are likely still in CPU cache
+    count = std::min(count, magazine.blocks.size());
+    for (size_t i = 0; i < count; i++) {
+        _shared.free(magazine.blocks[i]);
+    }
+    magazine.blocks.erase(magazine.blocks.begin(), magazine.blocks.begin() + count);
+
+    if (count > 0) {
+        magazine.flushes.fetch_add(1, std::memory_order_relaxed);
+    }
+    magazine.cached.store(magazine.blocks.size(), std::memory_order_relaxed);
+}
+
+} // namespace Allocator
+} // namespace Afina
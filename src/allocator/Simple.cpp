@@ -1,40 +1,459 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
 /**
- * TODO: semantics
- * @param N size_t
+ * Block header, payload follows it right away. Free blocks have no handle and use prev/next to be
+ * kept in the list, for used blocks they are just padding keeping payload aligned
  */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
+struct Simple::Block {
+    // Payload size, always multiple of kAlign
+    uint32_t size;
 
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
+    // Index of indirection table slot referring to the block, kNone if block is free
+    uint32_t handle;
 
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
+    // Neighbours in the list of free blocks
+    uint32_t prev;
+    uint32_t next;
+};
 
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
+namespace {
 
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+const size_t kAlign = 16;
+const uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+// Smallest block worth to be split off: header and minimal payload
+const size_t kMinBlock = 2 * kAlign;
+
+// Slab of small blocks carved at once takes about this much
+const size_t kSlabBytes = 2048;
+
+// Free slot of the indirection table keeps the next free slot with the lowest bit set, so that it
+// never looks like an address of the block
+const uintptr_t kFreeSlot = 1;
+
+inline size_t Round(size_t size) { return (std::max(size, size_t(1)) + kAlign - 1) / kAlign * kAlign; }
+
+} // namespace
+
+// See Simple.h
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {
+    static_assert(sizeof(Block) == kAlign, "Block header must keep payload aligned");
+
+    uintptr_t begin = reinterpret_cast<uintptr_t>(base);
+    uintptr_t end = begin + size;
+
+    // Blocks are addressed by 32 bit offsets, area past 4GB is not used
+    begin = (begin + kAlign - 1) / kAlign * kAlign;
+    end = std::max(begin, end / sizeof(void *) * sizeof(void *));
+    end = std::min(end, begin + std::numeric_limits<uint32_t>::max() / kAlign * kAlign);
+
+    _begin = reinterpret_cast<char *>(begin);
+    _end = reinterpret_cast<char *>(end);
+    _top = 0;
+    _handles = reinterpret_cast<void **>(_end);
+    _free_handle = nullptr;
+
+    std::fill(_small, _small + kClasses, kNone);
+    std::fill(_large, _large + kBins, kNone);
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    if (N > size_t(_end - _begin)) {
+        throw AllocError(AllocErrorType::NoMemory, "Requested block is larger than the whole area");
+    }
+
+    void **slot = Handle();
+    Offset offset;
+    try {
+        offset = Place(Round(N));
+    } catch (AllocError &) {
+        *slot = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(_free_handle) | kFreeSlot);
+        _free_handle = slot;
+        throw;
+    }
+
+    At(offset)->handle = reinterpret_cast<void **>(_end) - slot - 1;
+    *slot = _begin + offset + sizeof(Block);
+    return Pointer(slot);
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._slot == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    if (N > size_t(_end - _begin)) {
+        throw AllocError(AllocErrorType::NoMemory, "Requested block is larger than the whole area");
+    }
+
+    Offset offset = Resolve(p._slot);
+    Block *block = At(offset);
+    size_t size = Round(N);
+
+    // Grow in place taking free blocks which follow, and free space if the block is the last one
+    Offset next = offset + sizeof(Block) + block->size;
+    while (block->size < size && next < _top && At(next)->handle == kNone) {
+        Unlink(next);
+        block->size += sizeof(Block) + At(next)->size;
+        next = offset + sizeof(Block) + block->size;
+    }
+
+    if (block->size < size && next == _top && _begin + offset + sizeof(Block) + size <= (char *)_handles) {
+        _top = offset + sizeof(Block) + size;
+        block->size = size;
+    }
+
+    if (block->size >= size) {
+        Split(offset, size);
+        return;
+    }
+
+    // No way, move it. Block keeps all the space taken so far and still valid if there is no memory
+    Offset moved = Place(size);
+    std::memcpy(_begin + moved + sizeof(Block), _begin + offset + sizeof(Block), block->size);
+    At(moved)->handle = block->handle;
+    *p._slot = _begin + moved + sizeof(Block);
+    Release(offset);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._slot == nullptr) {
+        return;
+    }
+
+    Offset offset = Resolve(p._slot);
+    *p._slot = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(_free_handle) | kFreeSlot);
+    _free_handle = p._slot;
+    p._slot = nullptr;
+
+    Release(offset);
+}
+
+// See Simple.h
+void Simple::defrag() {
+    // Slide every used block down to the end of the previous one. Headers of the blocks not visited yet
+    // are never overwritten as block moves only down by the free space before it
+    Offset to = 0;
+    for (Offset from = 0; from < _top;) {
+        Block *block = At(from);
+        size_t length = sizeof(Block) + block->size;
+
+        if (block->handle != kNone) {
+            if (to != from) {
+                std::memmove(_begin + to, _begin + from, length);
+            }
+
+            void **slot = reinterpret_cast<void **>(_end) - At(to)->handle - 1;
+            *slot = _begin + to + sizeof(Block);
+            to += length;
+        }
+        from += length;
+    }
+
+    // All free space is at the end now
+    _top = to;
+    std::fill(_small, _small + kClasses, kNone);
+    std::fill(_large, _large + kBins, kNone);
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    size_t used = 0, blocks = 0, free = 0, holes = 0;
+    std::stringstream list;
+    for (Offset offset = 0; offset < _top; offset += sizeof(Block) + At(offset)->size) {
+        const Block *block = At(offset);
+        list << offset << '\t' << block->size << '\t';
+        if (block->handle != kNone) {
+            list << "used #" << block->handle << '\n';
+            used += block->size;
+            blocks++;
+        } else {
+            list << "free" << '\n';
+            free += block->size;
+            holes++;
+        }
+    }
+
+    std::stringstream out;
+    out << "area " << (_end - _begin) << " bytes, " << blocks << " used blocks of " << used << " bytes, " << holes
+        << " free blocks of " << free << " bytes, " << ((char *)_handles - (_begin + _top)) << " bytes unused, "
+        << (reinterpret_cast<void **>(_end) - _handles) << " handles\n";
+    out << list.str();
+    return out.str();
+}
+
+// See Simple.h
+size_t Simple::size(const Pointer &p) const {
+    if (p._slot == nullptr) {
+        return 0;
+    }
+    return reinterpret_cast<const Block *>(static_cast<char *>(*p._slot) - sizeof(Block))->size;
+}
+
+// See Simple.h
+Pointer Simple::handle(void *address) const {
+    if (address == nullptr) {
+        return Pointer();
+    }
+
+    char *payload = static_cast<char *>(address);
+    if (payload < _begin + sizeof(Block) || payload >= _end || (payload - _begin) % kAlign != 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Address doesn't belong to the allocator");
+    }
+
+    // Slot of the used block refers back to it
+    const Block *block = reinterpret_cast<const Block *>(payload - sizeof(Block));
+    void **slot = reinterpret_cast<void **>(_end) - block->handle - 1;
+    if (block->handle == kNone || slot < reinterpret_cast<void **>(payload) || *slot != address) {
+        throw AllocError(AllocErrorType::InvalidFree, "Address is not a start of the allocated block");
+    }
+    return Pointer(slot);
+}
+
+// See Simple.h
+Simple::Usage Simple::usage() const {
+    Usage usage = {0, 0, 0, 0, 0, 0};
+    for (Offset offset = 0; offset < _top; offset += sizeof(Block) + At(offset)->size) {
+        const Block *block = At(offset);
+        if (block->handle != kNone) {
+            usage.used += block->size;
+            usage.used_blocks++;
+        } else {
+            usage.free += block->size;
+            usage.free_blocks++;
+            usage.largest = std::max(usage.largest, size_t(block->size));
+        }
+    }
+
+    // New block needs a header and maybe a new handle
+    usage.unused = (char *)_handles - (_begin + _top);
+    if (usage.unused >= sizeof(Block) + sizeof(void *)) {
+        usage.largest = std::max(usage.largest, usage.unused - sizeof(Block) - sizeof(void *));
+    }
+    return usage;
+}
+
+// See Simple.h
+Simple::Offset Simple::Place(size_t size) {
+    const size_t length = sizeof(Block) + size;
+
+    // Free large block for the large one or for the new slab: best fit from the bin of the size, which
+    // has smaller blocks as well, otherwise any from the next non empty bin
+    Offset best = kNone;
+    if (size > kClasses * kAlign || _small[size / kAlign - 1] == kNone) {
+        size_t bin = size > kClasses * kAlign ? Bin(size) : 0;
+        for (Offset offset = _large[bin]; offset != kNone; offset = At(offset)->next) {
+            if (At(offset)->size >= size && (best == kNone || At(offset)->size < At(best)->size)) {
+                best = offset;
+                if (At(best)->size == size) {
+                    break;
+                }
+            }
+        }
+
+        for (bin++; best == kNone && bin < kBins; bin++) {
+            best = _large[bin];
+        }
+    }
+
+    if (size > kClasses * kAlign) {
+        Offset offset;
+        if (best != kNone) {
+            Unlink(best);
+            Split(best, size);
+            return best;
+        } else if (Bump(size, offset)) {
+            return offset;
+        }
+        throw AllocError(AllocErrorType::NoMemory, "No free block large enough");
+    }
+
+    // Small one, reuse free block of the class if any
+    Offset &head = _small[size / kAlign - 1];
+    if (head != kNone) {
+        Offset offset = head;
+        Unlink(offset);
+        return offset;
+    }
+
+    // New slab of the class: from the free large block if any, from free space otherwise
+    size_t count = std::max(size_t(1), kSlabBytes / length);
+    Offset slab;
+    size_t space;
+    if (best != kNone) {
+        Unlink(best);
+        slab = best;
+        space = sizeof(Block) + At(best)->size;
+    } else {
+        slab = _top;
+        space = (char *)_handles - (_begin + _top);
+        if (space < length) {
+            throw AllocError(AllocErrorType::NoMemory, "No space for a new slab");
+        }
+    }
+
+    // Blocks are linked backwards, so that they are taken in address order
+    count = std::min(count, space / length);
+    for (size_t i = count; i-- > 0;) {
+        At(slab + i * length)->size = size;
+        if (i > 0) {
+            Link(slab + i * length);
+        }
+    }
+
+    if (best == kNone) {
+        _top = slab + count * length;
+    } else if (space - count * length >= kMinBlock) {
+        Offset rest = slab + count * length;
+        At(rest)->size = space - count * length - sizeof(Block);
+        Release(rest);
+    } else if (space > count * length) {
+        // Tail is too small to be a block, let the last one have it
+        Offset last = slab + (count - 1) * length;
+        if (count > 1) {
+            Unlink(last);
+        }
+        At(last)->size += space - count * length;
+        if (count > 1) {
+            Link(last);
+        }
+    }
+
+    return slab;
+}
+
+// See Simple.h
+bool Simple::Bump(size_t size, Offset &offset) {
+    if (_begin + _top + sizeof(Block) + size > (char *)_handles) {
+        return false;
+    }
+
+    offset = _top;
+    At(offset)->size = size;
+    _top += sizeof(Block) + size;
+    return true;
+}
+
+// See Simple.h
+void Simple::Split(Offset offset, size_t size) {
+    Block *block = At(offset);
+    if (block->size - size < kMinBlock) {
+        return;
+    }
+
+    Offset rest = offset + sizeof(Block) + size;
+    At(rest)->size = block->size - size - sizeof(Block);
+    block->size = size;
+    Release(rest);
+}
+
+// See Simple.h
+void Simple::Release(Offset offset) {
+    Block *block = At(offset);
+    block->handle = kNone;
+    if (offset + sizeof(Block) + block->size == _top) {
+        _top = offset;
+        return;
+    }
+    Link(offset);
+}
+
+// See Simple.h
+void Simple::Link(Offset offset) {
+    Block *block = At(offset);
+    Offset &head = List(block->size);
+
+    block->handle = kNone;
+    block->prev = kNone;
+    block->next = head;
+    if (head != kNone) {
+        At(head)->prev = offset;
+    }
+    head = offset;
+}
+
+// See Simple.h
+void Simple::Unlink(Offset offset) {
+    Block *block = At(offset);
+    Offset &head = List(block->size);
+
+    if (block->prev != kNone) {
+        At(block->prev)->next = block->next;
+    } else {
+        head = block->next;
+    }
+
+    if (block->next != kNone) {
+        At(block->next)->prev = block->prev;
+    }
+    block->prev = block->next = kNone;
+}
+
+// See Simple.h
+Simple::Offset &Simple::List(size_t size) {
+    if (size <= kClasses * kAlign) {
+        return _small[size / kAlign - 1];
+    }
+    return _large[Bin(size)];
+}
+
+// See Simple.h
+size_t Simple::Bin(size_t size) {
+    // Size is in (2^k, 2^(k+1)], split into 4 steps of 2^(k-2)
+    size_t k = 63 - __builtin_clzl(size - 1);
+    size_t step = (size - (size_t(1) << k) - 1) >> (k - 2);
+    return std::min((k - 9) * 4 + step, kBins - 1);
+}
+
+// See Simple.h
+void **Simple::Handle() {
+    if (_free_handle != nullptr) {
+        void **slot = _free_handle;
+        _free_handle = reinterpret_cast<void **>(reinterpret_cast<uintptr_t>(*slot) & ~kFreeSlot);
+        return slot;
+    }
+
+    // Table grows down into the free space
+    if (reinterpret_cast<char *>(_handles - 1) < _begin + _top) {
+        throw AllocError(AllocErrorType::NoMemory, "No space for a new handle");
+    }
+    return --_handles;
+}
+
+// See Simple.h
+Simple::Offset Simple::Resolve(void **slot) const {
+    if (slot < _handles || slot >= reinterpret_cast<void **>(_end)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(*slot);
+    uintptr_t begin = reinterpret_cast<uintptr_t>(_begin);
+    if ((address & kFreeSlot) != 0 || address < begin + sizeof(Block) || address >= begin + _top ||
+        (address - begin) % kAlign != 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer refers to the released block");
+    }
+
+    Offset offset = address - begin - sizeof(Block);
+    if (At(offset)->handle != uint32_t(reinterpret_cast<void **>(_end) - slot - 1)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer refers to the released block");
+    }
+    return offset;
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -0,0 +1,88 @@
+#include <afina/concurrency/Epoch.h>
+
+namespace Afina {
+namespace Concurrency {
+
+const size_t EpochManager::kCollectThreshold;
+
+// See Epoch.h
+EpochManager::Participant::~Participant() {
+    for (auto &r : retired) {
+        r.deleter(r.ptr);
+    }
+}
+
+// See Epoch.h
+void EpochManager::Enter() { Enter(_participants.Local()); }
+
+// See Epoch.h
+void EpochManager::Exit() { Exit(_participants.Local()); }
+
+// See Epoch.h
+void EpochManager::Enter(Participant &p) {
+    if (p.nesting++ > 0) {
+        return;
+    }
+
+    p.state.store((_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+
+    // State must be visible to whoever advances epoch before any pointer gets read in the section
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// See Epoch.h
+void EpochManager::Exit(Participant &p) {
+    if (--p.nesting == 0) {
+        p.state.store(0, std::memory_order_release);
+    }
+}
+
+// See Epoch.h
+void EpochManager::Retire(void *ptr, void (*deleter)(void *)) {
+    Participant &p = _participants.Local();
+    p.retired.push_back(Retired{ptr, deleter, _epoch.load(std::memory_order_seq_cst)});
+    if (p.retired.size() >= kCollectThreshold) {
+        Collect();
+    }
+}
+
+// See Epoch.h
+size_t EpochManager::Collect() {
+    TryAdvance();
+
+    Participant &p = _participants.Local();
+    uint64_t safe = _epoch.load(std::memory_order_acquire);
+
+    // Retired two epochs ago or earlier, nobody could see it anymore
+    size_t kept = 0;
+    for (auto &r : p.retired) {
+        if (r.epoch + 2 <= safe) {
+            r.deleter(r.ptr);
+        } else {
+            p.retired[kept++] = r;
+        }
+    }
+
+    size_t freed = p.retired.size() - kept;
+    p.retired.resize(kept);
+    return freed;
+}
+
+// See Epoch.h
+bool EpochManager::TryAdvance() {
+    uint64_t current = _epoch.load(std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool behind = false;
+    _participants.ForEach([current, &behind](Participant &p) {
+        uint64_t state = p.state.load(std::memory_order_acquire);
+        if ((state & 1) != 0 && (state >> 1) != current) {
+            behind = true;
+        }
+    });
+
+    return !behind && _epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -1,5 +1,245 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+#include <new>
+#include <pthread.h>
+#include <stdexcept>
+
+#include "InjectionQueue.h"
+#include "WorkStealingDeque.h"
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+namespace {
+
+// How many times idle worker looks around before going to sleep
+const int kIdleSpins = 64;
+
+// Creates object in memory aligned as its type requires, see Executor::AlignedDelete
+template <typename T, typename... Args> T *NewAligned(Args &&... args) {
+    void *memory = nullptr;
+    if (posix_memalign(&memory, std::max(alignof(T), sizeof(void *)), sizeof(T)) != 0) {
+        throw std::bad_alloc();
+    }
+
+    try {
+        return new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        free(memory);
+        throw;
+    }
+}
+
+} // namespace
+
+// See Executor.h
+struct Executor::Worker {
+    Worker(Executor *owner, size_t index) : executor(owner), index(index), seed(index * 0x9E3779B97F4A7C15ULL + 1) {}
+
+    inline size_t Random() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return static_cast<size_t>(seed);
+    }
+
+    Executor *executor;
+    size_t index;
+    uint64_t seed;
+    WorkStealingDeque<Task> deque;
+};
+
+// See Executor.h
+thread_local Executor::Worker *Executor::_current = nullptr;
+
+void perform(Executor *executor, Executor::Worker *worker) {
+    Executor::_current = worker;
+
+    for (;;) {
+        Executor::Task *task = nullptr;
+        for (int i = 0; i < kIdleSpins && task == nullptr; i++) {
+            task = executor->Find(*worker);
+            if (task == nullptr) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (task != nullptr) {
+            try {
+                (*task)();
+            } catch (...) {
+                // Task is responsible for its own errors, pool must survive anyway
+            }
+            delete task;
+            continue;
+        }
+
+        // Nothing to do: sleep until somebody submits task or pool is stopping
+        std::unique_lock<std::mutex> lock(executor->_mutex);
+        executor->_sleeping.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!executor->HasWork()) {
+            if (executor->state() != Executor::State::kRun && executor->_submitting.load() == 0 &&
+                !executor->HasWork()) {
+                executor->_sleeping.fetch_sub(1);
+                lock.unlock();
+
+                executor->Finished();
+                Executor::_current = nullptr;
+                return;
+            }
+            executor->_empty_condition.wait(lock);
+        }
+        executor->_sleeping.fetch_sub(1);
+        lock.unlock();
+
+        // There might be more work than this thread could take, pass wake up further
+        executor->Notify();
+    }
+}
+
+// See Executor.h
+Executor::Executor(std::string name, int size, size_t queue_size)
+    : _name(name), _injection(NewAligned<InjectionQueue<Task>>(queue_size)), _state(State::kRun), _submitting(0), _sleeping(0),
+      _running(size) {
+    if (size <= 0) {
+        throw std::invalid_argument("Executor must have at least one thread");
+    }
+
+    for (int i = 0; i < size; i++) {
+        _workers.emplace_back(NewAligned<Worker>(this, i));
+    }
+
+    _threads.reserve(size);
+    for (int i = 0; i < size; i++) {
+        _threads.emplace_back(perform, this, _workers[i].get());
+
+        // Thread name is limited by 15 chars
+        std::string thread_name = (_name + "-" + std::to_string(i));
+        if (thread_name.size() > 15) {
+            thread_name = thread_name.substr(thread_name.size() - 15);
+        }
+        pthread_setname_np(_threads.back().native_handle(), thread_name.c_str());
+    }
+}
+
+// See Executor.h
+Executor::~Executor() { Stop(true); }
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        State expected = State::kRun;
+        _state.compare_exchange_strong(expected, State::kStopping);
+        _empty_condition.notify_all();
+
+        if (!await) {
+            return;
+        }
+
+        _stop_condition.wait(lock, [this] { return _state.load() == State::kStopped; });
+    }
+
+    for (auto &thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+// See Executor.h
+bool Executor::Submit(Task task) {
+    _submitting.fetch_add(1);
+    if (state() != State::kRun) {
+        _submitting.fetch_sub(1);
+        return false;
+    }
+
+    Task *scheduled = new Task(std::move(task));
+    bool placed = true;
+    if (_current != nullptr && _current->executor == this) {
+        _current->deque.Push(scheduled);
+    } else if (!_injection->Push(scheduled)) {
+        delete scheduled;
+        placed = false;
+    }
+    _submitting.fetch_sub(1);
+
+    if (placed) {
+        Notify();
+    }
+
+    // Workers could be waiting for this call to finish in order to stop
+    if (state() != State::kRun) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _empty_condition.notify_all();
+    }
+    return placed;
+}
+
+// See Executor.h
+Executor::Task *Executor::Find(Worker &worker) {
+    Task *task = worker.deque.Take();
+    if (task != nullptr) {
+        return task;
+    }
+
+    task = _injection->Pop();
+    if (task != nullptr) {
+        return task;
+    }
+
+    // Visit victims starting from random one, so that thieves do not gang up on the same deque
+    size_t count = _workers.size();
+    size_t start = worker.Random() % count;
+    for (size_t i = 0; i < count; i++) {
+        Worker &victim = *_workers[(start + i) % count];
+        if (&victim == &worker) {
+            continue;
+        }
+
+        task = victim.deque.Steal();
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+// See Executor.h
+bool Executor::HasWork() const {
+    if (!_injection->Empty()) {
+        return true;
+    }
+
+    for (auto &worker : _workers) {
+        if (!worker->deque.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// See Executor.h
+void Executor::Notify() {
+    // Pairs with the fence of worker going to sleep: either worker sees new task or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _empty_condition.notify_one();
+    }
+}
+
+// See Executor.h
+void Executor::Finished() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (--_running == 0) {
+        _state.store(State::kStopped);
+        _stop_condition.notify_all();
+    }
+}
+
+} // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,105 @@
+#ifndef AFINA_CONCURRENCY_INJECTION_QUEUE_H
+#define AFINA_CONCURRENCY_INJECTION_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Bounded multi producer multi consumer queue
+ * Lock free FIFO over a ring of cells, each cell carries a sequence number telling whether it is
+ * ready for the producer or for the consumer of the current lap. Producers and consumers only
+ * contend on their own end of the queue.
+ *
+ * Design follows bounded MPMC queue by Dmitry Vyukov.
+ */
+template <typename T> class InjectionQueue {
+public:
+    explicit InjectionQueue(size_t capacity) : _head(0), _tail(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        _mask = size - 1;
+        _cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Adds item to the tail, returns false if queue is full
+     */
+    bool Push(T *item) {
+        size_t pos = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = _cells[pos & _mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Removes item from the head, returns nullptr if queue is empty
+     */
+    T *Pop() {
+        size_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = _cells[pos & _mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T *item = cell.item;
+                    cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return item;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Approximate check, exact only when queue is not modified concurrently
+     */
+    bool Empty() const { return _head.load(std::memory_order_acquire) >= _tail.load(std::memory_order_acquire); }
+
+private:
+    InjectionQueue(const InjectionQueue &) = delete;
+    InjectionQueue &operator=(const InjectionQueue &) = delete;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T *item;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask;
+
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_INJECTION_QUEUE_H
@@ -0,0 +1,146 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+#define AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Chase-Lev work stealing deque
+ * Owner thread pushes and takes items from the bottom end in LIFO order, any other thread could
+ * steal from the top end. Push and take are wait free unless deque has to grow or the last item is
+ * being contended, steal is lock free.
+ *
+ * Buffers replaced on growth are kept until deque is destroyed, since thieves could still read
+ * them, memory overhead is bounded by the size of the latest buffer.
+ *
+ * Implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models", Lê et al.
+ */
+template <typename T> class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 256) : _top(0), _bottom(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _buffers.emplace_back(new Buffer(size));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Owner only: adds item to the bottom
+     */
+    void Push(T *item) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(buffer->mask)) {
+            buffer = Grow(buffer, t, b);
+        }
+
+        buffer->Put(b, item);
+        _bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /**
+     * Owner only: removes item from the bottom, returns nullptr if deque is empty
+     */
+    T *Take() {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Deque was empty
+            _bottom.store(b + 1, std::memory_order_release);
+            return nullptr;
+        }
+
+        T *item = buffer->Get(b);
+        if (t == b) {
+            // The last item, race against thieves for it
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_release);
+        }
+        return item;
+    }
+
+    /**
+     * Any thread: removes item from the top, returns nullptr if deque is empty or
+     * another thread won the race for the item
+     */
+    T *Steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Buffer *buffer = _buffer.load(std::memory_order_acquire);
+        T *item = buffer->Get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * Any thread: approximate check, exact only when deque is not modified concurrently
+     */
+    bool Empty() const {
+        int64_t t = _top.load(std::memory_order_acquire);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        return t >= b;
+    }
+
+private:
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Circular array of items, size is power of two
+    struct Buffer {
+        explicit Buffer(size_t size) : mask(size - 1), items(new std::atomic<T *>[size]) {}
+
+        inline T *Get(int64_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+        inline void Put(int64_t i, T *item) { items[i & mask].store(item, std::memory_order_relaxed); }
+
+        const size_t mask;
+        std::unique_ptr<std::atomic<T *>[]> items;
+    };
+
+    // Owner only: doubles buffer copying live items
+    Buffer *Grow(Buffer *old, int64_t top, int64_t bottom) {
+        Buffer *buffer = new Buffer((old->mask + 1) * 2);
+        _buffers.emplace_back(buffer);
+        for (int64_t i = top; i < bottom; i++) {
+            buffer->Put(i, old->Get(i));
+        }
+        _buffer.store(buffer, std::memory_order_release);
+        return buffer;
+    }
+
+    // Index of the oldest item, thieves compete for it
+    alignas(64) std::atomic<int64_t> _top;
+
+    // Index after the youngest item, modified by owner only
+    alignas(64) std::atomic<int64_t> _bottom;
+    std::atomic<Buffer *> _buffer;
+
+    // All buffers ever allocated, owned by the owner thread
+    std::vector<std::unique_ptr<Buffer>> _buffers;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
@@ -0,0 +1,44 @@
+#include "Context.h"
+
+#ifdef AFINA_COROUTINE_HAVE_SWITCH
+
+// See Context.h. Stack of the suspended context from the saved pointer up:
+// [mxcsr, x87 cw] r15 r14 r13 r12 rbx rbp <return address>
+__asm__(".pushsection .text\n"
+        ".globl afina_coroutine_switch\n"
+        ".type afina_coroutine_switch,@function\n"
+        "afina_coroutine_switch:\n"
+        "    pushq %rbp\n"
+        "    pushq %rbx\n"
+        "    pushq %r12\n"
+        "    pushq %r13\n"
+        "    pushq %r14\n"
+        "    pushq %r15\n"
+        "    subq $8, %rsp\n"
+        "    stmxcsr (%rsp)\n"
+        "    fnstcw 4(%rsp)\n"
+        "    movq %rsp, (%rdi)\n"
+        "    movq %rsi, %rsp\n"
+        "    ldmxcsr (%rsp)\n"
+        "    fldcw 4(%rsp)\n"
+        "    addq $8, %rsp\n"
+        "    popq %r15\n"
+        "    popq %r14\n"
+        "    popq %r13\n"
+        "    popq %r12\n"
+        "    popq %rbx\n"
+        "    popq %rbp\n"
+        "    ret\n"
+        ".size afina_coroutine_switch, .-afina_coroutine_switch\n"
+        "\n"
+        ".globl afina_coroutine_trampoline\n"
+        ".type afina_coroutine_trampoline,@function\n"
+        "afina_coroutine_trampoline:\n"
+        "    movq %r12, %rdi\n"
+        "    movq %r13, %rsi\n"
+        "    callq *%r14\n"
+        "    ud2\n"
+        ".size afina_coroutine_trampoline, .-afina_coroutine_trampoline\n"
+        ".popsection\n");
+
+#endif // AFINA_COROUTINE_HAVE_SWITCH
@@ -0,0 +1,44 @@
+#ifndef AFINA_COROUTINE_CONTEXT_H
+#define AFINA_COROUTINE_CONTEXT_H
+
+/**
+ * # Machine level context switch
+ * Used by engine running coroutines on separate stacks. Suspended context is nothing but a stack
+ * pointer: callee saved registers, SSE/x87 control words and the return address are on the stack
+ * itself, so a switch costs a few pushes and pops regardless of how deep the stack is.
+ */
+#if defined(__x86_64__)
+#define AFINA_COROUTINE_HAVE_SWITCH
+
+extern "C" {
+
+/**
+ * Suspends current context saving its stack pointer into *from and resumes context suspended
+ * with stack pointer to. Returns once somebody switches back to the saved one
+ */
+void afina_coroutine_switch(void **from, void *to);
+
+/**
+ * First code executed on the fresh stack: calls r14(r12, r13), which must never return
+ */
+void afina_coroutine_trampoline();
+}
+
+namespace Afina {
+namespace Coroutine {
+
+// Number of bytes switch keeps on the suspended stack: six registers, control words, return address
+const unsigned kSwitchFrame = 8 * 8;
+
+// Indexes of the machine words in the frame, counting from the saved stack pointer
+enum SwitchFrame { kControlWords, kR15, kR14, kR13, kR12, kRbx, kRbp, kReturn };
+
+// Default MXCSR and x87 control word packed the way switch stores them
+const unsigned long kDefaultControlWords = 0x1F80UL | (0x037FUL << 32);
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // __x86_64__
+
+#endif // AFINA_COROUTINE_CONTEXT_H
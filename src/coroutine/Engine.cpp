@@ -1,19 +1,346 @@
 #include <afina/coroutine/Engine.h>
 
+#include <alloca.h>
 #include <setjmp.h>
+#include <stdexcept>
 #include <stdio.h>
 #include <string.h>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Context.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define AFINA_COROUTINE_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define AFINA_COROUTINE_ASAN
+#endif
+#endif
+
 namespace Afina {
 namespace Coroutine {
 
-void Engine::Store(context &ctx) {}
+namespace {
+
+// Released stacks kept for reuse at most
+const size_t kStacksCache = 64;
+
+size_t PageSize() {
+    static const size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+// Copies coroutine stack. It spans frames of other functions along with their red zones, so address
+// sanitizer must keep out of it
+__attribute__((no_sanitize_address)) void CopyStack(char *to, const char *from, size_t size) {
+#ifdef AFINA_COROUTINE_ASAN
+    // Sanitizer runtime intercepts memcpy regardless of the attribute
+    volatile char *dst = to;
+    for (size_t i = 0; i < size; i++) {
+        dst[i] = from[i];
+    }
+#else
+    memcpy(to, from, size);
+#endif
+}
+
+// Puts saved stack back in place and passes control to it, caller makes sure this frame is below the
+// area being restored
+[[noreturn]] __attribute__((noinline)) void Resume(char *low, const char *stack, size_t size, jmp_buf environment) {
+    CopyStack(low, stack, size);
+    longjmp(environment, 1);
+}
+
+} // namespace
+
+// See Engine.h
+Engine::Engine(Mode mode, size_t stack_size, std::function<void()> unblocker)
+    : StackBottom(0), cur_routine(nullptr), alive(nullptr), blocked(nullptr), idle_ctx(nullptr), _mode(mode),
+      _stack_size(stack_size), _unblocker(std::move(unblocker)), _zombie(nullptr) {
+#ifndef AFINA_COROUTINE_HAVE_SWITCH
+    if (_mode == Mode::kSeparateStack) {
+        throw std::runtime_error("Separate coroutine stacks are not supported on this platform");
+    }
+#endif
+
+    // Whole number of pages
+    _stack_size = (_stack_size + PageSize() - 1) / PageSize() * PageSize();
+}
+
+// See Engine.h
+Engine::~Engine() {
+    for (char *stack : _stacks) {
+        munmap(stack, _stack_size + PageSize());
+    }
+}
+
+// See Engine.h
+void Engine::Store(context &ctx) {
+    char StackEndsHere;
+
+    // Stack grows down, but do not assume it
+    char *low = &StackEndsHere, *high = StackBottom;
+    if (low > high) {
+        std::swap(low, high);
+    }
+
+    uint32_t size = high - low;
+    if (std::get<1>(ctx.Stack) < size) {
+        delete[] std::get<0>(ctx.Stack);
+        ctx.Stack = std::make_tuple(new char[size], size);
+    }
+
+    ctx.Low = low;
+    ctx.Hight = high;
+    CopyStack(std::get<0>(ctx.Stack), low, size);
+}
+
+// See Engine.h
+void Engine::Restore(context &ctx) {
+    char StackEndsHere;
+
+    // Frame copying the stack must be out of the area being restored, otherwise it gets overwritten.
+    // Grow the stack past the area at once, so that the frame of Resume is below it
+    if (&StackEndsHere >= ctx.Low && &StackEndsHere <= ctx.Hight) {
+        volatile char *pad = static_cast<char *>(alloca(&StackEndsHere - ctx.Low + 256));
+        pad[0] = 0;
+    }
+
+    Resume(ctx.Low, std::get<0>(ctx.Stack), ctx.Hight - ctx.Low, ctx.Environment);
+}
+
+// See Engine.h
+void Engine::yield() {
+    // Round robin: the one after current, wrapping around to the list head
+    context *next = alive;
+    if (cur_routine != nullptr && cur_routine != idle_ctx && cur_routine->next != nullptr) {
+        next = cur_routine->next;
+    } else if (next != nullptr && next == cur_routine) {
+        next = next->next;
+    }
+
+    // Nobody else is ready to run, keep going
+    if (next == nullptr) {
+        return;
+    }
+
+    Enter(*next);
+}
+
+// See Engine.h
+void Engine::sched(void *routine_) {
+    if (routine_ == nullptr) {
+        yield();
+        return;
+    }
+
+    context *routine = static_cast<context *>(routine_);
+    if (routine == cur_routine) {
+        return;
+    }
+    Enter(*routine);
+}
+
+// See Engine.h
+void Engine::block(void *routine_) {
+    context *routine = static_cast<context *>(routine_ != nullptr ? routine_ : cur_routine);
+    if (routine == nullptr || routine == idle_ctx || routine->Blocked) {
+        return;
+    }
+
+    // Where round robin would go next, before routine leaves alive list
+    context *next = routine->next != nullptr ? routine->next : alive;
+
+    Unlink(*routine);
+    Link(*routine, blocked);
+    routine->Blocked = true;
+
+    if (routine != cur_routine) {
+        return;
+    }
+
+    // Current routine can't go on, pass control to someone else. If nobody is ready idle context waits
+    // for the unblocker
+    if (next == routine) {
+        next = alive;
+    }
+    Enter(next != nullptr ? *next : *idle_ctx);
+}
+
+// See Engine.h
+void Engine::unblock(void *routine_) {
+    context *routine = static_cast<context *>(routine_);
+    if (routine == nullptr || !routine->Blocked) {
+        return;
+    }
+
+    Unlink(*routine);
+    Link(*routine, alive);
+    routine->Blocked = false;
+}
+
+// See Engine.h
+void Engine::Enter(context &ctx) {
+    if (_mode == Mode::kSeparateStack) {
+#ifdef AFINA_COROUTINE_HAVE_SWITCH
+        context *from = cur_routine != nullptr ? cur_routine : idle_ctx;
+        cur_routine = &ctx;
+        afina_coroutine_switch(&from->Sp, ctx.Sp);
+
+        // Got control back, whoever passed it has set cur_routine already
+#endif
+        return;
+    }
+
+    // Nothing to save if there is no current routine: either it is idle context which was stored
+    // once in start() or current routine is done already
+    if (cur_routine != nullptr && cur_routine != idle_ctx) {
+        if (setjmp(cur_routine->Environment) > 0) {
+            return;
+        }
+        Store(*cur_routine);
+    }
+
+    cur_routine = &ctx;
+    Restore(ctx);
+}
+
+// See Engine.h
+void Engine::Prepare(context &ctx) {
+#ifdef AFINA_COROUTINE_HAVE_SWITCH
+    char *memory = nullptr;
+    if (!_stacks.empty()) {
+        memory = _stacks.back();
+        _stacks.pop_back();
+    } else {
+        void *mapped = mmap(nullptr, _stack_size + PageSize(), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Failed to allocate coroutine stack");
+        }
+
+        // Lowest page catches stack overflow
+        memory = static_cast<char *>(mapped);
+        if (mprotect(memory, PageSize(), PROT_NONE) != 0) {
+            munmap(memory, _stack_size + PageSize());
+            throw std::runtime_error("Failed to protect coroutine stack");
+        }
+    }
+
+    ctx.Low = memory;
+    ctx.Hight = memory + PageSize() + _stack_size;
+
+    // Frame which looks like suspended by afina_coroutine_switch: it "returns" into the trampoline with
+    // properly aligned stack, which in turn calls Launch(this, &ctx)
+    uintptr_t *frame = reinterpret_cast<uintptr_t *>(ctx.Hight - kSwitchFrame);
+    memset(frame, 0, kSwitchFrame);
+    frame[kControlWords] = kDefaultControlWords;
+    frame[kR12] = reinterpret_cast<uintptr_t>(this);
+    frame[kR13] = reinterpret_cast<uintptr_t>(&ctx);
+    frame[kR14] = reinterpret_cast<uintptr_t>(&Engine::Launch);
+    frame[kReturn] = reinterpret_cast<uintptr_t>(&afina_coroutine_trampoline);
+    ctx.Sp = frame;
+#endif
+}
+
+// See Engine.h
+void Engine::Launch(Engine *engine, context *ctx) {
+    ctx->Body();
+    ctx->Body = nullptr;
+
+#ifdef AFINA_COROUTINE_HAVE_SWITCH
+    // Stack is still in use, so coroutine is released by the idle context, which gets control now
+    engine->Unlink(*ctx);
+    engine->_zombie = ctx;
+    engine->cur_routine = nullptr;
+    afina_coroutine_switch(&ctx->Sp, engine->idle_ctx->Sp);
+#endif
+}
+
+// See Engine.h
+void Engine::Serve(context *main) {
+    if (main != nullptr) {
+        Enter(*main);
+        Reap();
+    }
+
+    // Some routine has finished or blocked, pass control to others until all of them are done
+    cur_routine = idle_ctx;
+    while (Idle()) {
+        yield();
+        Reap();
+        cur_routine = idle_ctx;
+    }
+}
+
+// See Engine.h
+bool Engine::Idle() {
+    while (alive == nullptr && blocked != nullptr && _unblocker) {
+        _unblocker();
+    }
+    return alive != nullptr;
+}
+
+// See Engine.h
+void Engine::Reap() {
+    if (_zombie == nullptr) {
+        return;
+    }
+
+    if (_stacks.size() < kStacksCache) {
+        _stacks.push_back(_zombie->Low);
+    } else {
+        munmap(_zombie->Low, _stack_size + PageSize());
+    }
+
+    delete _zombie;
+    _zombie = nullptr;
+}
+
+// See Engine.h
+void Engine::Shutdown() {
+    while (blocked != nullptr) {
+        context *ctx = blocked;
+        Unlink(*ctx);
+        if (_mode == Mode::kSeparateStack) {
+            // Stack goes back to the cache the same way as of the finished one
+            _zombie = ctx;
+            Reap();
+        } else {
+            delete ctx;
+        }
+    }
+}
+
+// See Engine.h
+void Engine::Unlink(context &ctx) {
+    if (ctx.prev != nullptr) {
+        ctx.prev->next = ctx.next;
+    }
 
-void Engine::Restore(context &ctx) {}
+    if (ctx.next != nullptr) {
+        ctx.next->prev = ctx.prev;
+    }
 
-void Engine::yield() {}
+    if (alive == &ctx) {
+        alive = ctx.next;
+    } else if (blocked == &ctx) {
+        blocked = ctx.next;
+    }
+    ctx.prev = ctx.next = nullptr;
+}
 
-void Engine::sched(void *routine_) {}
+// See Engine.h
+void Engine::Link(context &ctx, context *&list) {
+    ctx.prev = nullptr;
+    ctx.next = list;
+    if (list != nullptr) {
+        list->prev = &ctx;
+    }
+    list = &ctx;
+}
 
 } // namespace Coroutine
 } // namespace Afina
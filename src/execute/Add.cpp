@@ -1,7 +1,8 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Add.h>
 
-#include <iostream>
+#include "Trace.h"
 
 namespace Afina {
 namespace Execute {
@@ -9,8 +10,15 @@ namespace Execute {
 // memcached protocol:  "add" means "store this data, but only if the server *doesn't* already
 // hold data for this key".
 void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Add(" << _key << ")" << args << std::endl;
-    out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
+    Statistics::Add(Statistics::kCmdSet);
+    TRACE_COMMAND("Add({}): {} bytes", _key, args.size());
+    uint32_t expire;
+    if (!ttl(expire)) {
+        std::string value;
+        out = storage.Get(_key, value) ? "NOT_STORED" : "STORED";
+        return;
+    }
+    out = storage.PutIfAbsent(_key, args, expire) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
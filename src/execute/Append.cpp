@@ -1,20 +1,26 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
 
-#include <iostream>
+#include "Trace.h"
 
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Append(" << _key << ")" << args << std::endl;
+    Statistics::Add(Statistics::kCmdSet);
+    TRACE_COMMAND("Append({}): {} bytes", _key, args.size());
     std::string value;
     if (!storage.Get(_key, value)) {
         out.assign("NOT_STORED");
         return;
     }
-    storage.Put(_key, value + args);
+    // Appended data doesn't change expiration, it isn't part of the command
+    if (!storage.Set(_key, value + args, Storage::kKeepTTL)) {
+        out.assign("NOT_STORED");
+        return;
+    }
     out.assign("STORED");
 }
 
@@ -0,0 +1,15 @@
+#include <afina/execute/ClientError.h>
+
+#include "Trace.h"
+
+namespace Afina {
+namespace Execute {
+
+// See ClientError.h
+void ClientError::Execute(Storage &, const std::string &, std::string &out) {
+    TRACE_COMMAND("ClientError: {}", _message);
+    out = "CLIENT_ERROR " + _message;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1 +1,23 @@
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include <spdlog/logger.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+std::shared_ptr<spdlog::logger> Command::_logger;
+
+// See Command.h
+void Command::SetLogger(std::shared_ptr<spdlog::logger> logger) { _logger = std::move(logger); }
+
+// See Command.h
+void Command::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::string result;
+    Execute(storage, args, result);
+    out.Append(result);
+}
+
+} // namespace Execute
+} // namespace Afina
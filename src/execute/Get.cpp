@@ -1,10 +1,12 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
 
-#include <iostream>
-#include <iterator>
 #include <sstream>
 
+#include "Trace.h"
+
 namespace Afina {
 namespace Execute {
 
@@ -22,16 +24,18 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
-
     std::stringstream outStream;
 
+    Statistics::Add(Statistics::kCmdGet, _keys.size());
     std::string value;
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+        if (!storage.Get(key, value)) {
+            TRACE_COMMAND("Get({}): miss", key);
+            Statistics::Add(Statistics::kGetMisses);
             continue;
+        }
+        TRACE_COMMAND("Get({}): {} bytes", key, value.size());
+        Statistics::Add(Statistics::kGetHits);
         outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
         outStream << value << "\r\n";
     }
@@ -40,5 +44,38 @@ void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
     out = outStream.str();
 }
 
+void Get::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::vector<const std::string *> keys;
+    keys.reserve(_keys.size());
+    for (auto &key : _keys) {
+        keys.push_back(&key);
+    }
+
+    std::vector<SharedValue> values;
+    storage.GetSharedMany(keys, values);
+    Respond(values.data(), out);
+}
+
+void Get::Respond(const SharedValue *values, Response &out) const {
+    Statistics::Add(Statistics::kCmdGet, _keys.size());
+    for (size_t i = 0; i < _keys.size(); i++) {
+        const std::string &key = _keys[i];
+        if (!values[i]) {
+            TRACE_COMMAND("Get({}): miss", key);
+            Statistics::Add(Statistics::kGetMisses);
+            continue;
+        }
+        TRACE_COMMAND("Get({}): {} bytes", key, values[i]->size());
+        Statistics::Add(Statistics::kGetHits);
+
+        out.Append("VALUE ");
+        out.Append(key);
+        out.Append(" 0 " + std::to_string(values[i]->size()) + "\r\n");
+        out.Append(values[i]);
+        out.Append("\r\n", 2);
+    }
+    out.Append("END", 3); // networking layer should add the last \r\n
+}
+
 } // namespace Execute
 } // namespace Afina
@@ -0,0 +1,36 @@
+#include <afina/execute/InsertCommand.h>
+
+#include <ctime>
+
+namespace Afina {
+namespace Execute {
+
+namespace {
+
+// Biggest expiration time memcached treats as relative, 30 days
+const int32_t kMaxRelativeExpire = 60 * 60 * 24 * 30;
+
+} // namespace
+
+// See InsertCommand.h
+bool InsertCommand::ttl(uint32_t &out) const {
+    if (_expire < 0) {
+        return false;
+    }
+
+    if (_expire <= kMaxRelativeExpire) {
+        out = static_cast<uint32_t>(_expire);
+        return true;
+    }
+
+    std::time_t now = std::time(nullptr);
+    if (_expire <= now) {
+        return false;
+    }
+
+    out = static_cast<uint32_t>(_expire - now);
+    return true;
+}
+
+} // namespace Execute
+} // namespace Afina
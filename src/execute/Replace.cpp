@@ -1,7 +1,8 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Replace.h>
 
-#include <iostream>
+#include "Trace.h"
 
 namespace Afina {
 namespace Execute {
@@ -10,14 +11,14 @@ namespace Execute {
 // already hold data for this key".
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Replace(" << _key << "): " << args << std::endl;
-    std::string value;
-    if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
-        out = "STORED";
-    } else {
-        out = "NOT_STORED";
+    Statistics::Add(Statistics::kCmdSet);
+    TRACE_COMMAND("Replace({}): {} bytes", _key, args.size());
+    uint32_t expire;
+    if (!ttl(expire)) {
+        out = storage.Delete(_key) ? "STORED" : "NOT_STORED";
+        return;
     }
+    out = storage.Set(_key, args, expire) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
@@ -0,0 +1,48 @@
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Response.h
+void Response::Append(const char *data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    if (_segments.empty() || _segments.back().value) {
+        _segments.emplace_back();
+    }
+    _segments.back().text.append(data, size);
+}
+
+// See Response.h
+void Response::Append(SharedValue value) {
+    if (!value || value->empty()) {
+        return;
+    }
+
+    _segments.emplace_back();
+    _segments.back().value = std::move(value);
+}
+
+// See Response.h
+size_t Response::size() const {
+    size_t result = 0;
+    for (auto &segment : _segments) {
+        result += segment.size();
+    }
+    return result;
+}
+
+// See Response.h
+std::string Response::str() const {
+    std::string result;
+    result.reserve(size());
+    for (auto &segment : _segments) {
+        result.append(segment.data(), segment.size());
+    }
+    return result;
+}
+
+} // namespace Execute
+} // namespace Afina
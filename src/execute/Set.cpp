@@ -1,15 +1,23 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Set.h>
 
-#include <iostream>
+#include "Trace.h"
 
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
+    Statistics::Add(Statistics::kCmdSet);
+    TRACE_COMMAND("Set({}): {} bytes", _key, args.size());
+    uint32_t expire;
+    if (!ttl(expire)) {
+        // Already expired item is stored and dropped immediately
+        storage.Delete(_key);
+    } else {
+        storage.Put(_key, args, expire);
+    }
     out = "STORED";
 }
 
@@ -1,14 +1,59 @@
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Stats.h>
 
-#include <iostream>
-#include <iterator>
+#include <ctime>
 #include <sstream>
 
+#include <unistd.h>
+
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+/* memcached protocol:
+
+Each statistics item is sent by the server as a line:
+
+STAT <name> <value>\r\n
+
+After all the items have been transmitted, the server sends the string
+"END\r\n"
+to indicate the end of response.
+
+*/
+
+// See Stats.h
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::stringstream outStream;
+    outStream << "STAT pid " << getpid() << "\r\n";
+    outStream << "STAT uptime " << Statistics::Uptime() << "\r\n";
+    outStream << "STAT time " << std::time(nullptr) << "\r\n";
+    outStream << "STAT pointer_size " << 8 * sizeof(void *) << "\r\n";
+
+    const struct {
+        const char *name;
+        Statistics::Counter counter;
+    } counters[] = {
+        {"curr_connections", Statistics::kCurrConnections},
+        {"total_connections", Statistics::kTotalConnections},
+        {"cmd_get", Statistics::kCmdGet},
+        {"cmd_set", Statistics::kCmdSet},
+        {"get_hits", Statistics::kGetHits},
+        {"get_misses", Statistics::kGetMisses},
+    };
+    for (auto &c : counters) {
+        outStream << "STAT " << c.name << " " << Statistics::Get(c.counter) << "\r\n";
+    }
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    outStream << "STAT bytes " << bytes << "\r\n";
+    outStream << "STAT curr_items " << items << "\r\n";
+    outStream << "STAT evictions " << Statistics::Get(Statistics::kEvictions) << "\r\n";
+    outStream << "END"; // networking layer should add the last \r\n
+
+    out = outStream.str();
+}
 
 } // namespace Execute
 } // namespace Afina
@@ -0,0 +1,25 @@
+#ifndef AFINA_EXECUTE_TRACE_H
+#define AFINA_EXECUTE_TRACE_H
+
+#include <spdlog/logger.h>
+
+/**
+ * Traces execution of the command to the logger set by Command::SetLogger. Arguments are formatted
+ * only if trace level is enabled for the logger. Build with EXECUTE_TRACE=OFF has no tracing at all.
+ *
+ * Only keys and sizes are traced, values could carry sensitive data
+ */
+#ifdef AFINA_EXECUTE_NO_TRACE
+#define TRACE_COMMAND(...)                                                                                             \
+    do {                                                                                                               \
+    } while (0)
+#else
+#define TRACE_COMMAND(...)                                                                                             \
+    do {                                                                                                               \
+        if (_logger && _logger->should_log(spdlog::level::trace)) {                                                    \
+            _logger->trace(__VA_ARGS__);                                                                               \
+        }                                                                                                              \
+    } while (0)
+#endif
+
+#endif // AFINA_EXECUTE_TRACE_H
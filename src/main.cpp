@@ -9,8 +9,10 @@
 
 #include <cxxopts.hpp>
 
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
@@ -18,10 +20,21 @@
 #include "network/mt_blocking/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
-
+#ifdef AFINA_HAVE_IO_URING
+#include "network/uring/ServerImpl.h"
+#endif
+
+#include "storage/ARC.h"
+#include "storage/ClockLRU.h"
+#include "storage/EpochLRU.h"
+#include "storage/FlatCombineLRU.h"
+#include "storage/HashLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -54,6 +67,20 @@ public:
             storage = std::make_shared<Afina::Backend::SimpleLRU>();
         } else if (storage_type == "mt_lru") {
             storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+        } else if (storage_type == "hash_lru") {
+            storage = std::make_shared<Afina::Backend::HashLRU>();
+        } else if (storage_type == "striped_lru") {
+            storage = std::make_shared<Afina::Backend::StripedLRU>();
+        } else if (storage_type == "fc_lru") {
+            storage = std::make_shared<Afina::Backend::FlatCombineLRU>();
+        } else if (storage_type == "clock_lru") {
+            storage = std::make_shared<Afina::Backend::ClockLRU>();
+        } else if (storage_type == "epoch_lru") {
+            storage = std::make_shared<Afina::Backend::EpochLRU>();
+        } else if (storage_type == "arc") {
+            storage = std::make_shared<Afina::Backend::ARC>();
+        } else if (storage_type == "tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>();
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -64,14 +91,27 @@ public:
             network_type = options["network"].as<std::string>();
         }
 
+        // Pin network threads to cores, if implementation supports it
+        bool pin = options.count("pin") > 0;
+
         if (network_type == "st_block") {
             server = std::make_shared<Afina::Network::STblocking::ServerImpl>(storage, logService);
         } else if (network_type == "mt_block") {
             server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService);
         } else if (network_type == "st_nonblock") {
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
+        } else if (network_type == "st_coroutine") {
+            server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
-            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::kShared, pin);
+        } else if (network_type == "mt_nonblock_reuseport") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::kReusePort, pin);
+#ifdef AFINA_HAVE_IO_URING
+        } else if (network_type == "uring") {
+            server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
+#endif
         } else {
             throw std::runtime_error("Unknown network type");
         }
@@ -83,6 +123,10 @@ public:
         auto log = logService->select("root");
         log->warn("Start afina server {}", Afina::get_version());
 
+        // Uptime is counted from the first access to statistics
+        Afina::Statistics::Instance();
+        Afina::Execute::Command::SetLogger(logService->select("execute"));
+
         log->warn("Start storage");
         storage->Start();
 
@@ -129,6 +173,7 @@ int main(int argc, char **argv) {
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("pin", "Pin network worker threads to cores");
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
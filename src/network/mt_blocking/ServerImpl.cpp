@@ -17,6 +17,7 @@
 
 #include <spdlog/logger.h>
 
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
@@ -157,6 +158,8 @@ void ServerImpl::OnRun() {
 
 void ServerImpl::Process_protocol(int client_socket) {
     _logger->debug("Started new thread");
+    Statistics::Add(Statistics::kCurrConnections);
+    Statistics::Add(Statistics::kTotalConnections);
 
     std::size_t arg_remains;
     Protocol::Parser parser;
@@ -256,6 +259,7 @@ void ServerImpl::Process_protocol(int client_socket) {
     connections[client_socket].detach();
     connections.erase(client_socket);
     close(client_socket);
+    Statistics::Add(Statistics::kCurrConnections, -1);
 
     if (connections.empty()) {
         cv.notify_one();
@@ -1,6 +1,8 @@
 #include "Connection.h"
 
 #include <iostream>
+#include <algorithm>
+#include <climits>
 #include <cstring>
 #include <vector>
 
@@ -11,6 +13,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <sys/epoll.h>
@@ -18,6 +21,8 @@
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
@@ -26,12 +31,13 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+const std::size_t Connection::kReadSize;
+
 // See Connection.h
     void Connection::Start() {
         //Logger section
         _logger->info("Start mt_nonblocking network service");
 
-        std::unique_lock<std::mutex> lock(mutex);
         _state = 0;
 
         _event.events = EPOLLIN | EPOLLRDHUP | EPOLLPRI;
@@ -43,6 +49,7 @@ namespace MTnonblock {
 
         _written_amount = 0;
         _results.clear();
+        _pending.clear();
     }
 
 // See Connection.h
@@ -50,7 +57,6 @@ namespace MTnonblock {
         //Logger section
         _logger->error("Connection error");
 
-        std::unique_lock<std::mutex> lock(mutex);
         _state = 1;
         _results.clear();
     }
@@ -60,33 +66,40 @@ namespace MTnonblock {
         //Logger section
         _logger->debug("Closing connection");
 
-        std::unique_lock<std::mutex> lock(mutex);
         _state = 2;
         _results.clear();
     }
 
 // See Connection.h
-    void Connection::DoRead() {
+    void Connection::DoRead(BufferPool &pool) {
         //Logger section
         _logger->debug("DoRead");
-        std::unique_lock<std::mutex> lock(mutex);
         try {
             int readed_bytes = -1;
-            while ((readed_bytes = read(_socket, client_buffer + already_read,
-                                        sizeof(client_buffer) - already_read)) > 0) {
+            for (;;) {
+                // Argument being read could get room for all of it at once
+                std::size_t room = 0;
+                char *to = _buffer.Reserve(pool, std::max(kReadSize, arg_remains), room);
+                if (room == 0) {
+                    throw std::runtime_error("Request doesn't fit read buffer");
+                }
+
+                if ((readed_bytes = read(_socket, to, room)) <= 0) {
+                    break;
+                }
                 _logger->debug("Got {} bytes from socket", readed_bytes);
-                already_read += readed_bytes;
+                _buffer.Commit(readed_bytes);
 
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
                 // for example:
                 // - read#0: [<command1 start>]
                 // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-                while (readed_bytes > 0) {
-                    _logger->debug("Process {} bytes", readed_bytes);
+                while (!_buffer.empty()) {
+                    _logger->debug("Process {} bytes", _buffer.size());
                     // There is no command yet
                     if (!command_to_execute) {
                         std::size_t parsed = 0;
-                        if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                        if (parser.Parse(_buffer.data(), _buffer.size(), parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -101,108 +114,181 @@ namespace MTnonblock {
                         if (parsed == 0) {
                             break;
                         } else {
-                            std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                            readed_bytes -= parsed;
+                            _buffer.Consume(parsed);
                         }
                     }
 
                     // There is command, but we still wait for argument to arrive...
                     if (command_to_execute && arg_remains > 0) {
-                        _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
+                        _logger->debug("Fill argument: {} bytes of {}", _buffer.size(), arg_remains);
                         // There is some parsed command, and now we are reading argument
-                        std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                        argument_for_command.append(client_buffer, to_read);
+                        std::size_t to_read = std::min(arg_remains, _buffer.size());
+                        argument_for_command.append(_buffer.data(), to_read);
 
-                        std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+                        _buffer.Consume(to_read);
                         arg_remains -= to_read;
-                        readed_bytes -= to_read;
                     }
 
-                    // Thre is command & argument - RUN!
+                    // Thre is command & argument - put it aside until the whole buffer is parsed
                     if (command_to_execute && arg_remains == 0) {
-                        _logger->debug("Start command execution");
-
-                        std::string result;
-
-                        try {
-                            command_to_execute->Execute(*pStorage, argument_for_command, result);
-                        } catch (std::runtime_error &ex) {
-                            result = "SERVER_ERROR ";
-                            result += strerror(errno);
+                        if (argument_for_command.size() >= 2) {
+                            argument_for_command.resize(argument_for_command.size() - 2);
                         }
-
-                        // Send response
-                        result += "\r\n";
-                        _results.push_back(result);
+                        _pending.push_back(Pending{std::move(command_to_execute), std::move(argument_for_command)});
 
                         // Prepare for the next command
                         command_to_execute.reset();
-                        argument_for_command.resize(0);
+                        argument_for_command.clear();
                         parser.Reset();
-
-                        if (_results.size() == 1) {
-                            _event.events |= EPOLLOUT);
-                        }
                     }
-                } // while (readed_bytes)
+                } // while (!_buffer.empty())
+
+                // Pipelined commands of the whole read are executed at once, responses go out in one write
+                if (!_pending.empty()) {
+                    _logger->debug("Execute {} commands", _pending.size());
+                    ExecutePending();
+                    if (!_results.empty()) {
+                        _event.events |= EPOLLOUT;
+                    }
+                }
             }
 
-            if (readed_bytes <= 0) {
-                if  (errno != EAGAIN) {
-                    throw std::runtime_error(strerror(errno));
-                }
+            if (readed_bytes == 0) {
+                _logger->debug("Connection closed");
+                _state = 2;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw std::runtime_error(strerror(errno));
             }
         } catch (std::runtime_error &ex) {
             _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+            _state = 1;
         }
+
+        // Everything is parsed, memory goes back to the worker until there is something to read again
+        _buffer.Release(pool);
     }
 
 // See Connection.h
-    void Connection::DoWrite() {
-        std::unique_lock<std::mutex> lock(mutex);
-        //Logger section
-        _logger->debug("Do write");
-        size_t to_be_written = _results.size();
+    void Connection::ExecutePending() {
+        for (size_t i = 0; i < _pending.size();) {
+            // Run of get commands, their keys are looked up together
+            size_t end = i;
+            _batch_keys.clear();
+            for (; end < _pending.size(); end++) {
+                auto get = dynamic_cast<Execute::Get *>(_pending[end].command.get());
+                if (get == nullptr) {
+                    break;
+                }
+                for (auto &key : get->keys()) {
+                    _batch_keys.push_back(&key);
+                }
+            }
 
-        struct iovec iovector[to_be_written];
+            if (end > i) {
+                bool failed = false;
+                std::string error;
+                try {
+                    pStorage->GetSharedMany(_batch_keys, _batch_values);
+                } catch (std::runtime_error &ex) {
+                    failed = true;
+                    error = std::string("SERVER_ERROR ") + ex.what();
+                }
 
-        size_t i = 0;
-        auto it = _results.begin();
+                size_t offset = 0;
+                for (; i < end; i++) {
+                    auto get = static_cast<Execute::Get *>(_pending[i].command.get());
+                    Execute::Response response;
+                    if (failed) {
+                        response.Append(error);
+                    } else {
+                        get->Respond(_batch_values.data() + offset, response);
+                    }
+                    offset += get->keys().size();
 
-        iovector[i].iov_base = (void *) (it->c_str());
-        iovector[i].iov_len = it->size();
+                    response.Append("\r\n", 2);
+                    Queue(response);
+                }
+                continue;
+            }
 
-        i++;
-        it++;
+            _logger->debug("Start command execution");
+            Execute::Response response;
+            try {
+                _pending[i].command->Execute(*pStorage, _pending[i].argument, response);
+            } catch (std::runtime_error &ex) {
+                response = Execute::Response();
+                response.Append(std::string("SERVER_ERROR ") + ex.what());
+            }
 
-        for (it < _results.end(); it++) {
-            iovector[i].iov_base = (void *) (it->c_str() + _written_amount);
-            iovector[i].iov_len = it->size() - _written_amount;
+            // Send response, values stay in the storage buffers
+            response.Append("\r\n", 2);
+            Queue(response);
             i++;
         }
 
-        int written = write(_socket, iovector, to_be_written);
-        if (written == -1) {
-            _logger->error("Failed to write response to client: {}", strerror(-1));
-            OnError();
-        } else {
-            int current_amount = 0;
-            auto to_be_deleted = _results.begin();
+        // Values are referenced from the responses now
+        _pending.clear();
+        _batch_keys.clear();
+        _batch_values.clear();
+    }
 
-            for (to_be_deleted < _results.end(); to_be_deleted++) {
-                if ((current_amount + to_be_deleted->size()) > written) {
-                    _written_amount = written - current_amount;
-                    break;
-                }
-                else {
-                    current_amount += to_be_deleted->size();
+// See Connection.h
+    void Connection::Queue(Execute::Response &response) {
+        for (auto &segment : response.segments()) {
+            // Text is merged into the text queued before, write is synchronous so nothing references it
+            if (!segment.value && !_results.empty() && !_results.back().value) {
+                _results.back().text += segment.text;
+            } else {
+                _results.push_back(std::move(segment));
+            }
+        }
+    }
+
+// See Connection.h
+    void Connection::DoWrite() {
+        //Logger section
+        _logger->debug("Do write");
+        // Keep writing until socket is full, edge triggered epoll reports writability only after that
+        while (!_results.empty()) {
+            size_t to_be_written = std::min(_results.size(), size_t(IOV_MAX));
+
+            std::vector<struct iovec> iovector(to_be_written);
+            size_t requested = 0;
+            for (size_t i = 0; i < to_be_written; i++) {
+                iovector[i].iov_base = (void *) (_results[i].data());
+                iovector[i].iov_len = _results[i].size();
+                requested += _results[i].size();
+            }
+
+            // First response could be partially written already
+            iovector[0].iov_base = (void *) (_results[0].data() + _written_amount);
+            iovector[0].iov_len -= _written_amount;
+            requested -= _written_amount;
+
+            ssize_t written = writev(_socket, iovector.data(), to_be_written);
+            if (written == -1) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    _logger->error("Failed to write response to client: {}", strerror(errno));
+                    _state = 1;
+                    _results.clear();
                 }
+                break;
             }
 
+            bool partial = size_t(written) < requested;
+            written += _written_amount;
+            auto to_be_deleted = _results.begin();
+            for (; to_be_deleted != _results.end() && size_t(written) >= to_be_deleted->size(); to_be_deleted++) {
+                written -= to_be_deleted->size();
+            }
+
+            _written_amount = written;
             _results.erase(_results.begin(), to_be_deleted);
+            if (partial) {
+                break;
+            }
         }
 
-
         if (_results.empty()) {
             _event.events = ((EPOLLIN | EPOLLRDHUP) | EPOLLPRI);
         }
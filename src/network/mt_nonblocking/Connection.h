@@ -2,27 +2,43 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
 #include <cstring>
+#include <deque>
 #include <vector>
 
 #include <sys/epoll.h>
 #include <spdlog/logger.h>
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 #include "protocol/Parser.h"
 
+#include "ReadBuffer.h"
+
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+/**
+ * # Client connection of epoll based server
+ * Connection is never processed by two threads at once: in shared mode it is registered with EPOLLONESHOT
+ * and gets rearmed only after processing is done, in listening mode it belongs to the single worker, so
+ * there is no lock inside
+ */
 class Connection {
 public:
     Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> l) : _socket(s),
-                                                                                               pStorage(ps), _logger(l) {
+                                                                                               pStorage(ps), _logger(l),
+                                                                                               arg_remains(0) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
+        Statistics::Add(Statistics::kCurrConnections);
+        Statistics::Add(Statistics::kTotalConnections);
     }
 
+    ~Connection() { Statistics::Add(Statistics::kCurrConnections, -1); }
+
     inline bool isAlive() const { return (_state == 0); }
 
     void Start();
@@ -30,9 +46,17 @@ public:
 protected:
     void OnError();
     void OnClose();
-    void DoRead();
+    // Read buffer is taken from the pool of the worker serving connection now
+    void DoRead(BufferPool &pool);
     void DoWrite();
 
+    // Puts response to the end of the output queue
+    void Queue(Execute::Response &response);
+
+    // Executes commands parsed out of the last read and queues their responses. Keys of consecutive get
+    // commands are looked up by a single storage call
+    void ExecutePending();
+
 private:
     friend class Worker;
     friend class ServerImpl;
@@ -44,7 +68,6 @@ private:
     // 1 — error
     // 2 — dead
     int _state;
-    std::mutex mutex;
 
     std::shared_ptr<spdlog::logger> _logger;
     std::shared_ptr<Afina::Storage> pStorage;
@@ -56,12 +79,26 @@ private:
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
 
+    // Commands read completely along with their arguments, executed as a batch once read buffer is parsed
+    struct Pending {
+        std::unique_ptr<Execute::Command> command;
+        std::string argument;
+    };
+    std::vector<Pending> _pending;
+
+    // Keys of the get commands batch and their values, kept to reuse memory
+    std::vector<const std::string *> _batch_keys;
+    std::vector<SharedValue> _batch_values;
+
     // Writing related
-    std::vector<std::string> _results;
+    std::deque<Execute::Response::Segment> _results;
     int _written_amount;
 
-    int already_read;
-    char client_buffer[4096];
+    // Bytes read but not parsed yet, holds no memory while connection is idle
+    ReadBuffer _buffer;
+
+    // Room asked for each read, unless argument being read needs more
+    static const std::size_t kReadSize = 4096;
 };
 
 } // namespace MTnonblock
@@ -0,0 +1,94 @@
+#include "ReadBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+const size_t BufferPool::kBufferSize;
+const size_t BufferPool::kMaxPooled;
+const size_t ReadBuffer::kMaxSize;
+
+// See ReadBuffer.h
+BufferPool::~BufferPool() {
+    for (char *buffer : _free) {
+        delete[] buffer;
+    }
+}
+
+// See ReadBuffer.h
+char *BufferPool::Acquire() {
+    if (_free.empty()) {
+        return new char[kBufferSize];
+    }
+
+    char *buffer = _free.back();
+    _free.pop_back();
+    return buffer;
+}
+
+// See ReadBuffer.h
+void BufferPool::Release(char *buffer) {
+    if (_free.size() < kMaxPooled) {
+        _free.push_back(buffer);
+    } else {
+        delete[] buffer;
+    }
+}
+
+// See ReadBuffer.h
+char *ReadBuffer::Reserve(BufferPool &pool, size_t want, size_t &room) {
+    if (_data == nullptr) {
+        _data = pool.Acquire();
+        _capacity = BufferPool::kBufferSize;
+    }
+
+    size_t size = _end - _begin;
+    want = std::min(want, kMaxSize - std::min(size, kMaxSize));
+
+    // Move data to the beginning only once there is not enough room at the end
+    if (_capacity - _end < want && _begin > 0) {
+        std::memmove(_data, _data + _begin, size);
+        _begin = 0;
+        _end = size;
+    }
+
+    if (_capacity - _end < want) {
+        size_t capacity = std::min(kMaxSize, std::max(2 * _capacity, size + want));
+        char *data = new char[capacity];
+        std::memcpy(data, _data + _begin, size);
+        Free(pool);
+
+        _data = data;
+        _capacity = capacity;
+        _begin = 0;
+        _end = size;
+    }
+
+    room = _capacity - _end;
+    return _data + _end;
+}
+
+// See ReadBuffer.h
+void ReadBuffer::Release(BufferPool &pool) {
+    if (_data != nullptr && empty()) {
+        Free(pool);
+        _data = nullptr;
+        _capacity = _begin = _end = 0;
+    }
+}
+
+// See ReadBuffer.h
+void ReadBuffer::Free(BufferPool &pool) {
+    if (_capacity == BufferPool::kBufferSize) {
+        pool.Release(_data);
+    } else {
+        delete[] _data;
+    }
+}
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
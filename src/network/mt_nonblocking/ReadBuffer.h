@@ -0,0 +1,112 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_READ_BUFFER_H
+#define AFINA_NETWORK_MT_NONBLOCKING_READ_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+/**
+ * # Free read buffers of a worker
+ * Buffers of the standard size released by idle connections, ready to be taken by the next connection
+ * which has something to read. Used by the worker thread only, so there is no lock inside
+ */
+class BufferPool {
+public:
+    // Size of the buffer connection gets from the pool
+    static const size_t kBufferSize = 16 * 1024;
+
+    // Free buffers kept at most, the rest are returned to the system
+    static const size_t kMaxPooled = 256;
+
+    BufferPool() {}
+    ~BufferPool();
+
+    /**
+     * Buffer of kBufferSize bytes, reused one if there is any
+     */
+    char *Acquire();
+
+    /**
+     * Gives buffer of kBufferSize bytes back
+     */
+    void Release(char *buffer);
+
+private:
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    std::vector<char *> _free;
+};
+
+/**
+ * # Connection read buffer
+ * Bytes read from the socket and not parsed yet. Parsed bytes are consumed by moving the start offset,
+ * the rest is moved to the beginning only when there is no room left at the end, so processing of a long
+ * pipeline costs a single move per read rather than per command.
+ *
+ * Memory comes from the pool of the worker when connection has something to read and goes back once
+ * everything is parsed, so idle connection holds no buffer at all. Buffer grows beyond the standard size
+ * when connection asks for more room at once, for example to read a large value with fewer syscalls,
+ * such buffer is returned to the system rather than to the pool
+ */
+class ReadBuffer {
+public:
+    // Buffer never grows beyond this size
+    static const size_t kMaxSize = 1024 * 1024;
+
+    ReadBuffer() : _data(nullptr), _capacity(0), _begin(0), _end(0) {}
+    ~ReadBuffer() { delete[] _data; }
+
+    inline const char *data() const { return _data + _begin; }
+    inline size_t size() const { return _end - _begin; }
+    inline bool empty() const { return _begin == _end; }
+
+    /**
+     * Drops given number of bytes from the beginning of the data
+     */
+    inline void Consume(size_t count) {
+        _begin += count;
+        if (_begin == _end) {
+            _begin = _end = 0;
+        }
+    }
+
+    /**
+     * Makes room for at least want bytes after the data, as long as buffer size limit allows, taking
+     * memory from the pool if there is none yet. Returns where to put new bytes, room gets their number
+     */
+    char *Reserve(BufferPool &pool, size_t want, size_t &room);
+
+    /**
+     * Appends given number of bytes written to the room returned by Reserve
+     */
+    inline void Commit(size_t count) { _end += count; }
+
+    /**
+     * Gives memory back if there is no data in it
+     */
+    void Release(BufferPool &pool);
+
+private:
+    ReadBuffer(const ReadBuffer &) = delete;
+    ReadBuffer &operator=(const ReadBuffer &) = delete;
+
+    // Returns memory to where it comes from
+    void Free(BufferPool &pool);
+
+    char *_data;
+    size_t _capacity;
+
+    // Data lives in [_begin, _end)
+    size_t _begin;
+    size_t _end;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_READ_BUFFER_H
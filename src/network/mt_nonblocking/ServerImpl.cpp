@@ -30,7 +30,8 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode, bool pin)
+    : Server(ps, pl), _mode(mode), _pin(pin), _server_socket(-1), _data_epoll_fd(-1), _event_fd(-1) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -47,6 +48,16 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
+    // Workers accept connections by themselves, there is nothing shared to setup
+    if (_mode == Mode::kReusePort) {
+        _workers.reserve(n_workers);
+        for (uint32_t i = 0; i < n_workers; i++) {
+            _workers.emplace_back(pStorage, pLogging);
+            _workers.back().Listen(port, WorkerCpu(i));
+        }
+        return;
+    }
+
     // Create server socket
     struct sockaddr_in server_addr;
     std::memset(&server_addr, 0, sizeof(server_addr));
@@ -71,7 +82,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, SOMAXCONN) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
@@ -97,7 +108,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
         _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+        _workers.back().Start(_data_epoll_fd, WorkerCpu(i));
     }
 
     // Start acceptors
@@ -116,7 +127,7 @@ void ServerImpl::Stop() {
     }
 
     // Wakeup threads that are sleep on epoll_wait
-    if (eventfd_write(_event_fd, 1)) {
+    if (_event_fd != -1 && eventfd_write(_event_fd, 1)) {
         throw std::runtime_error("Failed to wakeup workers");
     }
 
@@ -137,6 +148,15 @@ void ServerImpl::Join() {
     }
 }
 
+// See ServerImpl.h
+int ServerImpl::WorkerCpu(uint32_t i) const {
+    unsigned cores = std::thread::hardware_concurrency();
+    if (!_pin || cores == 0) {
+        return -1;
+    }
+    return i % cores;
+}
+
 // See ServerImpl.h
 void ServerImpl::OnRun() {
     _logger->info("Start acceptor");
@@ -25,7 +25,21 @@ class Worker;
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    enum class Mode {
+        // Acceptors share single server socket and put connections into epoll shared by all workers
+        kShared,
+
+        // Each worker has own listening socket bound with SO_REUSEPORT and own epoll, connections
+        // never leave worker which accepted them
+        kReusePort
+    };
+
+    /**
+     * @param mode how connections are distributed between workers
+     * @param pin if true workers are pinned to cores round robin
+     */
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode = Mode::kShared,
+               bool pin = false);
     ~ServerImpl();
 
     // See Server.h
@@ -42,6 +56,12 @@ protected:
     void OnNewConnection();
 
 private:
+    // Core to pin i-th worker to, -1 if pinning is off
+    int WorkerCpu(uint32_t i) const;
+
+    const Mode _mode;
+    const bool _pin;
+
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
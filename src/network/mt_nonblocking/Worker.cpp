@@ -1,13 +1,22 @@
 #include "Worker.h"
 
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 #include <netdb.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
@@ -22,13 +31,14 @@ namespace MTnonblock {
 
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
-    // TODO: implementation here
-}
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _server_socket(-1), _event_fd(-1) {}
 
 // See Worker.h
 Worker::~Worker() {
-    // TODO: implementation here
+    for (Connection *pc : _connections) {
+        close(pc->_socket);
+        delete pc;
+    }
 }
 
 // See Worker.h
@@ -41,23 +51,101 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _server_socket = other._server_socket;
+    _event_fd = other._event_fd;
+    _connections = std::move(other._connections);
+    isRunning = other.isRunning.load();
 
     other._epoll_fd = -1;
+    other._server_socket = -1;
+    other._event_fd = -1;
+    other._connections.clear();
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int epoll_fd, int cpu) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
         _epoll_fd = epoll_fd;
         _logger = _pLogging->select("network.worker");
-        _thread = std::thread(&Worker::OnRun, this);
+        Spawn(cpu);
     }
 }
 
 // See Worker.h
-void Worker::Stop() { isRunning = false; }
+void Worker::Listen(uint16_t port, int cpu) {
+    if (isRunning.exchange(true) == true) {
+        return;
+    }
+    _logger = _pLogging->select("network.worker");
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    // Every worker binds its own socket to the same port, kernel spreads connections between them
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    make_socket_non_blocking(_server_socket);
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+    }
+
+    // Worker itself stands for the listening socket
+    event.events = EPOLLIN;
+    event.data.ptr = this;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    Spawn(cpu);
+}
+
+// See Worker.h
+void Worker::Stop() {
+    isRunning = false;
+
+    // In shared mode server wakes up all workers at once
+    if (_event_fd != -1 && eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
 
 // See Worker.h
 void Worker::Join() {
@@ -65,17 +153,38 @@ void Worker::Join() {
     _thread.join();
 }
 
+// See Worker.h
+void Worker::Spawn(int cpu) {
+    _thread = std::thread(&Worker::OnRun, this);
+    if (cpu < 0) {
+        return;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (pthread_setaffinity_np(_thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+        _logger->warn("Failed to pin worker to cpu {}", cpu);
+    }
+}
+
 // See Worker.h
 void Worker::OnRun() {
     assert(_epoll_fd >= 0);
     _logger->trace("OnRun");
 
+    // In listening mode connections are registered once as edge triggered and never rearmed
+    const bool owner = (_server_socket != -1);
+
     // Process connection events
     //
     // Do not forget to use EPOLLEXCLUSIVE flag when register socket
     // for events to avoid thundering herd type behavior.
     int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
+
+    // Read buffers shared by connections this thread serves, see ReadBuffer.h
+    BufferPool buffers;
     while (isRunning) {
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
         _logger->debug("Worker wokeup: {} events", nmod);
@@ -90,6 +199,12 @@ void Worker::OnRun() {
                 continue;
             }
 
+            // Private listening socket has new connections
+            if (current_event.data.ptr == this) {
+                OnNewConnection();
+                continue;
+            }
+
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
@@ -102,12 +217,28 @@ void Worker::OnRun() {
                 // Depends on what connection wants...
                 if (current_event.events & EPOLLIN) {
                     _logger->trace("Got EPOLLIN");
-                    pconn->DoRead();
+                    pconn->DoRead(buffers);
                 }
-                if (current_event.events & EPOLLOUT) {
+
+                // Responses to the whole batch read are sent right away instead of waiting for the next
+                // event: edge triggered socket reports writability only once, and rearming oneshot
+                // connection just to learn it is writable costs a round through epoll
+                if ((current_event.events & EPOLLOUT) || !pconn->_results.empty()) {
                     _logger->trace("Got EPOLLOUT");
-                    pconn->DoWrite();
+                    if (pconn->isAlive() && !pconn->_results.empty()) {
+                        pconn->DoWrite();
+                    }
+                }
+            }
+
+            if (owner) {
+                // Connection stays registered as is until it dies
+                if (!pconn->isAlive()) {
+                    _connections.erase(pconn);
+                    close(pconn->_socket);
+                    delete pconn;
                 }
+                continue;
             }
 
             // Rearm connection
@@ -132,9 +263,47 @@ void Worker::OnRun() {
         }
         // TODO: Select timeout...
     }
+
+    // Private resources are released by the thread which used them
+    if (owner) {
+        for (Connection *pc : _connections) {
+            close(pc->_socket);
+            delete pc;
+        }
+        _connections.clear();
+
+        close(_server_socket);
+        close(_event_fd);
+        close(_epoll_fd);
+    }
     _logger->warn("Worker stopped");
 }
 
+// See Worker.h
+void Worker::OnNewConnection() {
+    for (;;) {
+        int infd = accept4(_server_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket: {}", strerror(errno));
+            }
+            break; // We have processed all incoming connections.
+        }
+        _logger->debug("Accepted connection on descriptor {}", infd);
+
+        Connection *pc = new Connection(infd, _pStorage, _logger);
+        pc->Start();
+        pc->_event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+            _logger->debug("epoll_ctl failed during connection register in worker's epoll");
+            close(infd);
+            delete pc;
+            continue;
+        }
+        _connections.insert(pc);
+    }
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
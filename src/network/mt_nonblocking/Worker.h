@@ -4,6 +4,7 @@
 #include <atomic>
 #include <memory>
 #include <thread>
+#include <unordered_set>
 
 namespace spdlog {
 class logger;
@@ -20,10 +21,19 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
- * socket and process incoming connections and its data
+ * socket and process incoming connections and its data.
+ *
+ * Worker could run in one of two modes:
+ * - shared: epoll instance is given by the server and shared with other workers, connections are
+ *   accepted by server acceptors and every event gets connection rearmed with EPOLLONESHOT
+ * - listening: worker has private listening socket bound with SO_REUSEPORT and private edge triggered
+ *   epoll, it accepts connections by itself and owns them for the whole life, so there is no rearm
  */
 class Worker {
 public:
@@ -37,8 +47,18 @@ public:
      * Spaws new background thread that is doing epoll on the given server
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
+     *
+     * @param cpu if not negative thread is pinned to that core
      */
-    void Start(int epoll_fd);
+    void Start(int epoll_fd, int cpu = -1);
+
+    /**
+     * Opens private listening socket on the given port and spawns background thread which
+     * accepts connections from it and serves them
+     *
+     * @param cpu if not negative thread is pinned to that core
+     */
+    void Listen(uint16_t port, int cpu = -1);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -64,6 +84,12 @@ private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
 
+    // Spawns background thread, optionally pinned to the core
+    void Spawn(int cpu);
+
+    // Accepts all pending connections on private listening socket
+    void OnNewConnection();
+
     // afina services
     std::shared_ptr<Afina::Storage> _pStorage;
 
@@ -81,6 +107,15 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Private listening socket, -1 in shared mode
+    int _server_socket;
+
+    // Private event "device" used to wakeup worker in listening mode
+    int _event_fd;
+
+    // Connections owned by the worker in listening mode
+    std::unordered_set<Connection *> _connections;
 };
 
 } // namespace MTnonblock
@@ -17,6 +17,7 @@
 
 #include <spdlog/logger.h>
 
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
@@ -152,6 +153,8 @@ void ServerImpl::OnRun() {
             }
             _logger->debug("Accepted connection on descriptor {} (host={}, port={})\n", client_socket, host, port);
         }
+        Statistics::Add(Statistics::kCurrConnections);
+        Statistics::Add(Statistics::kTotalConnections);
 
         // Configure read timeout
         {
@@ -244,6 +247,7 @@ void ServerImpl::OnRun() {
 
         // We are done with this connection
         close(client_socket);
+        Statistics::Add(Statistics::kCurrConnections, -1);
 
         // Prepare for the next command: just in case if connection was closed in the middle of executing something
         command_to_execute.reset();
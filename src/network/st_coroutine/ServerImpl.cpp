@@ -0,0 +1,472 @@
+#include "ServerImpl.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Statistics.h>
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include <afina/logging/Service.h>
+
+#include "protocol/Parser.h"
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+namespace {
+
+// Stack of each connection coroutine. Pages are committed on first touch, so it costs address space only
+const size_t kStackSize = 128 * 1024;
+
+// Number of segments written by a single writev
+const size_t kIovecs = 64;
+
+} // namespace
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _server_socket(-1), _event_fd(-1), _epoll_fd(-1), _engine(nullptr) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start st_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _epoll_fd = epoll_create1(0);
+    if (_epoll_fd == -1) {
+        close(_server_socket);
+        close(_event_fd);
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    // Stop request is the only event without waiter
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+        close(_server_socket);
+        close(_event_fd);
+        close(_epoll_fd);
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    running.store(true);
+    _thread = std::thread(&ServerImpl::OnRun, this);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    running.store(false);
+
+    // Wakeup thread that sleeps on epoll_wait
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup network thread");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    assert(_thread.joinable());
+    _thread.join();
+}
+
+// See ServerImpl.h
+void ServerImpl::OnRun() {
+    // Engine returns once acceptor and all the connections are done, which happens after stop only
+    Coroutine::Engine engine(Coroutine::Engine::Mode::kSeparateStack, kStackSize, [this]() { Poll(); });
+    _engine = &engine;
+    engine.start(&ServerImpl::Acceptor, this);
+    _engine = nullptr;
+
+    close(_epoll_fd);
+    close(_event_fd);
+    close(_server_socket);
+    _logger->warn("Network stopped");
+}
+
+// See ServerImpl.h
+void ServerImpl::Acceptor(ServerImpl *server) { server->OnAccept(); }
+
+// See ServerImpl.h
+void ServerImpl::OnAccept() {
+    Waiter waiter;
+    Watch(waiter, _server_socket);
+
+    while (running.load()) {
+        struct sockaddr client_addr;
+        socklen_t client_addr_len = sizeof(client_addr);
+        int client_socket = accept4(_server_socket, &client_addr, &client_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!Wait(waiter, EPOLLIN)) {
+                    break;
+                }
+            } else if (errno != EINTR) {
+                // Let connections go on, hopefully some of them will release resources
+                _logger->error("Failed to accept socket: {}", strerror(errno));
+                _engine->yield();
+            }
+            continue;
+        }
+
+        // Got new connection
+        if (_logger->should_log(spdlog::level::debug)) {
+            std::string host = "unknown", port = "-1";
+
+            char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+            if (getnameinfo(&client_addr, client_addr_len, hbuf, sizeof(hbuf), sbuf, sizeof(sbuf),
+                            NI_NUMERICHOST | NI_NUMERICSERV) == 0) {
+                host = hbuf;
+                port = sbuf;
+            }
+            _logger->debug("Accepted connection on descriptor {} (host={}, port={})", client_socket, host, port);
+        }
+
+        // Connection gets control once acceptor blocks
+        _engine->run(&ServerImpl::Connection, this, int(client_socket));
+    }
+
+    Forget(waiter);
+    _logger->debug("Acceptor stopped");
+}
+
+// See ServerImpl.h
+void ServerImpl::Connection(ServerImpl *server, int socket) { server->OnConnection(socket); }
+
+// See ServerImpl.h
+void ServerImpl::OnConnection(int client_socket) {
+    Statistics::Add(Statistics::kCurrConnections);
+    Statistics::Add(Statistics::kTotalConnections);
+
+    // Here is connection state
+    // - parser: parse state of the stream
+    // - command_to_execute: last command parsed out of stream
+    // - arg_remains: how many bytes to read from stream to get command argument
+    // - argument_for_command: buffer stores argument
+    // - output: responses not sent yet
+    std::size_t arg_remains = 0;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+    std::vector<Execute::Response::Segment> output;
+
+    Waiter waiter;
+    try {
+        Watch(waiter, client_socket);
+
+        char client_buffer[4096];
+        std::size_t already_read = 0;
+        while (running.load()) {
+            ssize_t readed_bytes = Read(waiter, client_buffer + already_read, sizeof(client_buffer) - already_read);
+            if (readed_bytes == 0) {
+                _logger->debug("Connection closed");
+                break;
+            } else if (readed_bytes < 0) {
+                if (errno == ECANCELED) {
+                    break;
+                }
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+            already_read += readed_bytes;
+
+            // Single block of data readed from the socket could trigger inside actions a multiple times,
+            // for example:
+            // - read#0: [<command1 start>]
+            // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+            while (already_read > 0) {
+                _logger->debug("Process {} bytes", already_read);
+                // There is no command yet
+                if (!command_to_execute) {
+                    std::size_t parsed = 0;
+                    if (parser.Parse(client_buffer, already_read, parsed)) {
+                        // There is no command to be launched, continue to parse input stream
+                        // Here we are, current chunk finished some command, process it
+                        _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                        command_to_execute = parser.Build(arg_remains);
+                        if (arg_remains > 0) {
+                            arg_remains += 2;
+                        }
+                    }
+
+                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+                    if (parsed == 0) {
+                        break;
+                    } else {
+                        std::memmove(client_buffer, client_buffer + parsed, already_read - parsed);
+                        already_read -= parsed;
+                    }
+                }
+
+                // There is command, but we still wait for argument to arrive...
+                if (command_to_execute && arg_remains > 0) {
+                    _logger->debug("Fill argument: {} bytes of {}", already_read, arg_remains);
+                    // There is some parsed command, and now we are reading argument
+                    std::size_t to_read = std::min(arg_remains, already_read);
+                    argument_for_command.append(client_buffer, to_read);
+
+                    std::memmove(client_buffer, client_buffer + to_read, already_read - to_read);
+                    arg_remains -= to_read;
+                    already_read -= to_read;
+                }
+
+                // Thre is command & argument - RUN!
+                if (command_to_execute && arg_remains == 0) {
+                    _logger->debug("Start command execution");
+
+                    Execute::Response response;
+                    if (argument_for_command.size() >= 2) {
+                        argument_for_command.resize(argument_for_command.size() - 2);
+                    }
+
+                    try {
+                        command_to_execute->Execute(*pStorage, argument_for_command, response);
+                    } catch (std::runtime_error &ex) {
+                        response = Execute::Response();
+                        response.Append(std::string("SERVER_ERROR ") + ex.what());
+                    }
+                    response.Append("\r\n", 2);
+
+                    // Text is merged into the text queued before, values stay in the storage buffers
+                    for (auto &segment : response.segments()) {
+                        if (!segment.value && !output.empty() && !output.back().value) {
+                            output.back().text += segment.text;
+                        } else {
+                            output.push_back(std::move(segment));
+                        }
+                    }
+
+                    // Prepare for the next command
+                    command_to_execute.reset();
+                    argument_for_command.resize(0);
+                    parser.Reset();
+                }
+            } // while (already_read)
+
+            // Answer everything that came in this chunk at once
+            if (!output.empty() && !Write(waiter, output)) {
+                break;
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", client_socket, ex.what());
+    }
+
+    Forget(waiter);
+    close(client_socket);
+    Statistics::Add(Statistics::kCurrConnections, -1);
+}
+
+// See ServerImpl.h
+void ServerImpl::Watch(Waiter &waiter, int socket) {
+    // Edge triggered: coroutine waits only after operation returned EAGAIN, so the next edge is exactly
+    // what it needs
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = &waiter;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, socket, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll: " + std::string(strerror(errno)));
+    }
+
+    waiter.socket = socket;
+    _waiters.insert(&waiter);
+}
+
+// See ServerImpl.h
+void ServerImpl::Forget(Waiter &waiter) {
+    if (_waiters.erase(&waiter) == 0) {
+        return;
+    }
+
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, waiter.socket, nullptr)) {
+        _logger->error("Failed to delete descriptor {} from epoll", waiter.socket);
+    }
+}
+
+// See ServerImpl.h
+bool ServerImpl::Wait(Waiter &waiter, uint32_t events) {
+    if (!running.load()) {
+        return false;
+    }
+
+    waiter.events = events;
+    waiter.routine = _engine->current();
+    _engine->block();
+
+    waiter.events = 0;
+    return running.load();
+}
+
+// See ServerImpl.h
+void ServerImpl::Poll() {
+    std::array<struct epoll_event, 64> mod_list;
+    int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), -1);
+    if (nmod == -1) {
+        if (errno == EINTR) {
+            return;
+        }
+
+        // Nothing is going to wake coroutines up anymore
+        _logger->error("Failed to wait for events: {}", strerror(errno));
+        running.store(false);
+    }
+
+    for (int i = 0; i < nmod; i++) {
+        struct epoll_event &current_event = mod_list[i];
+        if (current_event.data.ptr == nullptr) {
+            _logger->debug("Network thread got stop signal");
+            eventfd_t value;
+            eventfd_read(_event_fd, &value);
+            continue;
+        }
+
+        // Errors and hangups are reported to whoever waits, the following call would get them
+        uint32_t ready = current_event.events;
+        if (ready & (EPOLLERR | EPOLLHUP)) {
+            ready |= EPOLLIN | EPOLLOUT;
+        } else if (ready & EPOLLRDHUP) {
+            ready |= EPOLLIN;
+        }
+
+        Waiter *waiter = static_cast<Waiter *>(current_event.data.ptr);
+        if (waiter->events & ready) {
+            waiter->events = 0;
+            _engine->unblock(waiter->routine);
+        }
+    }
+
+    // Wake everybody up to let them finish
+    if (!running.load()) {
+        for (Waiter *waiter : _waiters) {
+            if (waiter->events != 0) {
+                waiter->events = 0;
+                _engine->unblock(waiter->routine);
+            }
+        }
+    }
+}
+
+// See ServerImpl.h
+ssize_t ServerImpl::Read(Waiter &waiter, char *buffer, size_t size) {
+    for (;;) {
+        ssize_t readed_bytes = read(waiter.socket, buffer, size);
+        if (readed_bytes >= 0) {
+            return readed_bytes;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return -1;
+        }
+
+        if (!Wait(waiter, EPOLLIN)) {
+            errno = ECANCELED;
+            return -1;
+        }
+    }
+}
+
+// See ServerImpl.h
+bool ServerImpl::Write(Waiter &waiter, std::vector<Execute::Response::Segment> &segments) {
+    // First segment not written completely and how many bytes of it are written already
+    size_t first = 0, written_amount = 0;
+    while (first < segments.size()) {
+        size_t to_be_written = std::min(segments.size() - first, kIovecs);
+
+        struct iovec iovector[kIovecs];
+        for (size_t i = 0; i < to_be_written; i++) {
+            iovector[i].iov_base = (void *)(segments[first + i].data());
+            iovector[i].iov_len = segments[first + i].size();
+        }
+        iovector[0].iov_base = (char *)iovector[0].iov_base + written_amount;
+        iovector[0].iov_len -= written_amount;
+
+        ssize_t written = writev(waiter.socket, iovector, to_be_written);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throw std::runtime_error("Failed to write response to client: " + std::string(strerror(errno)));
+            } else if (!Wait(waiter, EPOLLOUT)) {
+                return false;
+            }
+            continue;
+        }
+
+        written += written_amount;
+        while (first < segments.size() && size_t(written) >= segments[first].size()) {
+            written -= segments[first].size();
+            first++;
+        }
+        written_amount = written;
+    }
+
+    segments.clear();
+    return true;
+}
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
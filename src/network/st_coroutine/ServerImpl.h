@@ -0,0 +1,131 @@
+#ifndef AFINA_NETWORK_ST_COROUTINE_SERVER_H
+#define AFINA_NETWORK_ST_COROUTINE_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <afina/coroutine/Engine.h>
+#include <afina/execute/Response.h>
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+/**
+ * # Network resource manager implementation
+ * Single threaded server where each connection is a coroutine running plain read-parse-execute-write
+ * loop. Sockets are nonblocking: once operation would block coroutine registers what it waits for and
+ * blocks itself in the engine. When all coroutines are blocked engine calls epoll_wait and unblocks
+ * coroutines whose sockets got ready
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    /**
+     * Method is running in the network thread, runs coroutines until server is stopped
+     */
+    void OnRun();
+
+    /**
+     * Coroutine accepting new connections
+     */
+    static void Acceptor(ServerImpl *server);
+    void OnAccept();
+
+    /**
+     * Coroutine serving single connection
+     */
+    static void Connection(ServerImpl *server, int socket);
+    void OnConnection(int socket);
+
+private:
+    /**
+     * Socket registered in epoll, holds coroutine waiting for it if any
+     */
+    struct Waiter {
+        int socket = -1;
+
+        // Events coroutine waits for, 0 if it doesn't wait
+        uint32_t events = 0;
+        void *routine = nullptr;
+    };
+
+    /**
+     * Registers socket in epoll, it stays there until Forget
+     */
+    void Watch(Waiter &waiter, int socket);
+    void Forget(Waiter &waiter);
+
+    /**
+     * Blocks current coroutine until socket gets any of the given events. Returns false if server is
+     * stopping, so that coroutine must finish
+     */
+    bool Wait(Waiter &waiter, uint32_t events);
+
+    /**
+     * Engine unblocker: waits for events and unblocks coroutines waiting for them
+     */
+    void Poll();
+
+    /**
+     * Reads from socket, blocks coroutine while there is no data
+     */
+    ssize_t Read(Waiter &waiter, char *buffer, size_t size);
+
+    /**
+     * Writes all the response segments, blocks coroutine while socket is full
+     */
+    bool Write(Waiter &waiter, std::vector<Execute::Response::Segment> &segments);
+
+    // Logger instance
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Atomic flag to notify network thread that it is time to stop
+    std::atomic<bool> running;
+
+    // Server socket to accept connections on
+    int _server_socket;
+
+    // Used to wakeup network thread sleeping on epoll_wait
+    int _event_fd;
+
+    int _epoll_fd;
+
+    // Valid while network thread runs coroutines
+    Coroutine::Engine *_engine;
+
+    // All sockets being watched, to wake up their coroutines on stop
+    std::set<Waiter *> _waiters;
+
+    // Thread to run network on
+    std::thread _thread;
+};
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_COROUTINE_SERVER_H
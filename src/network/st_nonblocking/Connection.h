@@ -6,6 +6,7 @@
 
 #include <sys/epoll.h>
 #include <spdlog/logger.h>
+#include <afina/Statistics.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
@@ -21,8 +22,12 @@ public:
             pStorage(ps), _logger(l) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
+        Statistics::Add(Statistics::kCurrConnections);
+        Statistics::Add(Statistics::kTotalConnections);
     }
 
+    ~Connection() { Statistics::Add(Statistics::kCurrConnections, -1); }
+
     inline bool isAlive() const { return (_state == 0); }
 
     void Start();
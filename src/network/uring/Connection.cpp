@@ -0,0 +1,113 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <spdlog/logger.h>
+
+#include <afina/Statistics.h>
+#include <afina/Storage.h>
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Connection.h
+Connection::Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> l)
+    : _socket(s), pStorage(ps), _logger(l), _receiving(false), _read_closed(false), _failed(false), _sending(0),
+      arg_remains(0), _head_written(0) {
+    Statistics::Add(Statistics::kCurrConnections);
+    Statistics::Add(Statistics::kTotalConnections);
+}
+
+// See Connection.h
+Connection::~Connection() { Statistics::Add(Statistics::kCurrConnections, -1); }
+
+// See Connection.h
+void Connection::Process(const char *data, size_t size) {
+    // Responses to all commands from the same packet are assembled together, so that their text
+    // goes out in as few sends as possible
+    Execute::Response output;
+    try {
+        // Single block of data could trigger inside actions a multiple times, for example:
+        // - recv#0: [<command1 start>]
+        // - recv#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+        while (size > 0) {
+            // There is no command yet
+            if (!command_to_execute) {
+                std::size_t parsed = 0;
+                if (parser.Parse(data, size, parsed)) {
+                    _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                    command_to_execute = parser.Build(arg_remains);
+                    if (arg_remains > 0) {
+                        arg_remains += 2;
+                    }
+                }
+
+                // Parser might fail to consume any bytes, wait for more data
+                if (parsed == 0) {
+                    break;
+                }
+                data += parsed;
+                size -= parsed;
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (command_to_execute && arg_remains > 0) {
+                std::size_t to_read = std::min(arg_remains, size);
+                argument_for_command.append(data, to_read);
+                data += to_read;
+                size -= to_read;
+                arg_remains -= to_read;
+            }
+
+            // Thre is command & argument - RUN!
+            if (command_to_execute && arg_remains == 0) {
+                // Argument is followed by \r\n which isn't part of the data
+                if (argument_for_command.size() >= 2) {
+                    argument_for_command.resize(argument_for_command.size() - 2);
+                }
+
+                try {
+                    command_to_execute->Execute(*pStorage, argument_for_command, output);
+                } catch (std::runtime_error &ex) {
+                    output.Append(std::string("SERVER_ERROR ") + ex.what());
+                }
+                output.Append("\r\n", 2);
+
+                // Prepare for the next command
+                command_to_execute.reset();
+                argument_for_command.resize(0);
+                parser.Reset();
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        output.Append(std::string("CLIENT_ERROR ") + ex.what() + "\r\n");
+
+        // Stream position is lost, there is no way to continue
+        _read_closed = true;
+    }
+
+    // Segments already queued could be in flight, so new ones are never merged into them
+    for (auto &segment : output.segments()) {
+        _output.push_back(std::move(segment));
+    }
+}
+
+// See Connection.h
+bool Connection::Sent(size_t bytes) {
+    _head_written += bytes;
+    if (_head_written < _output.front().size()) {
+        return false;
+    }
+
+    _output.pop_front();
+    _head_written = 0;
+    return true;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,85 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace Uring {
+
+/**
+ * # Client connection served by io_uring worker
+ * Keeps protocol state between receive completions and the queue of responses waiting to be sent.
+ * Connection doesn't do any IO by itself, worker submits requests on its behalf.
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> l);
+    ~Connection();
+
+    /**
+     * Runs received bytes through parser, executes every complete command and queues its response
+     */
+    void Process(const char *data, size_t size);
+
+    /**
+     * Marks first bytes of the output as sent, returns true if the whole response at the
+     * head of the queue is done
+     */
+    bool Sent(size_t bytes);
+
+    inline bool HasOutput() const { return !_output.empty(); }
+
+private:
+    friend class Worker;
+
+    int _socket;
+
+    std::shared_ptr<Afina::Storage> pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Multishot receive is armed for the socket
+    bool _receiving;
+
+    // No more commands will be read: client closed connection, protocol error or server is stopping
+    bool _read_closed;
+
+    // Socket is broken, pending output must be dropped
+    bool _failed;
+
+    // Number of send requests submitted but not yet completed
+    size_t _sending;
+
+    // Reading related
+    std::size_t arg_remains;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+
+    // Pieces of responses waiting to be sent, head one could be sent partially. Values are referenced
+    // from the storage and sent right from its buffers
+    std::deque<Execute::Response::Segment> _output;
+    std::size_t _head_written;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
@@ -0,0 +1,202 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+namespace {
+
+int io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+void *map(int fd, size_t size, off_t offset) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+    return ptr;
+}
+
+} // namespace
+
+// See Ring.h
+Ring::Ring(unsigned entries) : _buf_ring(nullptr), _buf_ring_size(0), _buffers(nullptr), _buffers_total(0) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 2;
+
+    _fd = io_uring_setup(entries, &params);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+    }
+
+    try {
+        _sq_ptr = map(_fd, _sq_size, IORING_OFF_SQ_RING);
+        _cq_ptr = (params.features & IORING_FEAT_SINGLE_MMAP) ? _sq_ptr : map(_fd, _cq_size, IORING_OFF_CQ_RING);
+
+        _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        _sqes = static_cast<struct io_uring_sqe *>(map(_fd, _sqes_size, IORING_OFF_SQES));
+    } catch (...) {
+        close(_fd);
+        throw;
+    }
+
+    char *sq = static_cast<char *>(_sq_ptr);
+    _sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    _sqe_tail = *_sq_tail;
+
+    // Submission entries are always used in order, so indirection array is identity
+    unsigned *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < _sq_entries; i++) {
+        array[i] = i;
+    }
+
+    char *cq = static_cast<char *>(_cq_ptr);
+    _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+// See Ring.h
+Ring::~Ring() {
+    if (_buf_ring != nullptr) {
+        struct io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.bgid = _buf_gid;
+        io_uring_register(_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        munmap(_buf_ring, _buf_ring_size);
+        munmap(_buffers, _buffers_total);
+    }
+
+    munmap(_sqes, _sqes_size);
+    if (_cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    munmap(_sq_ptr, _sq_size);
+    close(_fd);
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::Sqe() {
+    unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    if (_sqe_tail - head >= _sq_entries) {
+        Submit();
+        head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        if (_sqe_tail - head >= _sq_entries) {
+            throw std::runtime_error("io_uring submission queue overflow");
+        }
+    }
+
+    struct io_uring_sqe *sqe = &_sqes[_sqe_tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sqe_tail++;
+    return sqe;
+}
+
+// See Ring.h
+unsigned Ring::Space() const { return _sq_entries - (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE)); }
+
+// See Ring.h
+int Ring::Submit(unsigned wait_nr) {
+    unsigned to_submit = _sqe_tail - *_sq_tail;
+    __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+    if (to_submit == 0 && wait_nr == 0) {
+        return 0;
+    }
+
+    int ret;
+    do {
+        ret = io_uring_enter(_fd, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    } while (ret < 0 && errno == EINTR && wait_nr == 0);
+
+    if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw std::runtime_error("Failed to submit to io_uring: " + std::string(strerror(errno)));
+    }
+    return ret;
+}
+
+// See Ring.h
+void Ring::SetupBuffers(uint16_t gid, unsigned entries, unsigned buffer_size) {
+    _buf_ring_size = entries * sizeof(struct io_uring_buf);
+    void *ring = mmap(nullptr, _buf_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        throw std::runtime_error("Failed to allocate buffer ring: " + std::string(strerror(errno)));
+    }
+
+    _buffer_size = buffer_size;
+    _buffers_total = size_t(entries) * buffer_size;
+    void *buffers = mmap(nullptr, _buffers_total, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (buffers == MAP_FAILED) {
+        munmap(ring, _buf_ring_size);
+        throw std::runtime_error("Failed to allocate buffers: " + std::string(strerror(errno)));
+    }
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = entries;
+    reg.bgid = gid;
+    if (io_uring_register(_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        munmap(ring, _buf_ring_size);
+        munmap(buffers, _buffers_total);
+        throw std::runtime_error("Failed to register buffer ring: " + std::string(strerror(errno)));
+    }
+
+    _buf_ring = static_cast<struct io_uring_buf_ring *>(ring);
+    _buffers = static_cast<char *>(buffers);
+    _buf_mask = entries - 1;
+    _buf_tail = 0;
+    _buf_gid = gid;
+
+    for (unsigned i = 0; i < entries; i++) {
+        RecycleBuffer(i);
+    }
+    CommitBuffers();
+}
+
+// See Ring.h
+void Ring::RecycleBuffer(uint16_t bid) {
+    // Header declares bufs as flexible array, which is shifted by C++ compilers, so index raw memory
+    struct io_uring_buf &buf = reinterpret_cast<struct io_uring_buf *>(_buf_ring)[_buf_tail & _buf_mask];
+    buf.addr = reinterpret_cast<uint64_t>(Buffer(bid));
+    buf.len = _buffer_size;
+    buf.bid = bid;
+    _buf_tail++;
+}
+
+// See Ring.h
+void Ring::CommitBuffers() { __atomic_store_n(&_buf_ring->tail, _buf_tail, __ATOMIC_RELEASE); }
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,119 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Minimal io_uring instance
+ * Thin wrapper over raw io_uring syscalls: maps submission and completion queues into the process and
+ * gives access to them. Intended to be used from a single thread.
+ */
+class Ring {
+public:
+    /**
+     * @param entries size of submission queue, completion queue is twice as big
+     */
+    explicit Ring(unsigned entries);
+    ~Ring();
+
+    /**
+     * Returns next free submission entry zeroed out. If queue is full then pending entries are
+     * submitted first
+     */
+    struct io_uring_sqe *Sqe();
+
+    /**
+     * Number of submission entries could be taken without submitting pending ones
+     */
+    unsigned Space() const;
+
+    /**
+     * Submits all prepared entries and waits until at least wait_nr completions are available.
+     * Returns number of entries submitted
+     */
+    int Submit(unsigned wait_nr = 0);
+
+    /**
+     * Calls f(cqe) for every available completion and marks them consumed, returns number of completions
+     */
+    template <typename F> unsigned Drain(F &&f) {
+        unsigned head = *_cq_head;
+        unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        for (; head != tail; head++, count++) {
+            f(_cqes[head & _cq_mask]);
+        }
+        __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    /**
+     * Registers ring of provided buffers: entries buffers of buffer_size bytes each are allocated and
+     * given to the kernel under group gid. Ring is unregistered on destruction
+     */
+    void SetupBuffers(uint16_t gid, unsigned entries, unsigned buffer_size);
+
+    /**
+     * Data of the provided buffer kernel selected for the completion
+     */
+    inline char *Buffer(uint16_t bid) const { return _buffers + size_t(bid) * _buffer_size; }
+
+    /**
+     * Gives buffer back to the kernel, it becomes visible once CommitBuffers called
+     */
+    void RecycleBuffer(uint16_t bid);
+    void CommitBuffers();
+
+    inline int fd() const { return _fd; }
+
+private:
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    int _fd;
+
+    // Submission queue
+    void *_sq_ptr;
+    size_t _sq_size;
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned _sq_mask;
+    unsigned _sq_entries;
+    struct io_uring_sqe *_sqes;
+    size_t _sqes_size;
+
+    // Local tail, published to the kernel in Submit
+    unsigned _sqe_tail;
+
+    // Completion queue, could be mapped together with submission one
+    void *_cq_ptr;
+    size_t _cq_size;
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring *_buf_ring;
+    size_t _buf_ring_size;
+    unsigned _buf_mask;
+    uint16_t _buf_tail;
+    uint16_t _buf_gid;
+    char *_buffers;
+    size_t _buffer_size;
+    size_t _buffers_total;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
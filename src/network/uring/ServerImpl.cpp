@@ -0,0 +1,67 @@
+#include "ServerImpl.h"
+
+#include <stdexcept>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Worker.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start uring network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Workers accept connections by themselves, so there are no separate acceptors
+    if (n_workers == 0) {
+        n_workers = 1;
+    }
+
+    _workers.reserve(n_workers);
+    for (uint32_t i = 0; i < n_workers; i++) {
+        _workers.emplace_back(new Worker(pStorage, pLogging));
+        _workers.back()->Start(port);
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    for (auto &w : _workers) {
+        w->Stop();
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    for (auto &w : _workers) {
+        w->Join();
+    }
+    _workers.clear();
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
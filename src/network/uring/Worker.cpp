@@ -0,0 +1,363 @@
+#include "Worker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Ring.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+namespace {
+
+// Size of the submission queue
+const unsigned kRingEntries = 4096;
+
+// Provided buffers for receive, must be power of two
+const uint16_t kBufferGroup = 0;
+const unsigned kBuffers = 4096;
+const unsigned kBufferSize = 4096;
+
+// Longest chain of linked sends submitted at once for a connection
+const size_t kMaxSendChain = 16;
+
+// Kind of request is encoded in the lowest bits of user data, the rest is connection pointer
+enum Op : uint64_t { kAccept = 0, kEvent = 1, kReceive = 2, kSend = 3, kCancel = 4 };
+const uint64_t kOpMask = 7;
+
+inline uint64_t tag(Connection *pc, Op op) { return reinterpret_cast<uint64_t>(pc) | op; }
+inline Op op_of(uint64_t user_data) { return static_cast<Op>(user_data & kOpMask); }
+inline Connection *connection_of(uint64_t user_data) { return reinterpret_cast<Connection *>(user_data & ~kOpMask); }
+
+} // namespace
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _server_socket(-1), _accepting(false), _event_fd(-1),
+      _event_value(0) {}
+
+// See Worker.h
+Worker::~Worker() {
+    if (_thread.joinable()) {
+        Stop();
+        _thread.join();
+    }
+}
+
+// See Worker.h
+void Worker::Start(uint16_t port) {
+    _logger = _pLogging->select("network");
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    // Every worker binds its own socket to the same port, kernel spreads connections between them
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_CLOEXEC);
+    if (_event_fd == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    try {
+        _ring.reset(new Ring(kRingEntries));
+        _ring->SetupBuffers(kBufferGroup, kBuffers, kBufferSize);
+    } catch (...) {
+        _ring.reset();
+        close(_event_fd);
+        close(_server_socket);
+        throw;
+    }
+
+    isRunning = true;
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Stop() {
+    isRunning = false;
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start uring worker");
+
+    Accept();
+    WaitEvent();
+
+    bool stopping = false;
+    while (!stopping || !_connections.empty() || _accepting) {
+        _ring->Submit(1);
+
+        _ring->Drain([this, &stopping](const struct io_uring_cqe &cqe) {
+            switch (op_of(cqe.user_data)) {
+            case kAccept:
+                OnAccept(cqe.res, cqe.flags);
+                break;
+
+            case kEvent: {
+                // Server is going to stop, no new connections, no new commands
+                _logger->debug("Break worker due to stop signal");
+                stopping = true;
+                if (_accepting) {
+                    Cancel(tag(nullptr, kAccept));
+                }
+                std::vector<Connection *> connections(_connections.begin(), _connections.end());
+                for (Connection *pc : connections) {
+                    Shutdown(pc);
+                    Release(pc);
+                }
+                break;
+            }
+
+            case kReceive:
+                OnReceive(connection_of(cqe.user_data), cqe.res, cqe.flags);
+                break;
+
+            case kSend:
+                OnSend(connection_of(cqe.user_data), cqe.res);
+                break;
+
+            case kCancel:
+                break;
+            }
+        });
+
+        // Buffers released while processing completions
+        _ring->CommitBuffers();
+    }
+
+    // Make sure nothing is still in flight before ring memory is gone
+    _ring.reset();
+    close(_server_socket);
+    close(_event_fd);
+    _logger->warn("Uring worker stopped");
+}
+
+// See Worker.h
+void Worker::Accept() {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _server_socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = tag(nullptr, kAccept);
+    _accepting = true;
+}
+
+// See Worker.h
+void Worker::WaitEvent() {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = _event_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&_event_value);
+    sqe->len = sizeof(_event_value);
+    sqe->user_data = tag(nullptr, kEvent);
+}
+
+// See Worker.h
+void Worker::Receive(Connection *pc) {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pc->_socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = tag(pc, kReceive);
+    pc->_receiving = true;
+}
+
+// See Worker.h
+void Worker::Send(Connection *pc) {
+    if (pc->_sending > 0 || pc->_failed || !pc->HasOutput()) {
+        return;
+    }
+
+    // Linked sends are executed in order, once one of them is short the rest are cancelled and
+    // get resubmitted after the whole chain completes. Chain must not be split between submissions,
+    // otherwise it would lose ordering
+    size_t count = std::min(pc->_output.size(), kMaxSendChain);
+    if (_ring->Space() < count) {
+        _ring->Submit();
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const Execute::Response::Segment &out = pc->_output[i];
+        size_t offset = (i == 0) ? pc->_head_written : 0;
+
+        struct io_uring_sqe *sqe = _ring->Sqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = pc->_socket;
+        sqe->addr = reinterpret_cast<uint64_t>(out.data() + offset);
+        sqe->len = out.size() - offset;
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->flags = (i + 1 < count) ? IOSQE_IO_LINK : 0;
+        sqe->user_data = tag(pc, kSend);
+    }
+    pc->_sending = count;
+}
+
+// See Worker.h
+void Worker::Cancel(uint64_t user_data) {
+    struct io_uring_sqe *sqe = _ring->Sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = tag(nullptr, kCancel);
+}
+
+// See Worker.h
+void Worker::OnAccept(int res, uint32_t flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        _accepting = false;
+    }
+
+    if (res >= 0) {
+        int opts = 1;
+        setsockopt(res, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+
+        Connection *pc = new Connection(res, _pStorage, _logger);
+        _connections.insert(pc);
+        _logger->debug("Accepted connection on descriptor {}", res);
+
+        if (isRunning) {
+            Receive(pc);
+        } else {
+            pc->_read_closed = true;
+            Release(pc);
+        }
+    } else if (res != -ECANCELED) {
+        _logger->error("Failed to accept socket: {}", strerror(-res));
+    }
+
+    if (!_accepting && isRunning) {
+        Accept();
+    }
+}
+
+// See Worker.h
+void Worker::OnReceive(Connection *pc, int res, uint32_t flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        pc->_receiving = false;
+    }
+
+    if (res > 0) {
+        uint16_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (!pc->_read_closed) {
+            pc->Process(_ring->Buffer(bid), res);
+        }
+        _ring->RecycleBuffer(bid);
+        Send(pc);
+    } else if (res == 0) {
+        _logger->debug("Connection closed");
+        pc->_read_closed = true;
+    } else if (res != -ENOBUFS && res != -ECANCELED) {
+        _logger->error("Failed to read from descriptor {}: {}", pc->_socket, strerror(-res));
+        pc->_read_closed = true;
+        pc->_failed = true;
+    }
+
+    // Receive terminates once buffers are exhausted, they are back on the next iteration
+    if (!pc->_receiving && !pc->_read_closed && isRunning) {
+        Receive(pc);
+    } else if (pc->_read_closed && pc->_receiving) {
+        Shutdown(pc);
+    }
+    Release(pc);
+}
+
+// See Worker.h
+void Worker::OnSend(Connection *pc, int res) {
+    pc->_sending--;
+
+    if (res >= 0) {
+        pc->Sent(res);
+    } else if (res != -ECANCELED) {
+        _logger->error("Failed to write response to client: {}", strerror(-res));
+        pc->_failed = true;
+        pc->_read_closed = true;
+        if (pc->_receiving) {
+            Shutdown(pc);
+        }
+    }
+
+    if (pc->_sending == 0) {
+        Send(pc);
+    }
+    Release(pc);
+}
+
+// See Worker.h
+void Worker::Shutdown(Connection *pc) {
+    pc->_read_closed = true;
+    if (pc->_receiving) {
+        Cancel(tag(pc, kReceive));
+    }
+}
+
+// See Worker.h
+void Worker::Release(Connection *pc) {
+    bool drained = pc->_failed || !pc->HasOutput();
+    if (!pc->_read_closed || pc->_receiving || pc->_sending > 0 || !drained) {
+        return;
+    }
+
+    _connections.erase(pc);
+    close(pc->_socket);
+    delete pc;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
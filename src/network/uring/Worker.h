@@ -0,0 +1,118 @@
+#ifndef AFINA_NETWORK_URING_WORKER_H
+#define AFINA_NETWORK_URING_WORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace Uring {
+
+class Connection;
+class Ring;
+
+/**
+ * # Thread running io_uring
+ * Each worker has private listening socket bound with SO_REUSEPORT, so kernel balances incoming
+ * connections between workers and they never share anything. All IO goes through the worker ring:
+ * - multishot accept on the listening socket
+ * - multishot receive into buffers from the ring of provided buffers
+ * - chain of linked sends for responses queued by connection
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    ~Worker();
+
+    /**
+     * Opens listening socket and spawns background thread serving it
+     */
+    void Start(uint16_t port);
+
+    /**
+     * Signal background thread to stop. After that thread stops to accept new connections and
+     * read new commands, once results of already read ones are sent it exits
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one for this worker is actually
+     * been destoryed
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+private:
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    // Submissions
+    void Accept();
+    void WaitEvent();
+    void Receive(Connection *pc);
+    void Send(Connection *pc);
+    void Cancel(uint64_t user_data);
+
+    // Completions
+    void OnAccept(int res, uint32_t flags);
+    void OnReceive(Connection *pc, int res, uint32_t flags);
+    void OnSend(Connection *pc, int res);
+
+    // Stops reading from connection, pending output is still sent. Connection must be released after
+    void Shutdown(Connection *pc);
+
+    // Destroys connection once there are no requests in flight for it
+    void Release(Connection *pc);
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // afina services
+    std::shared_ptr<Afina::Logging::Service> _pLogging;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Flag signals that thread should continue to operate
+    std::atomic<bool> isRunning;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+
+    // Socket to accept new connection on, private for this worker
+    int _server_socket;
+
+    // Multishot accept is armed
+    bool _accepting;
+
+    // Curstom event "device" used to wakeup worker
+    int _event_fd;
+    uint64_t _event_value;
+
+    std::unique_ptr<Ring> _ring;
+    std::unordered_set<Connection *> _connections;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+#endif // AFINA_NETWORK_URING_WORKER_H
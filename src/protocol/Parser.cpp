@@ -1,25 +1,184 @@
 #include "Parser.h"
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/ClientError.h>
 #include <afina/execute/Command.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Replace.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
+#include "Scanner.h"
+
 namespace Afina {
 namespace Protocol {
 
+namespace {
+
+// Moves to the next token of the line, false if there is no more non empty tokens
+inline bool Next(const char *&token, const char *&delimiter, const char *end) {
+    if (delimiter == end || *delimiter != ' ') {
+        return false;
+    }
+
+    token = delimiter + 1;
+    delimiter = FindDelimiter(token, end);
+    return delimiter != end && *delimiter != '\n' && delimiter != token;
+}
+
+// Parses decimal number of at most 10 digits, optionally negative
+inline bool Number(const char *begin, const char *end, bool sign, int64_t &out) {
+    bool negative = sign && begin < end && *begin == '-';
+    if (negative) {
+        begin++;
+    }
+
+    if (begin == end || end - begin > 10) {
+        return false;
+    }
+
+    int64_t result = 0;
+    for (; begin < end; begin++) {
+        if (*begin < '0' || *begin > '9') {
+            return false;
+        }
+        result = result * 10 + (*begin - '0');
+    }
+
+    out = negative ? -result : result;
+    return true;
+}
+
+} // namespace
+
+const size_t Parser::kMaxKeySize;
+
+// See Parse.h
+Parser::Command Parser::Lookup(const char *name, size_t size) {
+    struct Entry {
+        const char *name;
+        size_t size;
+        Command command;
+    };
+
+    // Known names placed by the hash (first + last + 3 * length) % 16, which has no collisions on them
+    static const Entry table[16] = {{"set", 3, Command::kSet},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {"get", 3, Command::kGet},
+                                    {"stats", 5, Command::kStats},
+                                    {"gets", 4, Command::kGets},
+                                    {"append", 6, Command::kAppend},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {"prepend", 7, Command::kPrepend},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {"replace", 7, Command::kReplace},
+                                    {nullptr, 0, Command::kUnknown},
+                                    {"add", 3, Command::kAdd},
+                                    {nullptr, 0, Command::kUnknown}};
+
+    if (size == 0) {
+        return Command::kUnknown;
+    }
+
+    const Entry &entry = table[(uint8_t(name[0]) + uint8_t(name[size - 1]) + 3 * size) % 16];
+    if (entry.size != size || std::memcmp(entry.name, name, size) != 0) {
+        return Command::kUnknown;
+    }
+    return entry.command;
+}
+
+// See Parse.h
+bool Parser::ParseLine(const char *input, const size_t size, size_t &parsed) {
+    const char *end = input + size;
+    const char *token = input;
+    const char *delimiter = FindDelimiter(token, end);
+    if (delimiter == end || *delimiter == '\n') {
+        return false;
+    }
+
+    const char *name_end = delimiter;
+    Command found = Lookup(token, delimiter - token);
+    int64_t line_flags = 0, line_exprtime = 0, line_bytes = 0;
+    switch (found) {
+    case Command::kSet:
+    case Command::kAdd:
+    case Command::kReplace:
+    case Command::kAppend:
+    case Command::kPrepend: {
+        // <command name> <key> <flags> <exptime> <bytes>\r\n
+        if (!Next(token, delimiter, end)) {
+            return false;
+        }
+        slices.push_back(Slice{token, size_t(delimiter - token)});
+
+        if (!Next(token, delimiter, end) || !Number(token, delimiter, false, line_flags) || line_flags > UINT32_MAX ||
+            !Next(token, delimiter, end) || !Number(token, delimiter, true, line_exprtime) ||
+            line_exprtime > INT32_MAX || line_exprtime < INT32_MIN || !Next(token, delimiter, end) ||
+            !Number(token, delimiter, false, line_bytes) || line_bytes > UINT32_MAX) {
+            slices.clear();
+            return false;
+        }
+        break;
+    }
+
+    case Command::kGet:
+    case Command::kGets: {
+        // <command name> <key>*\r\n
+        do {
+            if (!Next(token, delimiter, end)) {
+                slices.clear();
+                return false;
+            }
+            slices.push_back(Slice{token, size_t(delimiter - token)});
+        } while (*delimiter == ' ');
+        break;
+    }
+
+    case Command::kStats:
+        break;
+
+    default:
+        // Let state machine report the error
+        return false;
+    }
+
+    if (*delimiter != '\r' || delimiter + 1 == end || delimiter[1] != '\n') {
+        slices.clear();
+        return false;
+    }
+
+    name.assign(input, name_end - input);
+    command = found;
+    flags = static_cast<uint32_t>(line_flags);
+    exprtime = static_cast<int32_t>(line_exprtime);
+    bytes = static_cast<uint32_t>(line_bytes);
+
+    state = State::sLF;
+    parse_complete = true;
+    parsed = delimiter + 2 - input;
+    return true;
+}
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     size_t pos;
     parsed = 0;
 
+    if (mode == Mode::kVector && state == State::sName && name.empty() && ParseLine(input, size, parsed)) {
+        return true;
+    }
+
     for (pos = 0; pos < size && !parse_complete; pos++) {
         char c = input[pos];
         // std::cout << "[" << pos << "] '" << c << "': state=" << int(state) << std::endl;
@@ -28,11 +187,13 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::sName: {
             if (c == ' ' || c == '\r') {
                 // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
+                command = Lookup(name.data(), name.size());
+                if (command == Command::kSet || command == Command::kAdd || command == Command::kReplace ||
+                    command == Command::kAppend || command == Command::kPrepend) {
                     state = State::spKey;
-                } else if (name == "get" || name == "gets") {
+                } else if (command == Command::kGet || command == Command::kGets) {
                     state = State::sgKey;
-                } else if (name == "stats") {
+                } else if (command == Command::kStats) {
                     state = State::sLF;
                     continue;
                 } else {
@@ -66,6 +227,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 
                 curKey.clear();
                 state = State::sLF;
+                Slices();
             } else if (c == ' ') {
                 // std::cout << "parser debug: key[" << keys.size() << "]='" << curKey << "'" << std::endl;
                 state = State::sgKey;
@@ -109,19 +271,19 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
+                int64_t et = int64_t(exprtime) * 10;
                 if (negative) {
                     et -= (c - '0');
-                    if (et > exprtime) {
+                    if (et < INT32_MIN) {
                         throw std::runtime_error("Expire time field overflow");
                     }
                 } else {
                     et += (c - '0');
-                    if (et < exprtime) {
+                    if (et > INT32_MAX) {
                         throw std::runtime_error("Expire time field overflow");
                     }
                 }
-                exprtime = et;
+                exprtime = static_cast<int32_t>(et);
             }
             break;
         }
@@ -129,6 +291,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::spBytes: {
             if (c == '\r') {
                 state = State::sLF;
+                Slices();
                 // std::cout << "parser debug: bytes='" << bytes << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
                 uint32_t b = (bytes * 10) + (c - '0');
@@ -168,26 +331,51 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
     }
 
     body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
-        return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
+    for (auto &slice : slices) {
+        if (slice.size > kMaxKeySize) {
+            return std::unique_ptr<Execute::Command>(new Execute::ClientError("bad command line format"));
+        }
+    }
+
+    switch (command) {
+    case Command::kSet:
+        return std::unique_ptr<Execute::Command>(new Execute::Set(Key(0), flags, exprtime));
+    case Command::kAdd:
+        return std::unique_ptr<Execute::Command>(new Execute::Add(Key(0), flags, exprtime));
+    case Command::kReplace:
+        return std::unique_ptr<Execute::Command>(new Execute::Replace(Key(0), flags, exprtime));
+    case Command::kAppend:
+        return std::unique_ptr<Execute::Command>(new Execute::Append(Key(0), flags, exprtime));
+    case Command::kGet: {
+        std::vector<std::string> all;
+        all.reserve(slices.size());
+        for (size_t i = 0; i < slices.size(); i++) {
+            all.push_back(Key(i));
+        }
+        return std::unique_ptr<Execute::Command>(new Execute::Get(all));
+    }
+    case Command::kStats:
         return std::unique_ptr<Execute::Command>(new Execute::Stats());
-    } else {
+    default:
         throw std::runtime_error("Unsupported command");
     }
 }
 
+// See Parse.h
+void Parser::Slices() {
+    slices.clear();
+    for (auto &key : keys) {
+        slices.push_back(Slice{key.data(), key.size()});
+    }
+}
+
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
     name.clear();
+    command = Command::kUnknown;
     keys.clear();
+    slices.clear();
     curKey.clear();
     parse_complete = false;
     flags = 0;
@@ -17,19 +17,37 @@ namespace Protocol {
 /**
  * # Memcached protocol parser
  * Parser supports subset of memcached protocol
+ *
+ * In vector mode complete command line found in the input is split into tokens by the vector
+ * scanner and keys are kept as slices of the input buffer, so Build must be called before the
+ * buffer changes. Lines split between inputs and malformed ones are fed through the byte-by-byte
+ * state machine, which is the only path in scalar mode.
  */
 class Parser {
 public:
-    Parser() { Reset(); }
+    enum class Mode { kScalar, kVector };
+
+    /**
+     * Longest key protocol allows. Command with a longer key is built as ClientError, so storages
+     * never see such keys
+     */
+    static const size_t kMaxKeySize = 250;
+
+    Parser(Mode mode = Mode::kVector) : mode(mode) { Reset(); }
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from comulative input. In a such case method Build will return new command
      *
+     * Parser keeps a copy of the input, so string doesn't have to live until Build
+     *
      * @param input sttring to be added to the parsed input
      * @param parsed output parameter tells how many bytes was consumed from the string
      * @return true if command has been parsed out
      */
-    bool Parse(const std::string &input, size_t &parsed) { return Parse(&input[0], input.size(), parsed); }
+    bool Parse(const std::string &input, size_t &parsed) {
+        copy = input;
+        return Parse(&copy[0], copy.size(), parsed);
+    }
 
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
@@ -44,7 +62,8 @@ public:
 
     /**
      * Builds new command from parsed input. In case if it wasn't enough input to prse command out
-     * method return nullptr
+     * method return nullptr. Command breaking protocol limits is built as Execute::ClientError, body
+     * size is still set so that the body gets skipped
      */
     std::unique_ptr<Execute::Command> Build(size_t &body_size) const;
 
@@ -56,6 +75,35 @@ public:
     inline const std::string &Name() const { return name; }
 
 private:
+    // Commands parser knows about
+    enum class Command : uint8_t { kUnknown, kSet, kAdd, kReplace, kAppend, kPrepend, kGet, kGets, kStats };
+
+    // Key of the command, points either into the input buffer or into keys below
+    struct Slice {
+        const char *data;
+        size_t size;
+    };
+
+    /**
+     * Resolves command name by the perfect hash, returns kUnknown for unknown ones
+     */
+    static Command Lookup(const char *name, size_t size);
+
+    /**
+     * Parses complete well formed command line from the start of the input in one go. Returns false
+     * without changing anything if line is incomplete or is not well formed
+     */
+    bool ParseLine(const char *input, const size_t size, size_t &parsed);
+
+    // Makes slices of the keys collected by the state machine
+    void Slices();
+
+    inline std::string Key(size_t i) const { return std::string(slices[i].data, slices[i].size); }
+
+    Mode mode;
+
+    // Input passed as a string, keys could refer to it
+    std::string copy;
     /**
      * State of the command parser. Prefixes are:
      * - s: state for PUT and GET commands
@@ -69,7 +117,9 @@ private:
 
     // vrious fields of the command
     std::string name;
+    Command command;
     std::vector<std::string> keys;
+    std::vector<Slice> slices;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
     // the data and sends back when the item is retrieved. Clients may use this as a bit field to store data-specific
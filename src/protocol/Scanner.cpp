@@ -0,0 +1,122 @@
+#include "Scanner.h"
+
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AFINA_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace Afina {
+namespace Protocol {
+
+namespace {
+
+using Finder = const char *(*)(const char *, const char *);
+
+inline bool IsDelimiter(char c) { return c == ' ' || c == '\r' || c == '\n'; }
+
+const char *FindScalar(const char *p, const char *end) {
+    while (p < end && !IsDelimiter(*p)) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef AFINA_SCANNER_X86
+// Vector functions are compiled for their instruction set regardless of the build flags, the one
+// to run is chosen at runtime
+__attribute__((target("sse2"))) const char *FindSSE2(const char *p, const char *end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    for (; p + 16 <= end; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, cr)),
+                                   _mm_cmpeq_epi8(chunk, lf));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return FindScalar(p, end);
+}
+
+__attribute__((target("avx2"))) const char *FindAVX2(const char *p, const char *end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    for (; p + 32 <= end; p += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, cr)),
+                                      _mm256_cmpeq_epi8(chunk, lf));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    // Tail is shorter than the register, half of it still could be checked at once
+    return FindSSE2(p, end);
+}
+#endif // AFINA_SCANNER_X86
+
+} // namespace
+
+// See Scanner.h
+bool Supported(Isa isa) {
+    switch (isa) {
+    case Isa::kScalar:
+        return true;
+#ifdef AFINA_SCANNER_X86
+    case Isa::kSSE2:
+        return __builtin_cpu_supports("sse2");
+    case Isa::kAVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+// See Scanner.h
+const char *FindDelimiter(Isa isa, const char *begin, const char *end) {
+    switch (isa) {
+    case Isa::kScalar:
+        return FindScalar(begin, end);
+#ifdef AFINA_SCANNER_X86
+    case Isa::kSSE2:
+        return FindSSE2(begin, end);
+    case Isa::kAVX2:
+        return FindAVX2(begin, end);
+#endif
+    default:
+        throw std::runtime_error("Unsupported instruction set");
+    }
+}
+
+namespace {
+
+Finder Choose() {
+#ifdef AFINA_SCANNER_X86
+    if (Supported(Isa::kAVX2)) {
+        return FindAVX2;
+    } else if (Supported(Isa::kSSE2)) {
+        return FindSSE2;
+    }
+#endif
+    return FindScalar;
+}
+
+// Resolved once on load
+const Finder best = Choose();
+
+} // namespace
+
+// See Scanner.h
+const char *FindDelimiter(const char *begin, const char *end) { return best(begin, end); }
+
+} // namespace Protocol
+} // namespace Afina
@@ -0,0 +1,35 @@
+#ifndef AFINA_PROTOCOL_SCANNER_H
+#define AFINA_PROTOCOL_SCANNER_H
+
+#include <cstddef>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Delimiter scanner
+ * Command line consists of tokens separated by spaces and terminated by \r\n. Scanner looks for the
+ * end of the token comparing a whole vector register of input bytes at a time.
+ */
+enum class Isa { kScalar, kSSE2, kAVX2 };
+
+/**
+ * Returns true if current CPU could run given implementation
+ */
+bool Supported(Isa isa);
+
+/**
+ * Finds first space, \r or \n in [begin, end) using given implementation, which must be supported.
+ * Returns end if there is no such byte
+ */
+const char *FindDelimiter(Isa isa, const char *begin, const char *end);
+
+/**
+ * Same as above using the best implementation supported by the CPU
+ */
+const char *FindDelimiter(const char *begin, const char *end);
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_SCANNER_H
@@ -0,0 +1,264 @@
+#include "ARC.h"
+
+#include <algorithm>
+
+#include <afina/Statistics.h>
+
+namespace Afina {
+namespace Backend {
+
+// See ARC.h
+ARC::ARC(size_t max_size) : _max_size(max_size), _target(0) {}
+
+// See ARC.h
+bool ARC::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    entry *found = Lookup(key);
+    if (found != nullptr && !found->ghost()) {
+        Update(*found, value, ttl);
+    } else {
+        Admit(found, key, value, ttl);
+    }
+    return true;
+}
+
+// See ARC.h
+bool ARC::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    entry *found = Lookup(key);
+    if (found != nullptr && !found->ghost()) {
+        return false;
+    }
+    Admit(found, key, value, ttl);
+    return true;
+}
+
+// See ARC.h
+bool ARC::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    entry *found = Lookup(key);
+    if (found == nullptr || found->ghost()) {
+        return false;
+    }
+    Update(*found, value, ttl);
+    return true;
+}
+
+// See ARC.h
+bool ARC::Delete(const std::string &key) {
+    entry *found = Lookup(key);
+    if (found == nullptr || found->ghost()) {
+        return false;
+    }
+
+    Remove(*found);
+    return true;
+}
+
+// See ARC.h
+bool ARC::Get(const std::string &key, std::string &value) {
+    entry *found = Lookup(key);
+    if (found == nullptr || found->ghost()) {
+        return false;
+    }
+
+    // Any hit makes entry frequent
+    Unlink(*found);
+    Link(*found, kT2);
+    value = found->value;
+    return true;
+}
+
+// See ARC.h
+size_t ARC::Expire() {
+    return _wheel.Advance(ExpirationClock(), [this](TimerHook &hook) { Remove(static_cast<entry &>(hook)); });
+}
+
+// See ARC.h
+ARC::entry *ARC::Lookup(const std::string &key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+
+    entry &e = it->second;
+    if (!e.ghost() && e.Expired(ExpirationClock())) {
+        Remove(e);
+        return nullptr;
+    }
+    return &e;
+}
+
+// See ARC.h
+void ARC::Admit(entry *ghost, const std::string &key, const std::string &value, uint32_t ttl) {
+    size_t need = EntrySize(key.size(), value.size());
+    list &t1 = _lists[kT1], &b1 = _lists[kB1], &b2 = _lists[kB2];
+
+    entry *e = ghost;
+    List target_list = kT2;
+    bool b2_hit = false;
+    if (ghost != nullptr && ghost->list == kB1) {
+        // Recent entry was evicted too early, give T1 more room. The less B1 is compared to B2 the larger
+        // the step, as hit in a small list means more
+        size_t delta = (b2.size > b1.size && b1.size > 0) ? ghost->size * b2.size / b1.size : ghost->size;
+        _target = std::min(_max_size, _target + delta);
+        Unlink(*ghost);
+    } else if (ghost != nullptr) {
+        // Frequent entry was evicted too early, give T2 more room
+        size_t delta = (b1.size > b2.size && b2.size > 0) ? ghost->size * b1.size / b2.size : ghost->size;
+        _target = _target > delta ? _target - delta : 0;
+        b2_hit = true;
+        Unlink(*ghost);
+    } else {
+        target_list = kT1;
+
+        // Brand new key: T1 with its ghosts must stay within the memory limit
+        while (b1.head != nullptr && t1.size + b1.size + need > _max_size) {
+            Remove(*b1.head);
+        }
+        while (t1.head != nullptr && t1.size + need > _max_size) {
+            Statistics::Add(Statistics::kEvictions);
+            Remove(*t1.head);
+        }
+    }
+
+    MakeRoom(need, b2_hit);
+
+    if (e == nullptr) {
+        auto it = _entries.emplace(key, entry()).first;
+        e = &it->second;
+        e->key = &it->first;
+    }
+    e->value = value;
+    e->size = need;
+    Link(*e, target_list);
+
+    Schedule(*e, ttl);
+    TrimGhosts();
+}
+
+// See ARC.h
+void ARC::Update(entry &e, const std::string &value, uint32_t ttl) {
+    // Entry stays out of lists while room is made, so it can't be evicted itself
+    Unlink(e);
+    e.value = value;
+    e.size = EntrySize(e.key->size(), value.size());
+    MakeRoom(e.size, false);
+    Link(e, kT2);
+
+    if (ttl != kKeepTTL) {
+        Schedule(e, ttl);
+    }
+    TrimGhosts();
+}
+
+// See ARC.h
+void ARC::MakeRoom(size_t need, bool b2_hit) {
+    list &t1 = _lists[kT1], &t2 = _lists[kT2];
+    while (t1.head != nullptr || t2.head != nullptr) {
+        if (t1.size + t2.size + need <= _max_size) {
+            break;
+        }
+
+        // T1 gives up entry while it is over its target, on B2 hit it gives up even being right on it
+        bool from_t1 = t1.head != nullptr && (t2.head == nullptr || t1.size > _target || (b2_hit && t1.size == _target));
+        Evict(from_t1 ? *t1.head : *t2.head);
+    }
+}
+
+// See ARC.h
+void ARC::TrimGhosts() {
+    list &t1 = _lists[kT1], &t2 = _lists[kT2], &b1 = _lists[kB1], &b2 = _lists[kB2];
+    while (b1.head != nullptr && t1.size + b1.size > _max_size) {
+        Remove(*b1.head);
+    }
+
+    while (t1.size + t2.size + b1.size + b2.size > 2 * _max_size) {
+        entry *oldest = b2.head != nullptr ? b2.head : b1.head;
+        if (oldest == nullptr) {
+            break;
+        }
+        Remove(*oldest);
+    }
+}
+
+// See ARC.h
+void ARC::Link(entry &e, List l) {
+    list &to = _lists[l];
+    e.list = l;
+    e.prev = to.tail;
+    e.next = nullptr;
+    if (to.tail != nullptr) {
+        to.tail->next = &e;
+    } else {
+        to.head = &e;
+    }
+    to.tail = &e;
+    to.size += e.size;
+    to.items++;
+}
+
+// See ARC.h
+void ARC::Unlink(entry &e) {
+    list &from = _lists[e.list];
+    if (e.prev != nullptr) {
+        e.prev->next = e.next;
+    } else {
+        from.head = e.next;
+    }
+
+    if (e.next != nullptr) {
+        e.next->prev = e.prev;
+    } else {
+        from.tail = e.prev;
+    }
+
+    from.size -= e.size;
+    from.items--;
+    e.prev = e.next = nullptr;
+    e.list = kLists;
+}
+
+// See ARC.h
+void ARC::Evict(entry &e) {
+    // Expired entry is not an eviction and leaves no ghost, it is gone already
+    if (e.Expired(ExpirationClock())) {
+        Remove(e);
+        return;
+    }
+
+    Statistics::Add(Statistics::kEvictions);
+    List ghost = e.list == kT1 ? kB1 : kB2;
+    Unlink(e);
+    _wheel.Cancel(e);
+    std::string().swap(e.value);
+    Link(e, ghost);
+}
+
+// See ARC.h
+void ARC::Remove(entry &e) {
+    _wheel.Cancel(e);
+    if (e.list != kLists) {
+        Unlink(e);
+    }
+
+    _entries.erase(_entries.find(*e.key));
+}
+
+// See ARC.h
+void ARC::Schedule(entry &e, uint32_t ttl) { _wheel.Schedule(e, Deadline(ttl)); }
+
+} // namespace Backend
+} // namespace Afina
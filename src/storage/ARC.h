@@ -0,0 +1,146 @@
+#ifndef AFINA_STORAGE_ARC_H
+#define AFINA_STORAGE_ARC_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Adaptive replacement cache
+ * Resident entries live in two LRU lists: T1 holds entries accessed once since they got in, T2 ones
+ * accessed at least twice. Entries evicted from T1 and T2 leave their keys in ghost lists B1 and B2.
+ *
+ * Target size of T1 adapts to the workload: put of a key found in B1 means T1 was too small to keep it,
+ * so target grows; key found in B2 means T2 was too small, so target shrinks. Eviction takes LRU entry
+ * of T1 if T1 exceeds the target, otherwise of T2. Recency driven workload ends up with large T1,
+ * frequency driven one with large T2, and a scan never pushes out more than T1.
+ *
+ * Sizes are in bytes rather than entries: T1 + T2 never exceed max_size, ghost of an entry counts its
+ * former size, T1 + B1 stay within max_size and all four lists within twice max_size. Ghosts keep keys
+ * only, they don't take memory from the limit.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class ARC : public Afina::Storage {
+public:
+    ARC(size_t max_size = 1024);
+    ~ARC() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override {
+        items = _lists[kT1].items + _lists[kT2].items;
+        bytes = _lists[kT1].size + _lists[kT2].size;
+    }
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed
+     */
+    size_t Expire();
+
+    /**
+     * Current target size of T1 in bytes
+     */
+    inline size_t target() const { return _target; }
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size) { return key_size + value_size; }
+
+private:
+    enum List { kT1, kT2, kB1, kB2, kLists };
+
+    struct entry;
+
+    // LRU list: head is the least recently used entry
+    struct list {
+        entry *head = nullptr;
+        entry *tail = nullptr;
+        size_t size = 0;
+        size_t items = 0;
+    };
+
+    struct entry : public TimerHook {
+        // Key lives in the index, entry is its value
+        const std::string *key = nullptr;
+
+        // Empty for ghosts
+        std::string value;
+
+        // Size counted in the list, ghost keeps the one it had while resident
+        size_t size = 0;
+        List list = kLists;
+
+        entry *prev = nullptr;
+        entry *next = nullptr;
+
+        inline bool ghost() const { return list == kB1 || list == kB2; }
+    };
+
+    // Entry of the key, resident or ghost. Expired one gets removed on the way
+    entry *Lookup(const std::string &key);
+
+    // Stores value for the key which is not resident, entry is the ghost of the key if any
+    void Admit(entry *ghost, const std::string &key, const std::string &value, uint32_t ttl);
+
+    // Replaces value of resident entry and counts it as access
+    void Update(entry &e, const std::string &value, uint32_t ttl);
+
+    // Moves entries out of T1 and T2 into ghost lists until there is room for given number of bytes,
+    // b2_hit tells that room is made for the key just found in B2
+    void MakeRoom(size_t need, bool b2_hit);
+
+    // Drops the oldest ghosts until ghost lists fit their limits
+    void TrimGhosts();
+
+    // List maintenance
+    void Link(entry &e, List l);
+    void Unlink(entry &e);
+
+    // Turns resident entry into a ghost, eviction is counted in statistics
+    void Evict(entry &e);
+
+    // Removes entry from everywhere and releases it
+    void Remove(entry &e);
+
+    void Schedule(entry &e, uint32_t ttl);
+
+    std::size_t _max_size;
+
+    // Target size of T1
+    std::size_t _target;
+
+    list _lists[kLists];
+
+    std::unordered_map<std::string, entry> _entries;
+
+    // Expiration timers of the resident entries which have TTL
+    TimingWheel _wheel;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ARC_H
@@ -0,0 +1,248 @@
+#include "ClockLRU.h"
+
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include <afina/Statistics.h>
+
+namespace Afina {
+namespace Backend {
+
+// See ClockLRU.h
+ClockLRU::ClockLRU(size_t max_size)
+    : _max_size(max_size), _size_now(0), _hand(nullptr), _reaper([this]() { Expire(); }) {}
+
+// See ClockLRU.h
+bool ClockLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    ExpireLocked();
+
+    entry *found = Lookup(key);
+    if (found != nullptr) {
+        Update(*found, value, ttl);
+    } else {
+        Insert(key, value, ttl);
+    }
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    ExpireLocked();
+
+    if (Lookup(key) != nullptr) {
+        return false;
+    }
+    Insert(key, value, ttl);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    ExpireLocked();
+
+    entry *found = Lookup(key);
+    if (found == nullptr) {
+        return false;
+    }
+    Update(*found, value, ttl);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Delete(const std::string &key) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    entry *found = Lookup(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    Remove(*found);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::string &value) {
+    Concurrency::SharedLock lock(_mutex);
+    entry *found = Find(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    Reference(*found);
+    value = *found->value;
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::GetShared(const std::string &key, SharedValue &value) {
+    Concurrency::SharedLock lock(_mutex);
+    entry *found = Find(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    Reference(*found);
+    value = found->value;
+    return true;
+}
+
+// See ClockLRU.h
+size_t ClockLRU::GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) {
+    Concurrency::SharedLock lock(_mutex);
+    values.resize(keys.size());
+    size_t found = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        entry *e = Find(*keys[i]);
+        if (e != nullptr) {
+            Reference(*e);
+            values[i] = e->value;
+            found++;
+        } else {
+            values[i].reset();
+        }
+    }
+    return found;
+}
+
+// See ClockLRU.h
+void ClockLRU::Usage(size_t &items, size_t &bytes) {
+    Concurrency::SharedLock lock(_mutex);
+    items = _entries.size();
+    bytes = _size_now;
+}
+
+// See ClockLRU.h
+size_t ClockLRU::Expire() {
+    std::lock_guard<Concurrency::SharedMutex> lock(_mutex);
+    return ExpireLocked();
+}
+
+// See ClockLRU.h
+size_t ClockLRU::ExpireLocked() {
+    return _wheel.Advance(ExpirationClock(), [this](TimerHook &hook) { Remove(static_cast<entry &>(hook)); });
+}
+
+// See ClockLRU.h
+ClockLRU::entry *ClockLRU::Find(const std::string &key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end() || it->second.Expired(ExpirationClock())) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+// See ClockLRU.h
+ClockLRU::entry *ClockLRU::Lookup(const std::string &key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+
+    entry &e = it->second;
+    if (e.Expired(ExpirationClock())) {
+        Remove(e);
+        return nullptr;
+    }
+    return &e;
+}
+
+// See ClockLRU.h
+void ClockLRU::Insert(const std::string &key, const std::string &value, uint32_t ttl) {
+    MakeRoom(EntrySize(key.size(), value.size()));
+
+    auto it = _entries.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+    entry &e = it->second;
+    e.key = &it->first;
+    e.value = std::make_shared<const std::string>(value);
+    _size_now += e.footprint();
+
+    // Right behind the hand, that is the last place it comes to
+    if (_hand == nullptr) {
+        e.prev = e.next = &e;
+        _hand = &e;
+    } else {
+        e.next = _hand;
+        e.prev = _hand->prev;
+        _hand->prev->next = &e;
+        _hand->prev = &e;
+    }
+
+    _wheel.Schedule(e, Deadline(ttl));
+}
+
+// See ClockLRU.h
+void ClockLRU::Update(entry &e, const std::string &value, uint32_t ttl) {
+    // Update is an access too, entry itself stays out of the sweep while room is made for the new value
+    Reference(e);
+    size_t old_size = e.value->size();
+    if (value.size() > old_size) {
+        MakeRoom(value.size() - old_size, &e);
+    }
+
+    // Readers may still hold the old buffer, so it is replaced rather than changed
+    e.value = std::make_shared<const std::string>(value);
+    _size_now = _size_now - old_size + value.size();
+    if (ttl != kKeepTTL) {
+        _wheel.Schedule(e, Deadline(ttl));
+    }
+}
+
+// See ClockLRU.h
+void ClockLRU::MakeRoom(size_t need, const entry *pinned) {
+    while (_hand != nullptr && _size_now + need > _max_size) {
+        entry &candidate = *_hand;
+        if (&candidate == pinned) {
+            _hand = candidate.next;
+            continue;
+        }
+
+        if (candidate.referenced.load(std::memory_order_relaxed)) {
+            candidate.referenced.store(false, std::memory_order_relaxed);
+            _hand = candidate.next;
+            continue;
+        }
+
+        // Expired entry is not an eviction, it is gone already
+        if (!candidate.Expired(ExpirationClock())) {
+            Statistics::Add(Statistics::kEvictions);
+        }
+        Remove(candidate);
+    }
+}
+
+// See ClockLRU.h
+void ClockLRU::Remove(entry &e) {
+    _size_now -= e.footprint();
+    _wheel.Cancel(e);
+
+    if (e.next == &e) {
+        _hand = nullptr;
+    } else {
+        e.prev->next = e.next;
+        e.next->prev = e.prev;
+        if (_hand == &e) {
+            _hand = e.next;
+        }
+    }
+
+    _entries.erase(_entries.find(*e.key));
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,138 @@
+#ifndef AFINA_STORAGE_CLOCK_LRU_H
+#define AFINA_STORAGE_CLOCK_LRU_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/SharedMutex.h>
+
+#include "Reaper.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK approximation of LRU
+ * Entries form a ring with a hand pointing to the next eviction candidate. Access doesn't move entry
+ * anywhere, it only sets reference bit of the entry. When memory is needed hand goes around the ring:
+ * entry with the bit set gets its bit cleared and a second chance, the first one found without the bit
+ * is evicted. New entry is put right behind the hand, so it is visited last.
+ *
+ * As reads change nothing but the atomic bit, they run in parallel holding the lock shared. Writes and
+ * eviction take it exclusive. Values are kept in shared buffers, so GetShared doesn't copy.
+ *
+ * Expired entry is invisible for readers, it is removed by the next writer touching it or by background
+ * reaper.
+ */
+class ClockLRU : public Afina::Storage {
+public:
+    ClockLRU(size_t max_size = 1024);
+    ~ClockLRU() {}
+
+    // Starts reclaiming of expired entries in background
+    void Start() override { _reaper.Start(); }
+
+    // see Start
+    void Stop() override { _reaper.Stop(); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetShared(const std::string &key, SharedValue &value) override;
+
+    // Implements Afina::Storage interface, lock is taken once for all keys
+    size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override;
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed
+     */
+    size_t Expire();
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size) { return key_size + value_size; }
+
+private:
+    struct entry : public TimerHook {
+        // Key lives in the index, entry is its value
+        const std::string *key = nullptr;
+        SharedValue value;
+
+        // Set by readers, cleared by the hand
+        std::atomic<bool> referenced{false};
+
+        // Neighbours in the ring
+        entry *prev = nullptr;
+        entry *next = nullptr;
+
+        inline size_t footprint() const { return EntrySize(key->size(), value->size()); }
+    };
+
+    // Live entry for the key, lock must be held at least shared
+    entry *Find(const std::string &key);
+
+    // Same as Find, but removes expired entry, lock must be held exclusive
+    entry *Lookup(const std::string &key);
+
+    // Marks entry as accessed
+    static inline void Reference(entry &e) {
+        // Bit is mostly set already for hot entries, plain load keeps their cache line shared
+        if (!e.referenced.load(std::memory_order_relaxed)) {
+            e.referenced.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void Insert(const std::string &key, const std::string &value, uint32_t ttl);
+    void Update(entry &e, const std::string &value, uint32_t ttl);
+
+    // Turns the hand until there is room for the given number of bytes, pinned entry is never evicted
+    void MakeRoom(size_t need, const entry *pinned = nullptr);
+
+    // Removes entry from the ring and the index
+    void Remove(entry &e);
+
+    size_t ExpireLocked();
+
+    std::size_t _max_size;
+    std::size_t _size_now;
+
+    // Next candidate for eviction, nullptr when ring is empty
+    entry *_hand;
+
+    std::unordered_map<std::string, entry> _entries;
+
+    // Expiration timers of the entries which have TTL
+    TimingWheel _wheel;
+
+    Concurrency::SharedMutex _mutex;
+
+    // Must be destroyed first, it calls back into the storage
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_LRU_H
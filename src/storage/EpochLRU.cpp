@@ -0,0 +1,320 @@
+#include "EpochLRU.h"
+
+#include <functional>
+
+#include <afina/Statistics.h>
+
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Bounds of the table size
+const size_t kMinBuckets = 16;
+const size_t kMaxBuckets = size_t(1) << 24;
+
+} // namespace
+
+const size_t EpochLRU::kExpectedEntrySize;
+
+// See EpochLRU.h
+EpochLRU::version::version(const std::string &value, uint32_t ttl)
+    : data(std::make_shared<const std::string>(value)), deadline(Deadline(ttl)) {}
+
+// See EpochLRU.h
+EpochLRU::EpochLRU(size_t max_size)
+    : _max_size(max_size), _size_now(0), _items(0), _hand(0), _reaper([this]() { Expire(); }) {
+    size_t buckets = kMinBuckets;
+    while (buckets < kMaxBuckets && buckets * kExpectedEntrySize < max_size) {
+        buckets *= 2;
+    }
+
+    _buckets.reset(new bucket[buckets]);
+    _mask = buckets - 1;
+}
+
+// See EpochLRU.h
+EpochLRU::~EpochLRU() {
+    // Reaper must not touch entries being destroyed
+    _reaper.Stop();
+
+    for (size_t i = 0; i <= _mask; i++) {
+        node *n = _buckets[i].head.load(std::memory_order_relaxed);
+        while (n != nullptr) {
+            node *next = n->next.load(std::memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+    }
+}
+
+// See EpochLRU.h
+bool EpochLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    uint32_t hash = Hash(key);
+    bucket &b = Bucket(hash);
+    {
+        std::lock_guard<std::mutex> lock(b.lock);
+        node *found = Lookup(b, key, hash);
+        if (found != nullptr) {
+            Replace(*found, value, ttl);
+        } else {
+            Insert(b, key, hash, value, ttl);
+        }
+    }
+
+    MakeRoom();
+    return true;
+}
+
+// See EpochLRU.h
+bool EpochLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    uint32_t hash = Hash(key);
+    bucket &b = Bucket(hash);
+    {
+        std::lock_guard<std::mutex> lock(b.lock);
+        node *found = Lookup(b, key, hash);
+        if (found == nullptr) {
+            Insert(b, key, hash, value, ttl);
+        } else if (found->value.load(std::memory_order_relaxed)->Expired(ExpirationClock())) {
+            // Expired association is absent, entry is reused
+            Replace(*found, value, ttl);
+        } else {
+            return false;
+        }
+    }
+
+    MakeRoom();
+    return true;
+}
+
+// See EpochLRU.h
+bool EpochLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    uint32_t hash = Hash(key);
+    bucket &b = Bucket(hash);
+    {
+        std::lock_guard<std::mutex> lock(b.lock);
+        node *found = Lookup(b, key, hash);
+        if (found == nullptr || found->value.load(std::memory_order_relaxed)->Expired(ExpirationClock())) {
+            return false;
+        }
+        Replace(*found, value, ttl);
+    }
+
+    MakeRoom();
+    return true;
+}
+
+// See EpochLRU.h
+bool EpochLRU::Delete(const std::string &key) {
+    uint32_t hash = Hash(key);
+    bucket &b = Bucket(hash);
+    std::lock_guard<std::mutex> lock(b.lock);
+
+    node *found = Lookup(b, key, hash);
+    if (found == nullptr) {
+        return false;
+    }
+
+    bool expired = found->value.load(std::memory_order_relaxed)->Expired(ExpirationClock());
+    Unlink(b, *found);
+    return !expired;
+}
+
+// See EpochLRU.h
+bool EpochLRU::Get(const std::string &key, std::string &value) {
+    Concurrency::EpochManager::Guard guard(_epoch);
+    const version *found = Find(key, Hash(key));
+    if (found == nullptr) {
+        return false;
+    }
+
+    value = *found->data;
+    return true;
+}
+
+// See EpochLRU.h
+bool EpochLRU::GetShared(const std::string &key, SharedValue &value) {
+    Concurrency::EpochManager::Guard guard(_epoch);
+    const version *found = Find(key, Hash(key));
+    if (found == nullptr) {
+        return false;
+    }
+
+    value = found->data;
+    return true;
+}
+
+// See EpochLRU.h
+size_t EpochLRU::GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) {
+    Concurrency::EpochManager::Guard guard(_epoch);
+    values.resize(keys.size());
+    size_t found = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const version *v = Find(*keys[i], Hash(*keys[i]));
+        if (v != nullptr) {
+            values[i] = v->data;
+            found++;
+        } else {
+            values[i].reset();
+        }
+    }
+    return found;
+}
+
+// See EpochLRU.h
+size_t EpochLRU::Expire() {
+    uint32_t now = ExpirationClock();
+    size_t removed = 0;
+    for (size_t i = 0; i <= _mask; i++) {
+        bucket &b = _buckets[i];
+        if (b.head.load(std::memory_order_relaxed) == nullptr) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(b.lock);
+        node *n = b.head.load(std::memory_order_relaxed);
+        while (n != nullptr) {
+            node *next = n->next.load(std::memory_order_relaxed);
+            if (n->value.load(std::memory_order_relaxed)->Expired(now)) {
+                Unlink(b, *n);
+                removed++;
+            }
+            n = next;
+        }
+    }
+    return removed;
+}
+
+// See EpochLRU.h
+uint32_t EpochLRU::Hash(const std::string &key) {
+    uint64_t hash = std::hash<std::string>()(key);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// See EpochLRU.h
+const EpochLRU::version *EpochLRU::Find(const std::string &key, uint32_t hash) {
+    node *n = Bucket(hash).head.load(std::memory_order_acquire);
+    for (; n != nullptr; n = n->next.load(std::memory_order_acquire)) {
+        if (n->hash != hash || n->key != key) {
+            continue;
+        }
+
+        const version *v = n->value.load(std::memory_order_acquire);
+        if (v->Expired(ExpirationClock())) {
+            return nullptr;
+        }
+
+        // Bit is mostly set already for hot entries, plain load keeps their cache line shared
+        if (!n->referenced.load(std::memory_order_relaxed)) {
+            n->referenced.store(true, std::memory_order_relaxed);
+        }
+        return v;
+    }
+    return nullptr;
+}
+
+// See EpochLRU.h
+EpochLRU::node *EpochLRU::Lookup(bucket &b, const std::string &key, uint32_t hash) {
+    for (node *n = b.head.load(std::memory_order_relaxed); n != nullptr; n = n->next.load(std::memory_order_relaxed)) {
+        if (n->hash == hash && n->key == key) {
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+// See EpochLRU.h
+void EpochLRU::Insert(bucket &b, const std::string &key, uint32_t hash, const std::string &value, uint32_t ttl) {
+    node *n = new node(key, hash, new version(value, ttl));
+    n->next.store(b.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    // Entry is complete before readers could find it
+    b.head.store(n, std::memory_order_release);
+
+    _size_now.fetch_add(n->footprint(), std::memory_order_relaxed);
+    _items.fetch_add(1, std::memory_order_relaxed);
+}
+
+// See EpochLRU.h
+void EpochLRU::Replace(node &n, const std::string &value, uint32_t ttl) {
+    // Writers are serialized by the bucket lock, so current version is stable here
+    version *fresh = new version(value, ttl);
+    if (ttl == kKeepTTL) {
+        fresh->deadline = n.value.load(std::memory_order_relaxed)->deadline;
+    }
+    version *old = n.value.exchange(fresh, std::memory_order_acq_rel);
+    _size_now.fetch_add(value.size(), std::memory_order_relaxed);
+    _size_now.fetch_sub(old->data->size(), std::memory_order_relaxed);
+    n.referenced.store(true, std::memory_order_relaxed);
+
+    _epoch.Retire(old);
+}
+
+// See EpochLRU.h
+void EpochLRU::Unlink(bucket &b, node &n) {
+    std::atomic<node *> *link = &b.head;
+    while (link->load(std::memory_order_relaxed) != &n) {
+        link = &link->load(std::memory_order_relaxed)->next;
+    }
+
+    // Readers standing on the entry still see the rest of the chain through its next
+    link->store(n.next.load(std::memory_order_relaxed), std::memory_order_release);
+
+    _size_now.fetch_sub(n.footprint(), std::memory_order_relaxed);
+    _items.fetch_sub(1, std::memory_order_relaxed);
+    _epoch.Retire(&n);
+}
+
+// See EpochLRU.h
+void EpochLRU::MakeRoom() {
+    if (_size_now.load(std::memory_order_relaxed) <= _max_size) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> evict_lock(_evict_mutex);
+
+    // Readers could keep setting bits, after two full turns hand takes entries regardless
+    size_t visited = 0;
+    while (_size_now.load(std::memory_order_relaxed) > _max_size) {
+        bool force = visited++ >= 2 * (_mask + 1);
+        bucket &b = _buckets[_hand];
+        _hand = (_hand + 1) & _mask;
+
+        if (b.head.load(std::memory_order_relaxed) == nullptr) {
+            continue;
+        }
+
+        uint32_t now = ExpirationClock();
+        std::lock_guard<std::mutex> lock(b.lock);
+        node *n = b.head.load(std::memory_order_relaxed);
+        while (n != nullptr && _size_now.load(std::memory_order_relaxed) > _max_size) {
+            node *next = n->next.load(std::memory_order_relaxed);
+            bool expired = n->value.load(std::memory_order_relaxed)->Expired(now);
+            if (force || expired || !n->referenced.exchange(false, std::memory_order_relaxed)) {
+                // Expired entry is not an eviction, it is gone already
+                if (!expired) {
+                    Statistics::Add(Statistics::kEvictions);
+                }
+                Unlink(b, *n);
+            }
+            n = next;
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,159 @@
+#ifndef AFINA_STORAGE_EPOCH_LRU_H
+#define AFINA_STORAGE_EPOCH_LRU_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Epoch.h>
+
+#include "Reaper.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage with lock free reads
+ * Hash table of chained buckets. Readers take no locks at all: they walk chains following atomic
+ * pointers inside epoch critical section, see Concurrency::EpochManager. Writers take the lock of the
+ * bucket only, so writers of different buckets don't contend either.
+ *
+ * Value is an immutable version object, update publishes new version by atomic swap of the pointer,
+ * removal unlinks entry from the chain. Old version and unlinked entry are retired and destroyed once
+ * no reader could see them anymore.
+ *
+ * Memory limit is kept by CLOCK over the buckets: read sets reference bit of the entry, hand goes
+ * bucket by bucket clearing bits and evicting entries which have none. Limit is soft: writer puts
+ * entry first and makes room after, so concurrent writers could exceed it for a moment.
+ *
+ * Table doesn't grow, number of buckets is chosen from the memory limit. Expired entries are invisible
+ * for readers, they are removed by writers, by the hand and by background reaper going through the
+ * whole table.
+ */
+class EpochLRU : public Afina::Storage {
+public:
+    // Average entry size assumed to choose number of buckets
+    static const size_t kExpectedEntrySize = 64;
+
+    EpochLRU(size_t max_size = 1024);
+    ~EpochLRU();
+
+    // Starts reclaiming of expired entries in background
+    void Start() override { _reaper.Start(); }
+
+    // see Start
+    void Stop() override { _reaper.Stop(); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetShared(const std::string &key, SharedValue &value) override;
+
+    // Implements Afina::Storage interface, all keys are looked up in a single critical section
+    size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override {
+        items = _items.load(std::memory_order_relaxed);
+        bytes = _size_now.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed
+     */
+    size_t Expire();
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size) { return key_size + value_size; }
+
+private:
+    // Value of the entry, never changes once published
+    struct version {
+        version(const std::string &value, uint32_t ttl);
+
+        inline bool Expired(uint32_t now) const { return deadline != 0 && deadline <= now; }
+
+        SharedValue data;
+        uint32_t deadline;
+    };
+
+    struct node {
+        node(const std::string &key, uint32_t hash, version *value) : key(key), hash(hash), value(value) {}
+        ~node() { delete value.load(std::memory_order_relaxed); }
+
+        inline size_t footprint() const { return EntrySize(key.size(), value.load(std::memory_order_relaxed)->data->size()); }
+
+        const std::string key;
+        const uint32_t hash;
+        std::atomic<version *> value;
+        std::atomic<node *> next{nullptr};
+
+        // Set by readers, cleared by the hand
+        std::atomic<bool> referenced{true};
+    };
+
+    struct bucket {
+        std::atomic<node *> head{nullptr};
+
+        // Writers only
+        std::mutex lock;
+    };
+
+    static uint32_t Hash(const std::string &key);
+
+    inline bucket &Bucket(uint32_t hash) { return _buckets[hash & _mask]; }
+
+    // Live version of the key, must be called inside critical section
+    const version *Find(const std::string &key, uint32_t hash);
+
+    // Entry of the key in the bucket, live or expired. Bucket lock must be held
+    node *Lookup(bucket &b, const std::string &key, uint32_t hash);
+
+    // Following functions change the bucket, its lock must be held
+    void Insert(bucket &b, const std::string &key, uint32_t hash, const std::string &value, uint32_t ttl);
+    void Replace(node &n, const std::string &value, uint32_t ttl);
+    void Unlink(bucket &b, node &n);
+
+    // Turns the hand until memory limit is kept, bucket locks must not be held
+    void MakeRoom();
+
+    std::size_t _max_size;
+    std::atomic<size_t> _size_now;
+    std::atomic<size_t> _items;
+
+    std::unique_ptr<bucket[]> _buckets;
+    size_t _mask;
+
+    // Guards clock hand, only one thread turns it at a time
+    std::mutex _evict_mutex;
+    size_t _hand;
+
+    Concurrency::EpochManager _epoch;
+
+    // Must be destroyed first, it calls back into the storage
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_EPOCH_LRU_H
@@ -0,0 +1,121 @@
+#include "FlatCombineLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+// See FlatCombineLRU.h
+FlatCombineLRU::FlatCombineLRU(size_t max_size)
+    : _storage(max_size), _reaper([this]() {
+          Operation op(_storage, Operation::Type::kExpire);
+          _combine.Apply(op);
+      }) {}
+
+// See FlatCombineLRU.h
+void FlatCombineLRU::Start() { _reaper.Start(); }
+
+// See FlatCombineLRU.h
+void FlatCombineLRU::Stop() { _reaper.Stop(); }
+
+// See FlatCombineLRU.h
+void FlatCombineLRU::Operation::operator()() {
+    switch (type) {
+    case Type::kPut:
+        result = storage.Put(*key, *value, ttl);
+        break;
+    case Type::kPutIfAbsent:
+        result = storage.PutIfAbsent(*key, *value, ttl);
+        break;
+    case Type::kSet:
+        result = storage.Set(*key, *value, ttl);
+        break;
+    case Type::kDelete:
+        result = storage.Delete(*key);
+        break;
+    case Type::kGet:
+        result = storage.Get(*key, *out);
+        break;
+    case Type::kGetShared:
+        result = storage.GetShared(*key, *shared);
+        break;
+    case Type::kGetSharedMany:
+        found = storage.GetSharedMany(*keys, *values);
+        break;
+    case Type::kUsage:
+        storage.Usage(*items, *bytes);
+        break;
+    case Type::kExpire:
+        storage.Expire();
+        break;
+    }
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::Apply(Operation::Type type, const std::string &key, const std::string &value, uint32_t ttl) {
+    Operation op(_storage, type);
+    op.key = &key;
+    op.value = &value;
+    op.ttl = ttl;
+    _combine.Apply(op);
+    return op.result;
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    return Apply(Operation::Type::kPut, key, value, ttl);
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    return Apply(Operation::Type::kPutIfAbsent, key, value, ttl);
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    return Apply(Operation::Type::kSet, key, value, ttl);
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::Delete(const std::string &key) {
+    Operation op(_storage, Operation::Type::kDelete);
+    op.key = &key;
+    _combine.Apply(op);
+    return op.result;
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::Get(const std::string &key, std::string &value) {
+    Operation op(_storage, Operation::Type::kGet);
+    op.key = &key;
+    op.out = &value;
+    _combine.Apply(op);
+    return op.result;
+}
+
+// See FlatCombineLRU.h
+bool FlatCombineLRU::GetShared(const std::string &key, SharedValue &value) {
+    Operation op(_storage, Operation::Type::kGetShared);
+    op.key = &key;
+    op.shared = &value;
+    _combine.Apply(op);
+    return op.result;
+}
+
+// See FlatCombineLRU.h
+size_t FlatCombineLRU::GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) {
+    Operation op(_storage, Operation::Type::kGetSharedMany);
+    op.keys = &keys;
+    op.values = &values;
+    _combine.Apply(op);
+    return op.found;
+}
+
+// See FlatCombineLRU.h
+void FlatCombineLRU::Usage(size_t &items, size_t &bytes) {
+    Operation op(_storage, Operation::Type::kUsage);
+    op.items = &items;
+    op.bytes = &bytes;
+    _combine.Apply(op);
+}
+
+} // namespace Backend
+} // namespace Afina
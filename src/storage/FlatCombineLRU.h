@@ -0,0 +1,103 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/FlatCombine.h>
+
+#include "Reaper.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Flat combining SimpleLRU
+ * Single SimpleLRU which operations are applied by flat combining instead of a global lock: whoever
+ * gets combiner role applies operations of all waiting threads in one batch. Works best when a few
+ * hot keys make all threads contend on the same data, LRU list and index stay in cache of the combiner
+ * core instead of moving between cores along with a mutex.
+ *
+ * Global LRU order and memory limit are the same as of SimpleLRU.
+ */
+class FlatCombineLRU : public Afina::Storage {
+public:
+    FlatCombineLRU(size_t max_size = 1024);
+    ~FlatCombineLRU() {}
+
+    // Starts reclaiming of expired entries in background
+    void Start() override;
+
+    // see Start
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetShared(const std::string &key, SharedValue &value) override;
+
+    // Implements Afina::Storage interface, all keys are looked up by a single operation
+    size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override;
+
+    // see SimpleLRU.h
+    static size_t EntrySize(size_t key_size, size_t value_size) { return SimpleLRU::EntrySize(key_size, value_size); }
+
+private:
+    // Storage call published for the combiner, arguments are referenced from the caller stack
+    struct Operation {
+        enum class Type { kPut, kPutIfAbsent, kSet, kDelete, kGet, kGetShared, kGetSharedMany, kUsage, kExpire };
+
+        Operation(SimpleLRU &storage, Type type) : storage(storage), type(type) {}
+
+        // Called by the combiner
+        void operator()();
+
+        SimpleLRU &storage;
+        Type type;
+
+        const std::string *key = nullptr;
+        const std::string *value = nullptr;
+        uint32_t ttl = 0;
+
+        std::string *out = nullptr;
+        SharedValue *shared = nullptr;
+        const std::vector<const std::string *> *keys = nullptr;
+        std::vector<SharedValue> *values = nullptr;
+        size_t found = 0;
+        size_t *items = nullptr;
+        size_t *bytes = nullptr;
+
+        bool result = false;
+    };
+
+    bool Apply(Operation::Type type, const std::string &key, const std::string &value, uint32_t ttl);
+
+    SimpleLRU _storage;
+    Concurrency::FlatCombine<Operation> _combine;
+
+    // Must be destroyed first, it calls back into the storage
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
@@ -0,0 +1,98 @@
+#include "FrequencySketch.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Seeds of the hash functions, one per row
+const uint64_t kSeeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+
+// Lowest bits of every 4-bit counter cleared
+const uint64_t kResetMask = 0x7777777777777777ULL;
+
+} // namespace
+
+const uint32_t FrequencySketch::kMaxCount;
+
+// See FrequencySketch.h
+FrequencySketch::FrequencySketch(size_t capacity) { Resize(capacity); }
+
+// See FrequencySketch.h
+void FrequencySketch::EnsureCapacity(size_t capacity) {
+    if (capacity > this->capacity()) {
+        Resize(capacity);
+    }
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Resize(size_t capacity) {
+    // Counter per key in each row, rounded up to the power of two
+    size_t words = 1;
+    while (words * kCountersPerWord < capacity * kDepth) {
+        words *= 2;
+    }
+
+    _table.assign(words, 0);
+    _mask = words * kCountersPerWord - 1;
+    _additions = 0;
+    _sample_size = 10 * std::max<size_t>(capacity, 1);
+}
+
+// See FrequencySketch.h
+size_t FrequencySketch::Index(uint32_t hash, size_t row) const {
+    uint64_t h = (uint64_t(hash) + kSeeds[row]) * kSeeds[(row + 1) % kDepth];
+    return (h ^ (h >> 32)) & _mask;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Increment(uint32_t hash) {
+    size_t index[kDepth];
+    uint32_t min = kMaxCount;
+    for (size_t row = 0; row < kDepth; row++) {
+        index[row] = Index(hash, row);
+        uint32_t count = (_table[index[row] / kCountersPerWord] >> (4 * (index[row] % kCountersPerWord))) & 0xF;
+        min = std::min(min, count);
+    }
+
+    if (min == kMaxCount) {
+        return;
+    }
+
+    // Conservative update: only the smallest counters grow, that keeps overestimation down
+    for (size_t row = 0; row < kDepth; row++) {
+        uint64_t &word = _table[index[row] / kCountersPerWord];
+        size_t shift = 4 * (index[row] % kCountersPerWord);
+        if (((word >> shift) & 0xF) == min) {
+            word += uint64_t(1) << shift;
+        }
+    }
+
+    if (++_additions >= _sample_size) {
+        Age();
+    }
+}
+
+// See FrequencySketch.h
+uint32_t FrequencySketch::Estimate(uint32_t hash) const {
+    uint32_t min = kMaxCount;
+    for (size_t row = 0; row < kDepth; row++) {
+        size_t index = Index(hash, row);
+        uint32_t count = (_table[index / kCountersPerWord] >> (4 * (index % kCountersPerWord))) & 0xF;
+        min = std::min(min, count);
+    }
+    return min;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Age() {
+    for (uint64_t &word : _table) {
+        word = (word >> 1) & kResetMask;
+    }
+    _additions /= 2;
+}
+
+} // namespace Backend
+} // namespace Afina
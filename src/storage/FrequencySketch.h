@@ -0,0 +1,75 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Approximate access frequency of keys
+ * Count-min sketch of 4-bit counters: each key hash maps to one counter in each of four rows, increment
+ * bumps the smallest of them and estimate is the smallest one, so collisions could only overestimate.
+ * Counters saturate at 15, that is enough to tell hot keys from cold ones.
+ *
+ * Once number of increments reaches ten times the capacity all counters are halved, so that old
+ * popularity fades away and keys which were hot long ago don't stay in cache forever.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class FrequencySketch {
+public:
+    // Counter never goes beyond that value
+    static const uint32_t kMaxCount = 15;
+
+    /**
+     * @param capacity number of distinct keys sketch is expected to track
+     */
+    explicit FrequencySketch(size_t capacity = 64);
+
+    /**
+     * Grows sketch if it is too small for the given number of keys. Counters are lost on growth
+     */
+    void EnsureCapacity(size_t capacity);
+
+    /**
+     * Records access to the key with given hash
+     */
+    void Increment(uint32_t hash);
+
+    /**
+     * Estimated number of accesses to the key with given hash since it was last aged
+     */
+    uint32_t Estimate(uint32_t hash) const;
+
+    /**
+     * Halves all counters
+     */
+    void Age();
+
+    inline size_t capacity() const { return _table.size() * kCountersPerWord / kDepth; }
+
+private:
+    static const size_t kDepth = 4;
+    static const size_t kCountersPerWord = 16;
+
+    // Position of the counter for the hash in the given row
+    size_t Index(uint32_t hash, size_t row) const;
+
+    void Resize(size_t capacity);
+
+    // Counters of all rows share the same table, 16 of them per word
+    std::vector<uint64_t> _table;
+    size_t _mask;
+
+    // Number of increments since the last aging and when the next one happens
+    size_t _additions;
+    size_t _sample_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
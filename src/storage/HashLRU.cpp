@@ -0,0 +1,314 @@
+#include "HashLRU.h"
+
+#include <functional>
+#include <utility>
+
+#include <afina/Statistics.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Initial number of slots in the table, must be power of two
+const uint32_t kInitialCapacity = 16;
+
+} // namespace
+
+// See HashLRU.h
+HashLRU::HashLRU(size_t max_size)
+    : _max_size(max_size), _size_now(0), _table(kInitialCapacity), _mask(kInitialCapacity - 1), _items(0),
+      _lru_head(kNone), _lru_tail(kNone) {}
+
+// See HashLRU.h
+bool HashLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    uint32_t hash = Hash(key);
+    uint32_t pos = Find(key, hash);
+    if (pos != kNone) {
+        return Update(pos, value, ttl);
+    }
+
+    size_t added = key.size() + value.size();
+    if (added > _max_size) {
+        return false;
+    }
+
+    Free_memory(added);
+    Schedule(Insert(key, value, hash), ttl);
+    return true;
+}
+
+// See HashLRU.h
+bool HashLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    uint32_t hash = Hash(key);
+    if (Find(key, hash) != kNone) {
+        return false;
+    }
+
+    size_t added = key.size() + value.size();
+    if (added > _max_size) {
+        return false;
+    }
+
+    Free_memory(added);
+    Schedule(Insert(key, value, hash), ttl);
+    return true;
+}
+
+// See HashLRU.h
+bool HashLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    uint32_t pos = Find(key, Hash(key));
+    if (pos == kNone) {
+        return false;
+    }
+    return Update(pos, value, ttl);
+}
+
+// See HashLRU.h
+bool HashLRU::Delete(const std::string &key) {
+    uint32_t pos = Lookup(key, Hash(key));
+    if (pos == kNone) {
+        return false;
+    }
+
+    Erase(pos);
+    return true;
+}
+
+// See HashLRU.h
+bool HashLRU::Get(const std::string &key, std::string &value) {
+    uint32_t pos = Lookup(key, Hash(key));
+    if (pos == kNone) {
+        return false;
+    }
+
+    Unlink(pos);
+    Link_back(pos);
+    value = _table[pos].value;
+    return true;
+}
+
+// See HashLRU.h
+uint32_t HashLRU::Hash(const std::string &key) {
+    uint64_t hash = std::hash<std::string>()(key);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// See HashLRU.h
+uint32_t HashLRU::Find(const std::string &key, uint32_t hash) const {
+    // Robin-hood invariant: entry could not be further from its home than any entry
+    // we pass by, so search stops as soon as probe distance exceeds one of the slot
+    uint32_t pos = hash & _mask;
+    for (uint32_t dist = 1; _table[pos].dist >= dist; dist++) {
+        const slot &s = _table[pos];
+        if (s.hash == hash && s.key == key) {
+            return pos;
+        }
+        pos = (pos + 1) & _mask;
+    }
+    return kNone;
+}
+
+// See HashLRU.h
+uint32_t HashLRU::Lookup(const std::string &key, uint32_t hash) {
+    uint32_t pos = Find(key, hash);
+    if (pos != kNone && _table[pos].Expired(ExpirationClock())) {
+        Erase(pos);
+        return kNone;
+    }
+    return pos;
+}
+
+// See HashLRU.h
+size_t HashLRU::Expire() {
+    return _wheel.Advance(ExpirationClock(), [this](TimerHook &hook) {
+        Erase(static_cast<uint32_t>(&static_cast<slot &>(hook) - _table.data()));
+    });
+}
+
+// See HashLRU.h
+void HashLRU::Schedule(uint32_t pos, uint32_t ttl) {
+    _wheel.Schedule(_table[pos], Deadline(ttl));
+}
+
+// See HashLRU.h
+uint32_t HashLRU::Insert(std::string key, std::string value, uint32_t hash) {
+    // Keep load factor under 7/8
+    if ((_items + 1) * 8 > _table.size() * 7) {
+        Grow();
+    }
+
+    // Skip entries which are closer to their home than the new one would be
+    uint32_t pos = hash & _mask;
+    uint32_t dist = 1;
+    while (_table[pos].dist >= dist) {
+        pos = (pos + 1) & _mask;
+        dist++;
+    }
+
+    // Shift the rest of the cluster one slot forward to free pos
+    uint32_t empty = pos;
+    while (_table[empty].dist != 0) {
+        empty = (empty + 1) & _mask;
+    }
+    for (uint32_t i = empty; i != pos; i = (i - 1) & _mask) {
+        Relocate((i - 1) & _mask, i);
+        _table[i].dist++;
+    }
+
+    slot &s = _table[pos];
+    s.dist = dist;
+    s.hash = hash;
+    s.key.swap(key);
+    s.value.swap(value);
+
+    Link_back(pos);
+    _size_now += s.key.size() + s.value.size();
+    _items++;
+    return pos;
+}
+
+// See HashLRU.h
+void HashLRU::Erase(uint32_t pos) {
+    slot &s = _table[pos];
+    _size_now -= s.key.size() + s.value.size();
+    _items--;
+
+    Unlink(pos);
+    _wheel.Cancel(s);
+    s.deadline = 0;
+    std::string().swap(s.key);
+    std::string().swap(s.value);
+    s.dist = 0;
+
+    // Backward shift: pull following displaced entries one slot closer to their home
+    uint32_t next = (pos + 1) & _mask;
+    while (_table[next].dist > 1) {
+        Relocate(next, pos);
+        _table[pos].dist--;
+        pos = next;
+        next = (next + 1) & _mask;
+    }
+}
+
+// See HashLRU.h
+bool HashLRU::Update(uint32_t pos, const std::string &value, uint32_t ttl) {
+    slot &s = _table[pos];
+    if (s.key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    // Move to the fresh end first, so that entry being updated is evicted last
+    Unlink(pos);
+    Link_back(pos);
+
+    if (value.size() > s.value.size()) {
+        size_t will_be_added = value.size() - s.value.size();
+        Free_memory(will_be_added);
+        _size_now += will_be_added;
+
+        // Eviction could shift entry to another slot, but it is still the freshest one
+        pos = _lru_tail;
+    } else {
+        _size_now -= s.value.size() - value.size();
+    }
+
+    _table[pos].value = value;
+    if (ttl != kKeepTTL) {
+        Schedule(pos, ttl);
+    }
+    return true;
+}
+
+// See HashLRU.h
+void HashLRU::Relocate(uint32_t from, uint32_t to) {
+    slot &src = _table[from];
+    slot &dst = _table[to];
+
+    dst.dist = src.dist;
+    dst.hash = src.hash;
+    dst.prev = src.prev;
+    dst.next = src.next;
+    dst.key.swap(src.key);
+    dst.value.swap(src.value);
+    src.dist = 0;
+    _wheel.Move(src, dst);
+
+    if (dst.prev != kNone) {
+        _table[dst.prev].next = to;
+    } else {
+        _lru_head = to;
+    }
+
+    if (dst.next != kNone) {
+        _table[dst.next].prev = to;
+    } else {
+        _lru_tail = to;
+    }
+}
+
+// See HashLRU.h
+void HashLRU::Unlink(uint32_t pos) {
+    slot &s = _table[pos];
+    if (s.prev != kNone) {
+        _table[s.prev].next = s.next;
+    } else {
+        _lru_head = s.next;
+    }
+
+    if (s.next != kNone) {
+        _table[s.next].prev = s.prev;
+    } else {
+        _lru_tail = s.prev;
+    }
+}
+
+// See HashLRU.h
+void HashLRU::Link_back(uint32_t pos) {
+    slot &s = _table[pos];
+    s.prev = _lru_tail;
+    s.next = kNone;
+
+    if (_lru_tail != kNone) {
+        _table[_lru_tail].next = pos;
+    } else {
+        _lru_head = pos;
+    }
+    _lru_tail = pos;
+}
+
+// See HashLRU.h
+void HashLRU::Free_memory(size_t added) {
+    while (_lru_head != kNone && _size_now + added > _max_size) {
+        // Expired entry is not an eviction, it is gone already
+        if (!_table[_lru_head].Expired(ExpirationClock())) {
+            Statistics::Add(Statistics::kEvictions);
+        }
+        Erase(_lru_head);
+    }
+}
+
+// See HashLRU.h
+void HashLRU::Grow() {
+    std::vector<slot> old(_table.size() * 2);
+    old.swap(_table);
+    _mask = _table.size() - 1;
+
+    uint32_t pos = _lru_head;
+    _lru_head = _lru_tail = kNone;
+    _items = 0;
+    _size_now = 0;
+
+    // Reinsert entries from the oldest to the freshest one to preserve LRU order
+    while (pos != kNone) {
+        slot &s = old[pos];
+        _wheel.Move(s, _table[Insert(std::move(s.key), std::move(s.value), s.hash)]);
+        pos = s.next;
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
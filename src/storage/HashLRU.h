@@ -0,0 +1,133 @@
+#ifndef AFINA_STORAGE_HASH_LRU_H
+#define AFINA_STORAGE_HASH_LRU_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Open addressing hash table based implementation
+ * Entries live right inside of the table slots, lookup is done by robin-hood linear probing over
+ * precomputed hashes, so a key is found in O(1) with a couple of cache misses. LRU list is
+ * intrusive: each slot stores indices of its neighbours, no separate node allocations needed.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class HashLRU : public Afina::Storage {
+public:
+    HashLRU(size_t max_size = 1024);
+    ~HashLRU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override {
+        items = _items;
+        bytes = _size_now;
+    }
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed
+     */
+    size_t Expire();
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size) { return key_size + value_size; }
+
+private:
+    // Marks absence of a slot in LRU links
+    static const uint32_t kNone = UINT32_MAX;
+
+    // Table slot, it is either empty or holds exactly one entry. Expiration timer is embedded
+    // and moves together with the entry
+    struct slot : public TimerHook {
+        // Distance from the slot entry hashes to plus one, zero for the empty slot
+        uint32_t dist;
+
+        // Full hash of the key, compared before keys itself
+        uint32_t hash;
+
+        // LRU neighbours: prev is older entry, next is fresher one
+        uint32_t prev;
+        uint32_t next;
+
+        std::string key;
+        std::string value;
+    };
+
+    static uint32_t Hash(const std::string &key);
+
+    // Returns slot index of the key or kNone
+    uint32_t Find(const std::string &key, uint32_t hash) const;
+
+    // Same as Find, but entry which expired is removed and not returned
+    uint32_t Lookup(const std::string &key, uint32_t hash);
+
+    // Places new entry into the table and to the fresh end of the LRU list, returns its slot
+    uint32_t Insert(std::string key, std::string value, uint32_t hash);
+
+    // Removes entry from the table and from the list
+    void Erase(uint32_t pos);
+
+    // Replaces value and expiration time of the existing entry
+    bool Update(uint32_t pos, const std::string &value, uint32_t ttl);
+
+    // Arms expiration timer of the entry
+    void Schedule(uint32_t pos, uint32_t ttl);
+
+    // Moves entry between slots keeping LRU links consistent
+    void Relocate(uint32_t from, uint32_t to);
+
+    void Unlink(uint32_t pos);
+    void Link_back(uint32_t pos);
+
+    // Evicts old entries until there is a space for added bytes
+    void Free_memory(size_t added);
+
+    // Doubles the table
+    void Grow();
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    std::size_t _max_size;
+    std::size_t _size_now;
+
+    // Table itself, size is always power of two
+    std::vector<slot> _table;
+    uint32_t _mask;
+    std::size_t _items;
+
+    // Least and most recently used entries
+    uint32_t _lru_head;
+    uint32_t _lru_tail;
+
+    // Expiration timers of the entries which have TTL
+    TimingWheel _wheel;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_LRU_H
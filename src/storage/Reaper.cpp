@@ -0,0 +1,48 @@
+#include "Reaper.h"
+
+namespace Afina {
+namespace Backend {
+
+// See Reaper.h
+Reaper::Reaper(std::function<void()> tick, std::chrono::milliseconds period)
+    : _tick(std::move(tick)), _period(period), _running(false) {}
+
+// See Reaper.h
+Reaper::~Reaper() { Stop(); }
+
+// See Reaper.h
+void Reaper::Start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+
+    _running = true;
+    _thread = std::thread(&Reaper::Run, this);
+}
+
+// See Reaper.h
+void Reaper::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _stop_condition.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See Reaper.h
+void Reaper::Run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop_condition.wait_for(lock, _period, [this] { return !_running; })) {
+        lock.unlock();
+        _tick();
+        lock.lock();
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,52 @@
+#ifndef AFINA_STORAGE_REAPER_H
+#define AFINA_STORAGE_REAPER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Background expiration
+ * Runs given function periodically in a separate thread, used by thread safe storages to
+ * reclaim memory of expired entries which nobody touches anymore.
+ */
+class Reaper {
+public:
+    Reaper(std::function<void()> tick, std::chrono::milliseconds period = std::chrono::milliseconds(1000));
+    ~Reaper();
+
+    /**
+     * Spawns background thread, does nothing if it is running already
+     */
+    void Start();
+
+    /**
+     * Signals background thread to stop and waits until it is done
+     */
+    void Stop();
+
+private:
+    Reaper(const Reaper &) = delete;
+    Reaper &operator=(const Reaper &) = delete;
+
+    // Background thread body
+    void Run();
+
+    std::function<void()> _tick;
+    std::chrono::milliseconds _period;
+
+    std::mutex _mutex;
+    std::condition_variable _stop_condition;
+    bool _running;
+    std::thread _thread;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_REAPER_H
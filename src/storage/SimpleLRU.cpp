@@ -1,185 +1,375 @@
 #include "SimpleLRU.h"
 
+#include <cstddef>
+#include <functional>
+#include <new>
+
+#include <afina/Statistics.h>
+
 namespace Afina {
     namespace Backend {
 
+        namespace {
+
+// Initial number of index buckets, must be power of two
+            const size_t kInitialBuckets = 16;
+
+        } // namespace
+
+        const size_t SimpleLRU::kSharedValueSize;
+        const size_t SimpleLRU::kMaxKeySize;
+        const uint8_t SimpleLRU::kTimed;
+        const size_t SimpleLRU::kHeaderSize = offsetof(SimpleLRU::lru_node, flags) + sizeof(uint8_t);
+        const size_t SimpleLRU::kExtrasOffset = (SimpleLRU::kHeaderSize + alignof(void *) - 1) & ~(alignof(void *) - 1);
+
+        SimpleLRU::SimpleLRU(size_t max_size)
+            : _max_size(max_size), _size_now(0), _lru_head(nullptr), _lru_tail(nullptr), _buckets(kInitialBuckets, nullptr),
+              _items(0) {}
+
+        SimpleLRU::~SimpleLRU() {
+            while (_lru_head) {
+                lru_node *node = _lru_head;
+                _lru_head = node->next;
+                Destroy(*node);
+            }
+        }
+
 // See MapBasedGlobalLockImpl.h
-        bool SimpleLRU::Put(const std::string &key, const std::string &value) {
-            auto found = _lru_index.find(const_cast<std::string &>(key));
+        bool SimpleLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+            Expire();
+            uint32_t hash = Hash(key);
+            lru_node *found = Lookup(key, hash);
 
-            if (found == _lru_index.end()) {
-                return SimpleLRU::PutIfAbsent_(key, value);
+            if (found == nullptr) {
+                return SimpleLRU::PutIfAbsent_(key, value, hash, ttl);
             } else {
-                return SimpleLRU::Set_(found -> second.get(), value);
+                return SimpleLRU::Set_(*found, value, ttl);
             }
         }
 
 // See MapBasedGlobalLockImpl.h
-        bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
-            auto found = _lru_index.find(const_cast<std::string &>(key));
-
-            if (found != _lru_index.end()) {
+        bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+            Expire();
+            uint32_t hash = Hash(key);
+            if (Lookup(key, hash) != nullptr) {
                 return false;
             }
 
-            return PutIfAbsent_(key, value);
+            return PutIfAbsent_(key, value, hash, ttl);
         }
 
-        bool SimpleLRU::PutIfAbsent_(const std::string &key, const std::string &value) {
-            size_t added = key.size() + value.size();
-            if (added > _max_size) {
+        bool SimpleLRU::PutIfAbsent_(const std::string &key, const std::string &value, uint32_t hash, uint32_t ttl) {
+            // Protocol parser never passes longer keys, still header has no room for their length
+            bool timed = ttl != 0 && ttl != kKeepTTL;
+            size_t added = Footprint(key.size(), value.size(), timed);
+            if (key.size() > kMaxKeySize || added > _max_size) {
                 return false;
             }
 
             Free_memory(added);
-            Put_to_back(key, value, added);
+            Schedule(*Put_to_back(key, value, hash, timed), ttl);
 
             return true;
         }
 
 
 // See MapBasedGlobalLockImpl.h
-        bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-            auto found = _lru_index.find(const_cast<std::string &>(key));
+        bool SimpleLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+            Expire();
+            lru_node *found = Lookup(key, Hash(key));
 
-            if (found == _lru_index.end()) {
+            if (found == nullptr) {
                 return false;
             }
 
-            return Set_(found->second.get(), value);
+            return Set_(*found, value, ttl);
         }
 
-        bool SimpleLRU::Set_(Afina::Backend::SimpleLRU::lru_node &found, const std::string &value) {
-            int will_be_added = found.value.size() - value.size();
-
-            if (will_be_added < 0) {
-                _size_now -= value.size() - found.value.size();
+        bool SimpleLRU::Set_(Afina::Backend::SimpleLRU::lru_node &found, const std::string &value, uint32_t ttl) {
+            // Value fits into the same size class and layout of the chunk is the same, no need to move.
+            // Timer which is not needed anymore stays disarmed. Shared buffer is replaced rather than
+            // changed, it could be referenced by readers
+            bool keep = ttl == kKeepTTL;
+            bool timed = keep ? found.timed() : ttl != 0;
+            bool shared = value.size() >= kSharedValueSize;
+            bool in_place = ChunkSize(found.key_size, value.size(), found.timed()) == found.chunk_size &&
+                            shared == found.shared() && (found.timed() || !timed);
+
+            // Node updated in place keeps its timer, so it is accounted the way it is going to be
+            size_t added = Footprint(found.key_size, value.size(), in_place ? found.timed() : timed);
+            if (added > _max_size) {
+                return false;
+            }
 
-                // Change value
-                found.value = value;
+            // Move to the end of the list first, so that node being updated is evicted last
+            Send_to_back(found);
 
-                // Move to the end of the list
-                Send_to_back(found);
-            } else {
-                if (found.key.size() + value.size() > _max_size) {
-                    return false;
+            if (in_place) {
+                _size_now -= found.footprint();
+                found.value_size = value.size();
+                if (shared) {
+                    found.shared_value() = std::make_shared<const std::string>(value);
                 } else {
-                    Send_to_back(found);
-                    Free_memory(will_be_added);
-                    found.value = value;
+                    Fill(found, value);
                 }
+                _size_now += found.footprint();
+
+                Free_memory(0, &found);
+                Schedule(found, ttl);
+                return true;
+            }
+
+            // Otherwise entry is moved to the chunk of another class, old one goes back to the slab
+            size_t chunk_size = ChunkSize(found.key_size, value.size(), timed);
+            lru_node *node = new (_slab.Allocate(chunk_size)) lru_node();
+            node->hash = found.hash;
+            node->key_size = found.key_size;
+            node->value_size = value.size();
+            node->chunk_size = chunk_size;
+            if (timed) {
+                node->flags |= kTimed;
+                new (&node->timer()) TimerHook();
+            }
+            std::memcpy(node->key(), found.key(), found.key_size);
+            Fill(*node, value);
+            if (keep && timed) {
+                _wheel.Move(found.timer(), node->timer());
+            }
+
+            Remove(found);
+            Free_memory(added);
+
+            node->prev = _lru_tail;
+            node->next = nullptr;
+            if (_lru_tail != nullptr) {
+                _lru_tail->next = node;
+            } else {
+                _lru_head = node;
             }
+            _lru_tail = node;
+            Index(*node);
+
+            _size_now += added;
+            Schedule(*node, ttl);
             return true;
         }
 
 // See MapBasedGlobalLockImpl.h
         bool SimpleLRU::Delete(const std::string &key) {
-            auto found = _lru_index.find(const_cast<std::string &>(key));
+            lru_node *found = Lookup(key, Hash(key));
 
-            if (found != _lru_index.end()) {
-                _size_now -= key.size() + found->second.get().value.size();
+            if (found == nullptr) {
+                return false;
+            }
 
-                lru_node &to_be_deleted = found->second.get();
+            Remove(*found);
+            return true;
+        }
 
-                _lru_index.erase(const_cast<std::string &>(key));
+// See MapBasedGlobalLockImpl.h
+        bool SimpleLRU::Get(const std::string &key, std::string &value) {
+            lru_node *found = Lookup(key, Hash(key));
 
-                if (_lru_head->key == key) {
-                    if (_lru_tail->key == key) {
-                        _lru_tail = 0;
-                        _lru_head = 0;
-                    } else {
-                        _lru_head = std::move(to_be_deleted.next);
-                        _lru_head->prev = 0;
-                    }
-                    return true;
-                }
+            if (found != nullptr) {
+                Send_to_back(*found);
 
-                if (_lru_tail->key == key) {
-                    _lru_tail = to_be_deleted.prev;
-                    //_lru_tail -> next = 0;
+                value.assign(found->value(), found->value_size);
+                return true;
+            }
 
-                    return true;
-                }
+            return false;
+        }
 
-                to_be_deleted.prev->next = std::move(to_be_deleted.next);
-                to_be_deleted.next->prev = to_be_deleted.prev;
+// See MapBasedGlobalLockImpl.h
+        bool SimpleLRU::GetShared(const std::string &key, SharedValue &value) {
+            lru_node *found = Lookup(key, Hash(key));
 
+            if (found == nullptr) {
+                return false;
+            }
 
-                return true;
+            Send_to_back(*found);
+            if (found->shared()) {
+                value = found->shared_value();
+            } else {
+                value = std::make_shared<const std::string>(found->value(), found->value_size);
             }
+            return true;
+        }
 
-            return false;
+        size_t SimpleLRU::EntrySize(size_t key_size, size_t value_size) { return Footprint(key_size, value_size, false); }
+
+        size_t SimpleLRU::Footprint(size_t key_size, size_t value_size, bool timed) {
+            return ChunkSize(key_size, value_size, timed) + (value_size >= kSharedValueSize ? value_size : 0);
         }
 
-// See MapBasedGlobalLockImpl.h
-        bool SimpleLRU::Get(const std::string &key, std::string &value) {
-            auto found = _lru_index.find(const_cast<std::string &>(key));
+        size_t SimpleLRU::KeyOffset(bool timed, bool shared) {
+            if (!timed && !shared) {
+                return kHeaderSize;
+            }
+            return kExtrasOffset + (timed ? sizeof(TimerHook) : 0) + (shared ? sizeof(SharedValue) : 0);
+        }
 
-            if (found != _lru_index.end()) {
-                Send_to_back(found->second.get());
+        size_t SimpleLRU::ChunkSize(size_t key_size, size_t value_size, bool timed) {
+            if (value_size >= kSharedValueSize) {
+                return SlabAllocator::ChunkSize(KeyOffset(timed, true) + key_size);
+            }
+            return SlabAllocator::ChunkSize(KeyOffset(timed, false) + key_size + value_size);
+        }
 
-                value = _lru_tail->value;
-                return true;
+        void SimpleLRU::Fill(lru_node &node, const std::string &value) {
+            if (node.shared()) {
+                new (&node.shared_value()) SharedValue(std::make_shared<const std::string>(value));
+            } else {
+                std::memcpy(node.key() + node.key_size, value.data(), value.size());
             }
+        }
 
-            return false;
+        void SimpleLRU::Destroy(lru_node &node) {
+            if (node.shared()) {
+                node.shared_value().~SharedValue();
+            }
+            _slab.Free(&node, node.chunk_size);
         }
 
-        void SimpleLRU::Send_to_back(lru_node &to_send) {
-            auto key = to_send.key;
+        uint32_t SimpleLRU::Hash(const std::string &key) {
+            uint64_t hash = std::hash<std::string>()(key);
+            return static_cast<uint32_t>(hash ^ (hash >> 32));
+        }
 
-            if (_lru_tail->key != key) {
-                if (_lru_head->key == key) {
-                    _lru_tail->next = std::move(_lru_head);
+        void SimpleLRU::Unlink(lru_node &node) {
+            if (node.prev != nullptr) {
+                node.prev->next = node.next;
+            } else {
+                _lru_head = node.next;
+            }
 
-                    _lru_head = std::move(_lru_tail->next->next);
-                    //_lru_head -> prev = 0;
+            if (node.next != nullptr) {
+                node.next->prev = node.prev;
+            } else {
+                _lru_tail = node.prev;
+            }
+        }
 
-                    _lru_tail = &to_send;
-                } else {
-                    _lru_tail->next = std::move(to_send.prev->next);
+        void SimpleLRU::Remove(lru_node &node) {
+            _size_now -= node.footprint();
+            if (node.timed()) {
+                _wheel.Cancel(node.timer());
+            }
 
-                    to_send.prev->next = std::move(to_send.next);
-                    to_send.prev->next->prev = to_send.prev;
+            Unindex(node);
+            Unlink(node);
+            Destroy(node);
+        }
 
-                    to_send.prev = _lru_tail;
-                    _lru_tail = &to_send;
-                    _lru_tail->next = 0;
-                }
+        SimpleLRU::lru_node *SimpleLRU::Lookup(const std::string &key, uint32_t hash) {
+            lru_node *node = Bucket(hash);
+            while (node != nullptr && !node->Is(key, hash)) {
+                node = node->bucket_next;
             }
+
+            if (node != nullptr && node->Expired(ExpirationClock())) {
+                Remove(*node);
+                return nullptr;
+            }
+            return node;
         }
 
-        void SimpleLRU::Put_to_back(const std::string &key, const std::string &value, size_t added) {
-            auto *new_lru_node = new lru_node({key, value, _lru_tail});
-            _lru_index.insert(std::make_pair(std::ref(new_lru_node->key), std::ref(*new_lru_node)));
+        void SimpleLRU::Schedule(lru_node &node, uint32_t ttl) {
+            // Node without timer never gets TTL, see Set_
+            if (node.timed() && ttl != kKeepTTL) {
+                _wheel.Schedule(node.timer(), Deadline(ttl));
+            }
+        }
 
-            if (_lru_head == 0) {
-                new_lru_node->prev = 0;
-                _lru_head = std::unique_ptr<lru_node>(new_lru_node);
-                _lru_tail = new_lru_node;
+        size_t SimpleLRU::Expire() {
+            return _wheel.Advance(ExpirationClock(), [this](TimerHook &hook) { Remove(Owner(hook)); });
+        }
 
-                _size_now += added;
-            } else {
-                _lru_tail->next = std::unique_ptr<lru_node>(new_lru_node);
-                _lru_tail = new_lru_node;
+        void SimpleLRU::Index(lru_node &node) {
+            // Keep chains one node long on average
+            if (_items + 1 > _buckets.size()) {
+                Rehash();
+            }
 
-                _size_now += added;
+            lru_node *&bucket = Bucket(node.hash);
+            node.bucket_next = bucket;
+            bucket = &node;
+            _items++;
+        }
+
+        void SimpleLRU::Unindex(lru_node &node) {
+            lru_node **link = &Bucket(node.hash);
+            while (*link != &node) {
+                link = &(*link)->bucket_next;
             }
+            *link = node.bucket_next;
+            _items--;
         }
 
-        void SimpleLRU::Free_memory(size_t added) {
-            while (_size_now + added > _max_size) {
-                _size_now -= _lru_head->key.size() + _lru_head->value.size();
+        void SimpleLRU::Rehash() {
+            std::vector<lru_node *> buckets(_buckets.size() * 2, nullptr);
+            buckets.swap(_buckets);
+
+            for (lru_node *node : buckets) {
+                while (node != nullptr) {
+                    lru_node *next = node->bucket_next;
+                    lru_node *&bucket = Bucket(node->hash);
+                    node->bucket_next = bucket;
+                    bucket = node;
+                    node = next;
+                }
+            }
+        }
 
-                _lru_index.erase(_lru_head->key);
+        void SimpleLRU::Send_to_back(lru_node &to_send) {
+            if (&to_send == _lru_tail) {
+                return;
+            }
 
-                if (_lru_tail->key == _lru_head->key) {
-                    _lru_tail = 0;
-                    _lru_head = 0;
-                } else {
-                    _lru_head = std::move(_lru_head->next);
-                    _lru_head->prev = 0;
+            Unlink(to_send);
+            to_send.prev = _lru_tail;
+            to_send.next = nullptr;
+            _lru_tail->next = &to_send;
+            _lru_tail = &to_send;
+        }
+
+        SimpleLRU::lru_node *SimpleLRU::Put_to_back(const std::string &key, const std::string &value, uint32_t hash,
+                                                    bool timed) {
+            size_t chunk_size = ChunkSize(key.size(), value.size(), timed);
+            lru_node *new_lru_node = new (_slab.Allocate(chunk_size)) lru_node();
+            new_lru_node->hash = hash;
+            new_lru_node->key_size = key.size();
+            new_lru_node->value_size = value.size();
+            new_lru_node->chunk_size = chunk_size;
+            if (timed) {
+                new_lru_node->flags |= kTimed;
+                new (&new_lru_node->timer()) TimerHook();
+            }
+            std::memcpy(new_lru_node->key(), key.data(), key.size());
+            Fill(*new_lru_node, value);
+
+            new_lru_node->prev = _lru_tail;
+            new_lru_node->next = nullptr;
+            if (_lru_tail == nullptr) {
+                _lru_head = new_lru_node;
+            } else {
+                _lru_tail->next = new_lru_node;
+            }
+            _lru_tail = new_lru_node;
+
+            Index(*new_lru_node);
+            _size_now += new_lru_node->footprint();
+            return new_lru_node;
+        }
+
+        void SimpleLRU::Free_memory(size_t added, const lru_node *pinned) {
+            while (_lru_head && _lru_head != pinned && _size_now + added > _max_size) {
+                // Expired entry is not an eviction, it is gone already
+                if (!_lru_head->Expired(ExpirationClock())) {
+                    Statistics::Add(Statistics::kEvictions);
                 }
+                Remove(*_lru_head);
             }
         }
     } // namespace Backend
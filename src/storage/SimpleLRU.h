@@ -1,44 +1,53 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
-#include <memory>
+#include <cstdint>
+#include <cstring>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <afina/Storage.h>
 
+#include "Slab.h"
+#include "TimingWheel.h"
+
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # LRU on slab chunks with intrusive index
+ * Every entry is a single chunk of the slab allocator: node header followed by key and value
+ * bytes. Nodes are linked into LRU list and into the chains of intrusive hash index, which doubles
+ * once there are more entries than buckets, so there are no other allocations per entry. Memory
+ * limit accounts whole chunks, including header and slab rounding.
+ *
+ * Entries with TTL are linked into the timing wheel, which is advanced by every write, so expired
+ * entries are dropped in O(1) each. Entry expired since then is removed once lookup finds it.
+ *
+ * Header is kept compact: sizes are packed and expiration timer is placed in the chunk only for
+ * entries which have TTL, so that entry without it costs 38 bytes on top of key and value. Keys
+ * longer than kMaxKeySize are not accepted.
+ *
+ * Large values are kept out of the chunk in shared immutable buffers, so GetShared hands them
+ * out without copying. Such value is accounted by its size on top of the chunk.
+ *
  * That is NOT thread safe implementaiton!!
  */
 class SimpleLRU : public Afina::Storage {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size), _size_now(0), _lru_head(nullptr) {}
-
-    ~SimpleLRU() {
-        if (_lru_head) {
-            _lru_index.clear();
-            while (_lru_head) {
-                std::unique_ptr<lru_node> node_to_delete;
-                node_to_delete.swap(_lru_head);
-                _lru_head.swap(node_to_delete->next);
-            }
-            _lru_head.reset();
-        }
-    }
+    SimpleLRU(size_t max_size = 1024);
+
+    ~SimpleLRU();
 
     // Implements Afina::Storage interface
-    bool Put(const std::string &key, const std::string &value) override;
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
 
     // Implements Afina::Storage interface
-    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
 
     // Implements Afina::Storage interface
-    bool Set(const std::string &key, const std::string &value) override;
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
 
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
@@ -46,38 +55,159 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
-    //
-    void Put_to_back(const std::string &key, const std::string &value, size_t added);
-    void Free_memory(size_t added);
+    // Implements Afina::Storage interface
+    bool GetShared(const std::string &key, SharedValue &value) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override {
+        items = _items;
+        bytes = _size_now;
+    }
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed.
+     * Called on every modification, but could be called from outside to reclaim memory
+     * without waiting for the next write
+     */
+    size_t Expire();
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit, entry with
+     * TTL takes a bit more for the timer
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size);
+
+    /**
+     * Values of this size and larger are stored in shared buffers out of the entry chunk
+     */
+    static const size_t kSharedValueSize = 1024;
+
+    /**
+     * Longest key storage accepts, the same limit protocol parser enforces
+     */
+    static const size_t kMaxKeySize = 250;
 
 private:
-    // LRU cache node
-    using lru_node = struct lru_node {
-        const std::string key;
-        std::string value;
+    // LRU cache node. Header is followed by the optional parts: expiration timer if entry has TTL and
+    // reference to the shared value if value is large. Key and value bytes come next, right after the
+    // last used header byte when there are no optional parts
+    struct lru_node {
         lru_node *prev;
-        std::unique_ptr<lru_node> next;
+        lru_node *next;
+
+        // Next node in the same index bucket
+        lru_node *bucket_next;
+
+        uint32_t hash;
+        uint32_t value_size;
+
+        // Size of the chunk node lives in, value could grow up to it in place
+        uint32_t chunk_size;
+
+        uint8_t key_size;
+        uint8_t flags;
+
+        inline bool timed() const { return (flags & kTimed) != 0; }
+        inline bool shared() const { return value_size >= kSharedValueSize; }
+
+        inline TimerHook &timer() { return *reinterpret_cast<TimerHook *>(reinterpret_cast<char *>(this) + kExtrasOffset); }
+        inline SharedValue &shared_value() {
+            return *reinterpret_cast<SharedValue *>(reinterpret_cast<char *>(this) + kExtrasOffset +
+                                                    (timed() ? sizeof(TimerHook) : 0));
+        }
+
+        inline char *key() { return reinterpret_cast<char *>(this) + KeyOffset(timed(), shared()); }
+        inline const char *value() { return shared() ? shared_value()->data() : key() + key_size; }
+
+        // Number of bytes entry takes from the memory limit
+        inline size_t footprint() const { return chunk_size + (shared() ? value_size : 0); }
+
+        inline bool Expired(uint32_t now) { return timed() && timer().Expired(now); }
+
+        inline bool Is(const std::string &k, uint32_t h) {
+            return hash == h && key_size == k.size() && std::memcmp(key(), k.data(), key_size) == 0;
+        }
     };
 
+    // Node flags
+    static const uint8_t kTimed = 1;
+
+    // Bytes of the header in use and where optional parts start, those need pointer alignment
+    static const size_t kHeaderSize;
+    static const size_t kExtrasOffset;
+
+    // Where key starts in the node with given optional parts
+    static size_t KeyOffset(bool timed, bool shared);
+
+    // Node the timer is embedded into
+    static lru_node &Owner(TimerHook &timer) {
+        return *reinterpret_cast<lru_node *>(reinterpret_cast<char *>(&timer) - kExtrasOffset);
+    }
+
+    static uint32_t Hash(const std::string &key);
+
+    // Size of the slab chunk for the entry
+    static size_t ChunkSize(size_t key_size, size_t value_size, bool timed);
+
+    // Number of bytes entry takes from the memory limit
+    static size_t Footprint(size_t key_size, size_t value_size, bool timed);
+
+    // Stores value into the fresh node which value_size is set already
+    static void Fill(lru_node &node, const std::string &value);
+
+    // Releases node memory, node must be out of the list and the index already
+    void Destroy(lru_node &node);
+
+    // Allocates node for the key/value and puts it to the fresh end of the list and to the index
+    lru_node *Put_to_back(const std::string &key, const std::string &value, uint32_t hash, bool timed);
+
     void Send_to_back(lru_node &node_to_send);
 
-    bool PutIfAbsent_(const std::string &key, const std::string &value);
-    bool Set_(lru_node &found, const std::string &value);
+    // Removes node from the list
+    void Unlink(lru_node &node);
+
+    // Removes node from the index, the list and the timer wheel and frees its memory
+    void Remove(lru_node &node);
+
+    // Finds live node for the key, expired one gets removed on the way
+    lru_node *Lookup(const std::string &key, uint32_t hash);
+
+    // Arms expiration timer of the node
+    void Schedule(lru_node &node, uint32_t ttl);
+
+    // Index maintenance
+    lru_node *&Bucket(uint32_t hash) { return _buckets[hash & (_buckets.size() - 1)]; }
+    void Index(lru_node &node);
+    void Unindex(lru_node &node);
+    void Rehash();
+
+    // Evicts least recently used entries until there is room for given number of bytes, pinned entry
+    // is never evicted: eviction stops once it gets to the head
+    void Free_memory(size_t added, const lru_node *pinned = nullptr);
+
+    bool PutIfAbsent_(const std::string &key, const std::string &value, uint32_t hash, uint32_t ttl);
+    bool Set_(lru_node &found, const std::string &value, uint32_t ttl);
 
     // Maximum number of bytes could be stored in this cache.
-    // i.e all (keys+values) must be less the _max_size
+    // i.e all chunks of entries must be less the _max_size
     std::size_t _max_size;
     std::size_t _size_now;
 
     // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
     // element that wasn't used for longest time.
-    //
-    // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head;
+    lru_node *_lru_head;
     lru_node *_lru_tail;
 
-            // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>> _lru_index;
+    // Index of nodes from list above, allows fast random access to elements by key. Number of
+    // buckets is power of two
+    std::vector<lru_node *> _buckets;
+    std::size_t _items;
+
+    // Expiration timers of the nodes which have TTL
+    TimingWheel _wheel;
+
+    // Memory of all nodes, must outlive them
+    SlabAllocator _slab;
 };
 
 } // namespace Backend
@@ -0,0 +1,114 @@
+#include "Slab.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Every chunk is aligned to this boundary
+const size_t kAlignment = 8;
+
+// Chunk of the next class is this times bigger than previous one, in 1/4 steps
+const size_t kFactorQuarters = 5;
+
+const size_t kMinChunk = 32;
+const size_t kMaxChunk = SlabAllocator::kPageSize / 2;
+
+size_t align(size_t size) { return (size + kAlignment - 1) & ~(kAlignment - 1); }
+
+// Sizes of all chunk classes in ascending order
+std::vector<size_t> build_classes() {
+    std::vector<size_t> classes;
+    for (size_t size = kMinChunk; size < kMaxChunk; size = align(size * kFactorQuarters / 4)) {
+        classes.push_back(size);
+    }
+    classes.push_back(kMaxChunk);
+    return classes;
+}
+
+const std::vector<size_t> &classes() {
+    static const std::vector<size_t> sizes = build_classes();
+    return sizes;
+}
+
+} // namespace
+
+// See Slab.h
+SlabAllocator::SlabAllocator() : _free(classes().size(), nullptr) {}
+
+// See Slab.h
+SlabAllocator::~SlabAllocator() {
+    for (void *page : _pages) {
+        std::free(page);
+    }
+}
+
+// See Slab.h
+size_t SlabAllocator::Class(size_t size) {
+    const std::vector<size_t> &sizes = classes();
+    return std::lower_bound(sizes.begin(), sizes.end(), size) - sizes.begin();
+}
+
+// See Slab.h
+size_t SlabAllocator::ChunkSize(size_t size) {
+    size_t cls = Class(size);
+    return cls < classes().size() ? classes()[cls] : align(size);
+}
+
+// See Slab.h
+void *SlabAllocator::Allocate(size_t size) {
+    size_t cls = Class(size);
+    if (cls == _free.size()) {
+        void *chunk = std::malloc(size);
+        if (chunk == nullptr) {
+            throw std::bad_alloc();
+        }
+        return chunk;
+    }
+
+    if (_free[cls] == nullptr) {
+        Refill(cls);
+    }
+
+    free_chunk *chunk = _free[cls];
+    _free[cls] = chunk->next;
+    return chunk;
+}
+
+// See Slab.h
+void SlabAllocator::Free(void *chunk, size_t size) {
+    size_t cls = Class(size);
+    if (cls == _free.size()) {
+        std::free(chunk);
+        return;
+    }
+
+    free_chunk *node = static_cast<free_chunk *>(chunk);
+    node->next = _free[cls];
+    _free[cls] = node;
+}
+
+// See Slab.h
+void SlabAllocator::Refill(size_t cls) {
+    char *page = static_cast<char *>(std::malloc(kPageSize));
+    if (page == nullptr) {
+        throw std::bad_alloc();
+    }
+    _pages.push_back(page);
+
+    // Link chunks in address order, so that consequent allocations are close to each other
+    size_t chunk_size = classes()[cls];
+    size_t count = kPageSize / chunk_size;
+    for (size_t i = count; i > 0; i--) {
+        free_chunk *node = reinterpret_cast<free_chunk *>(page + (i - 1) * chunk_size);
+        node->next = _free[cls];
+        _free[cls] = node;
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
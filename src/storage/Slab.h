@@ -0,0 +1,70 @@
+#ifndef AFINA_STORAGE_SLAB_H
+#define AFINA_STORAGE_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Size classed slab allocator
+ * Memory is requested from the system by pages which are carved into chunks of the same size.
+ * Sizes of the chunks form geometric progression, so that internal fragmentation is bounded by
+ * the growth factor, and freed chunk goes to the free list of its class to be reused by the
+ * next allocation of a similar size. Chunks which are bigger than a half of the page are
+ * allocated from the system directly.
+ *
+ * Pages are never returned back to the system until allocator is destroyed, pointers to the
+ * chunks must not be used after that.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabAllocator {
+public:
+    SlabAllocator();
+    ~SlabAllocator();
+
+    /**
+     * Returns memory chunk of at least given size, never returns nullptr
+     */
+    void *Allocate(size_t size);
+
+    /**
+     * Returns chunk back to its class, size must be the same as passed to Allocate
+     */
+    void Free(void *chunk, size_t size);
+
+    /**
+     * Real number of bytes chunk of the given size occupies
+     */
+    static size_t ChunkSize(size_t size);
+
+    // Size of a page chunks are carved from
+    static const size_t kPageSize = 64 * 1024;
+
+private:
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    // Free chunk is linked into the list of its class through its first bytes
+    struct free_chunk {
+        free_chunk *next;
+    };
+
+    // Returns index of the smallest class fits given size or number of classes for the
+    // chunk which must go to the system
+    static size_t Class(size_t size);
+
+    // Carves new page into chunks of the class
+    void Refill(size_t cls);
+
+    std::vector<free_chunk *> _free;
+    std::vector<void *> _pages;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_H
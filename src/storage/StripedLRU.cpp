@@ -0,0 +1,137 @@
+#include "StripedLRU.h"
+
+#include <functional>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+// See StripedLRU.h
+StripedLRU::StripedLRU(size_t max_size, size_t stripes)
+    : _reaper([this]() {
+          for (auto &shard : _shards) {
+              std::lock_guard<std::mutex> lock(shard->mutex);
+              shard->storage.Expire();
+          }
+      }) {
+    if (stripes == 0) {
+        throw std::invalid_argument("Number of stripes must be positive");
+    }
+
+    // Distribute reminder of the budget among first shards so that total is exactly max_size
+    _shards.reserve(stripes);
+    for (size_t i = 0; i < stripes; i++) {
+        size_t shard_size = max_size / stripes + (i < max_size % stripes ? 1 : 0);
+        _shards.emplace_back(new Shard(shard_size));
+    }
+}
+
+// See StripedLRU.h
+void StripedLRU::Start() { _reaper.Start(); }
+
+// See StripedLRU.h
+void StripedLRU::Stop() { _reaper.Stop(); }
+
+// See StripedLRU.h
+size_t StripedLRU::Index(const std::string &key) const {
+    size_t hash = std::hash<std::string>()(key);
+    return hash % _shards.size();
+}
+
+// See StripedLRU.h
+bool StripedLRU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.Put(key, value, ttl);
+}
+
+// See StripedLRU.h
+bool StripedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.PutIfAbsent(key, value, ttl);
+}
+
+// See StripedLRU.h
+bool StripedLRU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.Set(key, value, ttl);
+}
+
+// See StripedLRU.h
+bool StripedLRU::Delete(const std::string &key) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.Delete(key);
+}
+
+// See StripedLRU.h
+bool StripedLRU::Get(const std::string &key, std::string &value) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.Get(key, value);
+}
+
+// See StripedLRU.h
+bool StripedLRU::GetShared(const std::string &key, SharedValue &value) {
+    Shard &shard = Select(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.storage.GetShared(key, value);
+}
+
+// See StripedLRU.h
+size_t StripedLRU::GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) {
+    values.resize(keys.size());
+
+    // Keys grouped by shard: counting sort of key indices by shard index
+    std::vector<size_t> shard_of(keys.size());
+    std::vector<size_t> starts(_shards.size() + 1, 0);
+    for (size_t i = 0; i < keys.size(); i++) {
+        shard_of[i] = Index(*keys[i]);
+        starts[shard_of[i] + 1]++;
+    }
+    for (size_t s = 0; s < _shards.size(); s++) {
+        starts[s + 1] += starts[s];
+    }
+
+    std::vector<size_t> order(keys.size());
+    std::vector<size_t> next(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < keys.size(); i++) {
+        order[next[shard_of[i]]++] = i;
+    }
+
+    size_t found = 0;
+    for (size_t s = 0; s < _shards.size(); s++) {
+        if (starts[s] == starts[s + 1]) {
+            continue;
+        }
+
+        Shard &shard = *_shards[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t j = starts[s]; j < starts[s + 1]; j++) {
+            size_t i = order[j];
+            if (shard.storage.GetShared(*keys[i], values[i])) {
+                found++;
+            } else {
+                values[i].reset();
+            }
+        }
+    }
+    return found;
+}
+
+// See StripedLRU.h
+void StripedLRU::Usage(size_t &items, size_t &bytes) {
+    items = bytes = 0;
+    for (auto &shard : _shards) {
+        size_t shard_items, shard_bytes;
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->storage.Usage(shard_items, shard_bytes);
+        items += shard_items;
+        bytes += shard_bytes;
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
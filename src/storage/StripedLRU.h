@@ -0,0 +1,86 @@
+#ifndef AFINA_STORAGE_STRIPED_LRU_H
+#define AFINA_STORAGE_STRIPED_LRU_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "Reaper.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock striped LRU
+ * Keys are hashed into a fixed number of independent SimpleLRU shards, each one
+ * protected by its own mutex. Threads working with different shards never contend
+ * on the same lock.
+ *
+ * Memory budget is split between shards, so sum of all shard budgets is equal to
+ * max_size. As a consequence LRU order is maintained per shard only and a single
+ * key+value pair must fit into a shard budget.
+ *
+ * Background reaper visits shards one by one, so it holds a single lock at a time.
+ */
+class StripedLRU : public Afina::Storage {
+public:
+    StripedLRU(size_t max_size = 1024, size_t stripes = 16);
+    ~StripedLRU() {}
+
+    // Starts reclaiming of expired entries in background
+    void Start() override;
+
+    // see Start
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetShared(const std::string &key, SharedValue &value) override;
+
+    // Implements Afina::Storage interface, lock of each shard is taken once
+    size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override;
+
+private:
+    // Single stripe: lock and the part of data it protects
+    struct Shard {
+        explicit Shard(size_t max_size) : storage(max_size) {}
+
+        std::mutex mutex;
+        SimpleLRU storage;
+    };
+
+    size_t Index(const std::string &key) const;
+    Shard &Select(const std::string &key) { return *_shards[Index(key)]; }
+
+    // Shards are allocated separately to keep their locks on different cache lines
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    // Must be destroyed first, it calls back into shards
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_STRIPED_LRU_H
@@ -4,7 +4,9 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
+#include "Reaper.h"
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -17,30 +19,40 @@ namespace Backend {
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ThreadSafeSimplLRU(size_t max_size = 1024)
+        : SimpleLRU(max_size), _reaper([this]() {
+              std::lock_guard<std::mutex> lock(_storage_mutex);
+              SimpleLRU::Expire();
+          }) {}
     ~ThreadSafeSimplLRU() {}
 
+    // Starts reclaiming of expired entries in background
+    void Start() override { _reaper.Start(); }
+
+    // see Start
+    void Stop() override { _reaper.Stop(); }
+
     // see SimpleLRU.h
-    bool Put(const std::string &key, const std::string &value) override {
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override {
         _storage_mutex.lock();
-        bool res = SimpleLRU::Put(key, value);
+        bool res = SimpleLRU::Put(key, value, ttl);
         _storage_mutex.unlock();
 
         return res;
     }
 
     // see SimpleLRU.h
-    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override {
         _storage_mutex.lock();
-        bool res = SimpleLRU::PutIfAbsent(key, value);
+        bool res = SimpleLRU::PutIfAbsent(key, value, ttl);
         _storage_mutex.unlock();
 
         return res;}
 
     // see SimpleLRU.h
-    bool Set(const std::string &key, const std::string &value) override {
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override {
         _storage_mutex.lock();
-        bool res = SimpleLRU::Set(key, value);
+        bool res = SimpleLRU::Set(key, value, ttl);
         _storage_mutex.unlock();
 
         return res;
@@ -65,8 +77,41 @@ public:
         return res;
     }
 
+    // see SimpleLRU.h
+    bool GetShared(const std::string &key, SharedValue &value) override {
+        _storage_mutex.lock();
+        bool res = SimpleLRU::GetShared(key, value);
+        _storage_mutex.unlock();
+
+        return res;
+    }
+
+    // Implements Afina::Storage interface, lock is taken once for all keys
+    size_t GetSharedMany(const std::vector<const std::string *> &keys, std::vector<SharedValue> &values) override {
+        std::lock_guard<std::mutex> lock(_storage_mutex);
+        values.resize(keys.size());
+        size_t found = 0;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (SimpleLRU::GetShared(*keys[i], values[i])) {
+                found++;
+            } else {
+                values[i].reset();
+            }
+        }
+        return found;
+    }
+
+    // see SimpleLRU.h
+    void Usage(size_t &items, size_t &bytes) override {
+        std::lock_guard<std::mutex> lock(_storage_mutex);
+        SimpleLRU::Usage(items, bytes);
+    }
+
 private:
     std::mutex _storage_mutex;
+
+    // Must be destroyed first, it calls back into the storage
+    Reaper _reaper;
 };
 
 } // namespace Backend
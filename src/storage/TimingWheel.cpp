@@ -0,0 +1,141 @@
+#include "TimingWheel.h"
+
+#include <chrono>
+
+namespace Afina {
+namespace Backend {
+
+// See TimingWheel.h
+uint32_t ExpirationClock() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    auto passed = std::chrono::steady_clock::now() - start;
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(passed).count()) + 1;
+}
+
+// See TimingWheel.h
+TimingWheel::TimingWheel(uint32_t now) : _current(now) {
+    for (auto &slot : _root) {
+        slot.wheel_prev = slot.wheel_next = &slot;
+    }
+    for (auto &level : _levels) {
+        for (auto &slot : level) {
+            slot.wheel_prev = slot.wheel_next = &slot;
+        }
+    }
+}
+
+// See TimingWheel.h
+void TimingWheel::Schedule(TimerHook &hook, uint32_t deadline) {
+    if (hook.Linked()) {
+        Unlink(hook);
+    }
+
+    hook.deadline = deadline;
+    if (deadline != 0) {
+        Place(hook);
+    }
+}
+
+// See TimingWheel.h
+void TimingWheel::Cancel(TimerHook &hook) {
+    if (hook.Linked()) {
+        Unlink(hook);
+    }
+}
+
+// See TimingWheel.h
+void TimingWheel::Move(TimerHook &from, TimerHook &to) {
+    to.deadline = from.deadline;
+    if (!from.Linked()) {
+        to.wheel_prev = to.wheel_next = nullptr;
+        return;
+    }
+
+    to.wheel_prev = from.wheel_prev;
+    to.wheel_next = from.wheel_next;
+    to.wheel_prev->wheel_next = &to;
+    to.wheel_next->wheel_prev = &to;
+    from.wheel_prev = from.wheel_next = nullptr;
+}
+
+// See TimingWheel.h
+void TimingWheel::Place(TimerHook &hook) {
+    // Already late timers fires on the next tick
+    if (hook.deadline <= _current) {
+        Link(_root[(_current + 1) & kRootMask], hook);
+        return;
+    }
+
+    uint32_t delta = hook.deadline - _current;
+    if (delta < kRootSize) {
+        Link(_root[hook.deadline & kRootMask], hook);
+        return;
+    }
+
+    for (uint32_t level = 0; level < kLevels; level++) {
+        uint32_t shift = kRootBits + level * kLevelBits;
+        if (delta < (uint64_t(1) << (shift + kLevelBits))) {
+            Link(_levels[level][(hook.deadline >> shift) & kLevelMask], hook);
+            return;
+        }
+    }
+
+    // Too far in the future: park in the slot which gets cascaded last
+    uint32_t shift = kRootBits + (kLevels - 1) * kLevelBits;
+    Link(_levels[kLevels - 1][((_current >> shift) - 1) & kLevelMask], hook);
+}
+
+// See TimingWheel.h
+void TimingWheel::Cascade() {
+    for (uint32_t level = 0; level < kLevels; level++) {
+        uint32_t shift = kRootBits + level * kLevelBits;
+        uint32_t index = (_current >> shift) & kLevelMask;
+        TimerHook &slot = _levels[level][index];
+
+        // Detach whole list first: parked timers could be placed back into the same slot
+        TimerHook pending;
+        pending.wheel_prev = pending.wheel_next = &pending;
+        if (slot.wheel_next != &slot) {
+            pending.wheel_next = slot.wheel_next;
+            pending.wheel_prev = slot.wheel_prev;
+            pending.wheel_next->wheel_prev = &pending;
+            pending.wheel_prev->wheel_next = &pending;
+            slot.wheel_prev = slot.wheel_next = &slot;
+        }
+
+        while (pending.wheel_next != &pending) {
+            TimerHook *hook = pending.wheel_next;
+            Unlink(*hook);
+
+            // Current root slot is not processed yet, so timers due right now go there
+            if (hook->deadline == _current) {
+                Link(_root[_current & kRootMask], *hook);
+            } else {
+                Place(*hook);
+            }
+        }
+
+        // Upper level moves only once this one made a full turn
+        if (index != 0) {
+            break;
+        }
+    }
+}
+
+// See TimingWheel.h
+void TimingWheel::Link(TimerHook &slot, TimerHook &hook) {
+    hook.wheel_prev = slot.wheel_prev;
+    hook.wheel_next = &slot;
+    slot.wheel_prev->wheel_next = &hook;
+    slot.wheel_prev = &hook;
+}
+
+// See TimingWheel.h
+void TimingWheel::Unlink(TimerHook &hook) {
+    hook.wheel_prev->wheel_next = hook.wheel_next;
+    hook.wheel_next->wheel_prev = hook.wheel_prev;
+    hook.wheel_prev = hook.wheel_next = nullptr;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,135 @@
+#ifndef AFINA_STORAGE_TIMING_WHEEL_H
+#define AFINA_STORAGE_TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Coarse monotonic clock used for expiration: seconds passed since first call plus one, so
+ * that zero could be used as "never" mark
+ */
+uint32_t ExpirationClock();
+
+/**
+ * Deadline of the entry which gets given ttl right now. Zero ttl means it never expires, so does
+ * Storage::kKeepTTL for the entry which has no expiration to keep
+ */
+inline uint32_t Deadline(uint32_t ttl) {
+    return ttl == 0 || ttl == Storage::kKeepTTL ? 0 : ExpirationClock() + ttl;
+}
+
+/**
+ * # Timer embedded into storage entry
+ * Entry that could expire derives from the hook, wheel links hooks into its slots
+ */
+struct TimerHook {
+    TimerHook() : wheel_prev(nullptr), wheel_next(nullptr), deadline(0) {}
+
+    // Tick at which entry expires, 0 means never
+    inline bool Expired(uint32_t now) const { return deadline != 0 && deadline <= now; }
+
+    inline bool Linked() const { return wheel_next != nullptr; }
+
+    TimerHook *wheel_prev;
+    TimerHook *wheel_next;
+    uint32_t deadline;
+};
+
+/**
+ * # Hierarchical timing wheel
+ * Four levels of slots: 256 slots of one tick each, then 3 levels of 64 slots each covers
+ * 64 times more ticks than the previous one. Scheduling and cancellation are O(1), advancing
+ * wheel by one tick is O(1) amortized: entry is moved at most once per level before it fires.
+ *
+ * Entries which are further than the wheel could cover are parked in the last slot of the
+ * top level and rescheduled once it gets cascaded.
+ *
+ * Wheel doesn't own hooks, owner of the entries must not use wheel with them once it is destroyed.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TimingWheel {
+public:
+    explicit TimingWheel(uint32_t now = ExpirationClock());
+
+    /**
+     * Links hook into the wheel so that it fires once wheel is advanced up to deadline. If hook
+     * is linked already then it is rescheduled. Zero deadline cancels the timer
+     */
+    void Schedule(TimerHook &hook, uint32_t deadline);
+
+    /**
+     * Unlinks hook from the wheel, does nothing if hook isn't linked
+     */
+    void Cancel(TimerHook &hook);
+
+    /**
+     * Transfers timer from one hook to another, for entries that change their address
+     */
+    void Move(TimerHook &from, TimerHook &to);
+
+    /**
+     * Advances wheel up to the given tick, calls expired(hook) for every hook that reaches its
+     * deadline. Hook is already unlinked when callback gets called, so it is safe to destroy it.
+     *
+     * @return number of fired timers
+     */
+    template <typename F> size_t Advance(uint32_t now, F &&expired) {
+        size_t fired = 0;
+        while (_current < now) {
+            _current++;
+            if ((_current & kRootMask) == 0) {
+                Cascade();
+            }
+
+            TimerHook &slot = _root[_current & kRootMask];
+            while (slot.wheel_next != &slot) {
+                TimerHook *hook = slot.wheel_next;
+                Unlink(*hook);
+                expired(*hook);
+                fired++;
+            }
+        }
+        return fired;
+    }
+
+    inline uint32_t Current() const { return _current; }
+
+private:
+    static const uint32_t kRootBits = 8;
+    static const uint32_t kRootSize = 1 << kRootBits;
+    static const uint32_t kRootMask = kRootSize - 1;
+    static const uint32_t kLevelBits = 6;
+    static const uint32_t kLevelSize = 1 << kLevelBits;
+    static const uint32_t kLevelMask = kLevelSize - 1;
+    static const uint32_t kLevels = 3;
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    // Puts linked hook to the slot matches its deadline
+    void Place(TimerHook &hook);
+
+    // Moves timers from upper levels slots that become current down the wheel
+    void Cascade();
+
+    static void Link(TimerHook &slot, TimerHook &hook);
+    static void Unlink(TimerHook &hook);
+
+    // Last tick wheel was advanced to
+    uint32_t _current;
+
+    // Slots are sentinels of circular lists
+    TimerHook _root[kRootSize];
+    TimerHook _levels[kLevels][kLevelSize];
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TIMING_WHEEL_H
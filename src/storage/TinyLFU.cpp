@@ -0,0 +1,287 @@
+#include "TinyLFU.h"
+
+#include <functional>
+
+#include <afina/Statistics.h>
+
+namespace Afina {
+namespace Backend {
+
+// See TinyLFU.h
+TinyLFU::TinyLFU(size_t max_size) : _max_size(max_size), _size_now(0) {
+    size_t window = max_size * kWindowPercent / 100;
+    _segments[kWindow].max_size = window;
+    _segments[kProtected].max_size = (max_size - window) * kProtectedPercent / 100;
+    // Probation takes whatever protected leaves, so its limit is the whole main part
+    _segments[kProbation].max_size = max_size - window;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    uint32_t hash = Hash(key);
+    _sketch.Increment(hash);
+
+    entry *found = Lookup(key);
+    if (found != nullptr) {
+        return Update(*found, value, ttl);
+    }
+
+    if (EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+    Insert(key, value, hash, ttl);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    uint32_t hash = Hash(key);
+    _sketch.Increment(hash);
+
+    if (Lookup(key) != nullptr || EntrySize(key.size(), value.size()) > _max_size) {
+        return false;
+    }
+    Insert(key, value, hash, ttl);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value, uint32_t ttl) {
+    Expire();
+    entry *found = Lookup(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    _sketch.Increment(found->hash);
+    return Update(*found, value, ttl);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key) {
+    entry *found = Lookup(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    Remove(*found);
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    // Misses count too: key asked often deserves a place once it is stored
+    uint32_t hash = Hash(key);
+    _sketch.Increment(hash);
+
+    entry *found = Lookup(key);
+    if (found == nullptr) {
+        return false;
+    }
+
+    Touch(*found);
+    value = found->value;
+    return true;
+}
+
+// See TinyLFU.h
+size_t TinyLFU::Expire() {
+    return _wheel.Advance(ExpirationClock(), [this](TimerHook &hook) { Remove(static_cast<entry &>(hook)); });
+}
+
+// See TinyLFU.h
+uint32_t TinyLFU::Hash(const std::string &key) {
+    uint64_t hash = std::hash<std::string>()(key);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// See TinyLFU.h
+TinyLFU::entry *TinyLFU::Lookup(const std::string &key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+
+    entry &e = it->second;
+    if (e.Expired(ExpirationClock())) {
+        Remove(e);
+        return nullptr;
+    }
+    return &e;
+}
+
+// See TinyLFU.h
+void TinyLFU::Insert(const std::string &key, const std::string &value, uint32_t hash, uint32_t ttl) {
+    _sketch.EnsureCapacity(_entries.size() + 1);
+
+    auto it = _entries.emplace(key, entry()).first;
+    entry &e = it->second;
+    e.key = &it->first;
+    e.value = value;
+    e.hash = hash;
+
+    _size_now += e.footprint();
+    Link(e, kWindow);
+    Schedule(e, ttl);
+    Rebalance();
+}
+
+// See TinyLFU.h
+bool TinyLFU::Update(entry &e, const std::string &value, uint32_t ttl) {
+    if (EntrySize(e.key->size(), value.size()) > _max_size) {
+        return false;
+    }
+
+    // Relinked with the new size, that is an access as well
+    Segment segment = e.segment;
+    Unlink(e);
+    _size_now -= e.footprint();
+    e.value = value;
+    _size_now += e.footprint();
+    Link(e, segment == kProbation ? kProtected : segment);
+
+    if (ttl != kKeepTTL) {
+        Schedule(e, ttl);
+    }
+    Rebalance(&e);
+    return true;
+}
+
+// See TinyLFU.h
+void TinyLFU::Touch(entry &e) {
+    Segment segment = e.segment;
+    Unlink(e);
+    if (segment != kProbation) {
+        Link(e, segment);
+        return;
+    }
+
+    // Second access in the main part, entry is worth protecting
+    Link(e, kProtected);
+    Rebalance();
+}
+
+// See TinyLFU.h
+void TinyLFU::Link(entry &e, Segment segment) {
+    list &l = _segments[segment];
+    e.segment = segment;
+    e.prev = l.tail;
+    e.next = nullptr;
+    if (l.tail != nullptr) {
+        l.tail->next = &e;
+    } else {
+        l.head = &e;
+    }
+    l.tail = &e;
+    l.size += e.footprint();
+}
+
+// See TinyLFU.h
+void TinyLFU::Unlink(entry &e) {
+    list &l = _segments[e.segment];
+    if (e.prev != nullptr) {
+        e.prev->next = e.next;
+    } else {
+        l.head = e.next;
+    }
+
+    if (e.next != nullptr) {
+        e.next->prev = e.prev;
+    } else {
+        l.tail = e.prev;
+    }
+
+    l.size -= e.footprint();
+    e.prev = e.next = nullptr;
+    e.segment = kSegments;
+}
+
+// See TinyLFU.h
+void TinyLFU::Rebalance(entry *pinned) {
+    list &window = _segments[kWindow];
+    while (window.head != nullptr && window.size > window.max_size) {
+        entry &candidate = *window.head;
+        Unlink(candidate);
+        // Admission decides on new keys only, updated one is already in the cache
+        if (&candidate == pinned) {
+            Link(candidate, kProbation);
+        } else {
+            Admit(candidate);
+        }
+    }
+
+    list &protect = _segments[kProtected];
+    while (protect.head != nullptr && protect.size > protect.max_size) {
+        entry &demoted = *protect.head;
+        Unlink(demoted);
+        Link(demoted, kProbation);
+    }
+
+    // Whatever is left over comes out of the coldest segment
+    while (_size_now > _max_size) {
+        entry *victim = nullptr;
+        for (Segment segment : {kProbation, kProtected, kWindow}) {
+            victim = _segments[segment].head;
+            if (victim == pinned) {
+                victim = victim->next;
+            }
+            if (victim != nullptr) {
+                break;
+            }
+        }
+        Evict(*victim);
+    }
+}
+
+// See TinyLFU.h
+void TinyLFU::Admit(entry &candidate) {
+    size_t main_size = _segments[kProbation].max_size;
+    size_t candidate_frequency = _sketch.Estimate(candidate.hash);
+
+    while (_segments[kProbation].size + _segments[kProtected].size + candidate.footprint() > main_size) {
+        entry *victim = _segments[kProbation].head;
+        if (victim == nullptr) {
+            victim = _segments[kProtected].head;
+        }
+        if (victim == nullptr) {
+            break;
+        }
+
+        // Tie goes to the victim: one time key shouldn't push out anything
+        if (candidate_frequency <= _sketch.Estimate(victim->hash)) {
+            Evict(candidate);
+            return;
+        }
+        Evict(*victim);
+    }
+
+    Link(candidate, kProbation);
+}
+
+// See TinyLFU.h
+void TinyLFU::Evict(entry &e) {
+    // Expired entry is not an eviction, it is gone already
+    if (!e.Expired(ExpirationClock())) {
+        Statistics::Add(Statistics::kEvictions);
+    }
+    Remove(e);
+}
+
+// See TinyLFU.h
+void TinyLFU::Remove(entry &e) {
+    _size_now -= e.footprint();
+    _wheel.Cancel(e);
+    if (e.segment != kSegments) {
+        Unlink(e);
+    }
+
+    _entries.erase(_entries.find(*e.key));
+}
+
+// See TinyLFU.h
+void TinyLFU::Schedule(entry &e, uint32_t ttl) { _wheel.Schedule(e, Deadline(ttl)); }
+
+} // namespace Backend
+} // namespace Afina
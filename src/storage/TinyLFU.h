@@ -0,0 +1,147 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Window TinyLFU
+ * Memory is split between three LRU segments:
+ * - window, 1% of memory: every new entry goes here first, so that recent bursts get a chance
+ * - probation, main part: entries which passed admission but were not accessed since
+ * - protected, 80% of main part: entries accessed again while in probation
+ *
+ * Entry pushed out of the window is a candidate for the main part. If there is no room there it
+ * competes with the least recently used entry of probation: the one accessed more often according
+ * to the frequency sketch stays, the other one is evicted. Sketch records all accesses including
+ * misses and forgets old ones gradually, see FrequencySketch.h. Large scan of keys nobody asks twice
+ * goes through the window and dies there, hot working set in the main part survives it.
+ *
+ * New entry could lose admission right away, in that case Put succeeds but entry is not there.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    TinyLFU(size_t max_size = 1024);
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t ttl = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void Usage(size_t &items, size_t &bytes) override {
+        items = _entries.size();
+        bytes = _size_now;
+    }
+
+    /**
+     * Removes all entries which expiration time has come, returns number of entries removed
+     */
+    size_t Expire();
+
+    /**
+     * Number of bytes entry with given key and value sizes takes from the memory limit
+     */
+    static size_t EntrySize(size_t key_size, size_t value_size) { return key_size + value_size; }
+
+    // Shares of the memory limit, in percents
+    static const size_t kWindowPercent = 1;
+    static const size_t kProtectedPercent = 80;
+
+private:
+    enum Segment { kWindow, kProbation, kProtected, kSegments };
+
+    struct entry;
+
+    // LRU list of a segment: head is the least recently used entry
+    struct list {
+        entry *head = nullptr;
+        entry *tail = nullptr;
+        size_t size = 0;
+        size_t max_size = 0;
+    };
+
+    struct entry : public TimerHook {
+        // Key lives in the index, entry is its value
+        const std::string *key = nullptr;
+        std::string value;
+
+        uint32_t hash = 0;
+        Segment segment = kWindow;
+
+        entry *prev = nullptr;
+        entry *next = nullptr;
+
+        inline size_t footprint() const { return EntrySize(key->size(), value.size()); }
+    };
+
+    static uint32_t Hash(const std::string &key);
+
+    // Finds live entry for the key, expired one gets removed on the way
+    entry *Lookup(const std::string &key);
+
+    // Creates new entry in the window, then restores memory limits
+    void Insert(const std::string &key, const std::string &value, uint32_t hash, uint32_t ttl);
+
+    // Replaces value of the existing entry and counts it as access
+    bool Update(entry &e, const std::string &value, uint32_t ttl);
+
+    // Moves entry on access: within its segment or from probation to protected
+    void Touch(entry &e);
+
+    // Segment list maintenance
+    void Link(entry &e, Segment segment);
+    void Unlink(entry &e);
+
+    // Moves entries out of the window into main part and out of protected into probation until
+    // all segments fit their limits and total size fits the memory limit. Pinned entry is one being
+    // updated: it skips admission and is never evicted
+    void Rebalance(entry *pinned = nullptr);
+
+    // Candidate pushed out of the window tries to get into the main part
+    void Admit(entry &candidate);
+
+    // Removes entry from everywhere and releases it, eviction is counted in statistics
+    void Evict(entry &e);
+    void Remove(entry &e);
+
+    void Schedule(entry &e, uint32_t ttl);
+
+    std::size_t _max_size;
+    std::size_t _size_now;
+
+    list _segments[kSegments];
+
+    std::unordered_map<std::string, entry> _entries;
+    FrequencySketch _sketch;
+
+    // Expiration timers of the entries which have TTL
+    TimingWheel _wheel;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
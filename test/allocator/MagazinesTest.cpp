@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Magazines.h>
+#include <afina/allocator/Pointer.h>
+
+using namespace Afina::Allocator;
+
+namespace {
+
+void stamp(Pointer &p, size_t size, char seed) {
+    char *v = reinterpret_cast<char *>(p.get());
+    for (size_t i = 0; i < size; i++) {
+        v[i] = char(seed + i);
+    }
+}
+
+bool isStamped(const Pointer &p, size_t size, char seed) {
+    const char *v = reinterpret_cast<const char *>(p.get());
+    for (size_t i = 0; i < size; i++) {
+        if (v[i] != char(seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(MagazinesTest, ReuseFromMagazine) {
+    std::vector<char> area(1 << 20);
+    Magazines a(area.data(), area.size());
+
+    Pointer p = a.alloc(100);
+    void *address = p.get();
+    ASSERT_NE(address, nullptr);
+    a.free(p);
+    EXPECT_EQ(p.get(), nullptr);
+
+    // Just freed block is on top of the magazine
+    Pointer q = a.alloc(100);
+    EXPECT_EQ(address, q.get());
+    a.free(q);
+
+    std::string dump = a.dump();
+    EXPECT_NE(std::string::npos, dump.find("hit rate 50.0%")) << dump;
+}
+
+TEST(MagazinesTest, Large) {
+    std::vector<char> area(1 << 20);
+    Magazines a(area.data(), area.size());
+
+    Pointer p = a.alloc(Magazines::kMaxCached + 1000);
+    stamp(p, Magazines::kMaxCached + 1000, 3);
+
+    a.realloc(p, 3 * Magazines::kMaxCached);
+    EXPECT_TRUE(isStamped(p, Magazines::kMaxCached + 1000, 3));
+    a.free(p);
+
+    try {
+        a.alloc(2 << 20);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+}
+
+TEST(MagazinesTest, ReallocAcrossClasses) {
+    std::vector<char> area(1 << 20);
+    Magazines a(area.data(), area.size());
+
+    Pointer p;
+    size_t size = 10;
+    a.realloc(p, size);
+    stamp(p, size, 7);
+    for (size_t next : {50, 200, 1000, 5000, 20000, 100}) {
+        a.realloc(p, next);
+        ASSERT_TRUE(isStamped(p, std::min(size, next), 7));
+        stamp(p, next, 7);
+        size = next;
+    }
+    a.free(p);
+}
+
+TEST(MagazinesTest, Threads) {
+    std::vector<char> area(16 << 20);
+    Magazines a(area.data(), area.size());
+
+    const int threads = 8;
+    std::vector<std::thread> workers;
+    std::vector<int> failures(threads, 0);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&a, &failures, t]() {
+            struct Live {
+                Pointer p;
+                size_t size;
+            };
+            std::vector<Live> live(64);
+            unsigned seed = t;
+            for (int step = 0; step < 20000; step++) {
+                Live &l = live[rand_r(&seed) % live.size()];
+                if (l.p.get() != nullptr) {
+                    failures[t] += !isStamped(l.p, l.size, char(t));
+                    a.free(l.p);
+                }
+                l.size = 64 + rand_r(&seed) % 8192;
+                l.p = a.alloc(l.size);
+                stamp(l.p, l.size, char(t));
+            }
+
+            for (auto &l : live) {
+                failures[t] += !isStamped(l.p, l.size, char(t));
+                a.free(l.p);
+            }
+        });
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (int count : failures) {
+        EXPECT_EQ(0, count);
+    }
+
+    // Everything cached goes back, the whole area is available after defrag
+    a.defrag();
+    Pointer p = a.alloc(area.size() / 2);
+    EXPECT_NE(p.get(), nullptr);
+    a.free(p);
+}
@@ -1,4 +1,6 @@
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -322,3 +324,98 @@ TEST(SimpleTest, ReallocGrow) {
     a.free(p);
     a.free(p2);
 }
+
+TEST(SimpleTest, InvalidFree) {
+    Simple a(buf, sizeof(buf));
+
+    Pointer p = a.alloc(100);
+    Pointer copy = p;
+    a.free(p);
+    EXPECT_EQ(p.get(), nullptr);
+
+    try {
+        a.free(copy);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::InvalidFree);
+    }
+
+    // Empty pointer is fine
+    Pointer empty;
+    a.free(empty);
+}
+
+static void stamp(Pointer &p, size_t size, char seed) {
+    char *v = reinterpret_cast<char *>(p.get());
+    for (size_t i = 0; i < size; i++) {
+        v[i] = char(seed + i);
+    }
+}
+
+static bool isStamped(const Pointer &p, size_t size, char seed) {
+    const char *v = reinterpret_cast<const char *>(p.get());
+    for (size_t i = 0; i < size; i++) {
+        if (v[i] != char(seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(SimpleTest, RandomMixed) {
+    Simple a(buf, sizeof(buf));
+
+    struct Live {
+        Pointer p;
+        size_t size;
+        char seed;
+    };
+    vector<Live> live;
+
+    srand(42);
+    for (int step = 0; step < 20000; step++) {
+        int action = rand() % 10;
+        if (action < 5 || live.empty()) {
+            // Mostly small ones, some large
+            size_t size = (rand() % 4 == 0) ? 600 + rand() % 3000 : 1 + rand() % 500;
+            try {
+                Live l{a.alloc(size), size, char(rand())};
+                ASSERT_EQ(0, reinterpret_cast<uintptr_t>(l.p.get()) % 16);
+                ASSERT_TRUE(isValidMemory(l.p, size));
+                stamp(l.p, size, l.seed);
+                live.push_back(l);
+            } catch (AllocError &e) {
+                ASSERT_EQ(e.getType(), AllocErrorType::NoMemory);
+                a.defrag();
+            }
+        } else if (action < 8) {
+            size_t i = rand() % live.size();
+            ASSERT_TRUE(isStamped(live[i].p, live[i].size, live[i].seed));
+            a.free(live[i].p);
+            live.erase(live.begin() + i);
+        } else {
+            size_t i = rand() % live.size();
+            size_t size = 1 + rand() % 2000;
+            try {
+                a.realloc(live[i].p, size);
+            } catch (AllocError &e) {
+                ASSERT_EQ(e.getType(), AllocErrorType::NoMemory);
+                continue;
+            }
+            ASSERT_TRUE(isStamped(live[i].p, std::min(size, live[i].size), live[i].seed));
+            live[i].size = size;
+            stamp(live[i].p, size, live[i].seed);
+        }
+    }
+
+    a.defrag();
+    for (auto &l : live) {
+        ASSERT_TRUE(isStamped(l.p, l.size, l.seed));
+        a.free(l.p);
+    }
+
+    // Everything is released, the whole area is available again
+    a.defrag();
+    Pointer all = a.alloc(sizeof(buf) / 2);
+    EXPECT_NE(all.get(), nullptr);
+}
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include <functional>
+#include <list>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <afina/allocator/Magazines.h>
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/StdAllocator.h>
+
+using namespace Afina::Allocator;
+
+namespace {
+
+typedef std::basic_string<char, std::char_traits<char>, StdAllocator<char>> String;
+
+// Cache in the style of SimpleLRU: index by key and list of entries from the oldest to the newest, all
+// of it lives in the arena. Entries are evicted once arena is full
+class ArenaLRU {
+public:
+    ArenaLRU(Simple &arena)
+        : _arena(arena), _entries(StdAllocator<Entry>(arena)),
+          _index(std::less<String>(), StdAllocator<std::pair<const String, Iterator>>(arena)) {}
+
+    void Put(const std::string &key, const std::string &value) {
+        Delete(key);
+        for (;;) {
+            try {
+                _entries.emplace_back(String(key.data(), key.size(), StdAllocator<char>(_arena)),
+                                      String(value.data(), value.size(), StdAllocator<char>(_arena)));
+                try {
+                    _index.emplace(_entries.back().first, std::prev(_entries.end()));
+                } catch (std::bad_alloc &) {
+                    _entries.pop_back();
+                    throw;
+                }
+                return;
+            } catch (std::bad_alloc &) {
+                if (_entries.empty()) {
+                    throw;
+                }
+                Delete(std::string(_entries.front().first.data(), _entries.front().first.size()));
+                evicted++;
+            }
+        }
+    }
+
+    bool Get(const std::string &key, std::string &value) {
+        auto it = _index.find(String(key.data(), key.size(), StdAllocator<char>(_arena)));
+        if (it == _index.end()) {
+            return false;
+        }
+        value.assign(it->second->second.data(), it->second->second.size());
+        _entries.splice(_entries.end(), _entries, it->second);
+        return true;
+    }
+
+    void Delete(const std::string &key) {
+        auto it = _index.find(String(key.data(), key.size(), StdAllocator<char>(_arena)));
+        if (it != _index.end()) {
+            Iterator entry = it->second;
+            _index.erase(it);
+            _entries.erase(entry);
+        }
+    }
+
+    size_t size() const { return _index.size(); }
+    size_t evicted = 0;
+
+private:
+    typedef std::pair<String, String> Entry;
+    typedef std::list<Entry, StdAllocator<Entry>>::iterator Iterator;
+
+    Simple &_arena;
+    std::list<Entry, StdAllocator<Entry>> _entries;
+    std::map<String, Iterator, std::less<String>, StdAllocator<std::pair<const String, Iterator>>> _index;
+};
+
+} // namespace
+
+TEST(StdAllocatorTest, Vector) {
+    std::vector<char> area(1 << 20);
+    Simple arena(area.data(), area.size());
+
+    {
+        std::vector<int, StdAllocator<int>> v{StdAllocator<int>(arena)};
+        for (int i = 0; i < 10000; i++) {
+            v.push_back(i);
+        }
+        for (int i = 0; i < 10000; i++) {
+            ASSERT_EQ(i, v[i]);
+        }
+
+        // Vector grows by reallocation, only the last buffer is alive
+        Simple::Usage usage = arena.usage();
+        EXPECT_EQ(1, usage.used_blocks);
+        EXPECT_GE(usage.used, 10000 * sizeof(int));
+        EXPECT_GE(static_cast<void *>(v.data()), static_cast<void *>(area.data()));
+        EXPECT_LT(static_cast<void *>(v.data()), static_cast<void *>(area.data() + area.size()));
+    }
+
+    EXPECT_EQ(0, arena.usage().used_blocks);
+}
+
+TEST(StdAllocatorTest, String) {
+    std::vector<char> area(1 << 16);
+    Simple arena(area.data(), area.size());
+
+    String s{StdAllocator<char>(arena)};
+    for (int i = 0; i < 100; i++) {
+        s += "0123456789";
+    }
+    EXPECT_EQ(1000, s.size());
+    EXPECT_EQ(0, s.compare(990, 10, "0123456789"));
+
+    // Long enough to exceed the arena
+    EXPECT_THROW(s.resize(1 << 17), std::bad_alloc);
+}
+
+TEST(StdAllocatorTest, Rebind) {
+    std::vector<char> area(1 << 16);
+    Simple arena(area.data(), area.size());
+
+    StdAllocator<int> ints(arena);
+    StdAllocator<double> doubles(ints);
+    EXPECT_TRUE(ints == doubles);
+
+    std::vector<char> other_area(1 << 16);
+    Simple other(other_area.data(), other_area.size());
+    EXPECT_TRUE(ints != StdAllocator<int>(other));
+}
+
+TEST(StdAllocatorTest, BoundedLRU) {
+    std::vector<char> area(64 * 1024);
+    Simple arena(area.data(), area.size());
+
+    ArenaLRU cache(arena);
+    const int keys = 2000;
+    for (int i = 0; i < keys; i++) {
+        cache.Put("key" + std::to_string(i), std::string(40, 'a' + i % 26));
+    }
+
+    // Arena is too small for all of them, the oldest are gone, the newest are alive
+    EXPECT_GT(cache.evicted, 0);
+    EXPECT_EQ(keys, cache.size() + cache.evicted);
+
+    std::string value;
+    EXPECT_FALSE(cache.Get("key0", value));
+    ASSERT_TRUE(cache.Get("key" + std::to_string(keys - 1), value));
+    EXPECT_EQ(std::string(40, 'a' + (keys - 1) % 26), value);
+
+    // Everything cache takes is in the arena
+    Simple::Usage usage = arena.usage();
+    EXPECT_LE(usage.used, area.size());
+    EXPECT_GT(usage.used_blocks, cache.size());
+}
+
+TEST(StdAllocatorTest, Magazines) {
+    std::vector<char> area(1 << 20);
+    Magazines arena(area.data(), area.size());
+
+    std::vector<std::vector<int, StdAllocator<int, Magazines>>> vectors;
+    for (int i = 0; i < 100; i++) {
+        vectors.emplace_back(i, i, StdAllocator<int, Magazines>(arena));
+    }
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(size_t(i), vectors[i].size());
+        for (int x : vectors[i]) {
+            ASSERT_EQ(i, x);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(CoreLocalTest, SlotsDoNotShareCacheLines) {
+    CoreLocal<std::atomic<long>> local;
+    ASSERT_GE(local.size(), 1);
+
+    std::vector<std::atomic<long> *> slots;
+    local.ForEach([&slots](std::atomic<long> &value) { slots.push_back(&value); });
+    ASSERT_EQ(local.size(), slots.size());
+
+    const long line = CoreLocal<long>::kCacheLine;
+    for (size_t i = 0; i < slots.size(); i++) {
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(slots[i]) % line);
+        if (i > 0) {
+            EXPECT_GE(reinterpret_cast<char *>(slots[i]) - reinterpret_cast<char *>(slots[i - 1]), line);
+        }
+    }
+}
+
+TEST(CoreLocalTest, CombineSeesAllIncrements) {
+    CoreLocal<std::atomic<long>> local;
+    local.ForEach([](std::atomic<long> &value) { value.store(0); });
+
+    const int kThreads = 8, kIncrements = 100000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&local]() {
+            for (int j = 0; j < kIncrements; j++) {
+                local.Local().fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    long total = local.Combine(0L, [](long sum, std::atomic<long> &value) { return sum + value.load(); });
+    EXPECT_EQ(long(kThreads) * kIncrements, total);
+}
+
+TEST(CoreLocalTest, CpuOfPinnedThread) {
+    cpu_set_t saved;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(saved), &saved));
+
+    // Any CPU thread is allowed to run on
+    int target = 0;
+    while (!CPU_ISSET(target, &saved)) {
+        target++;
+    }
+
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    CPU_SET(target, &pinned);
+    ASSERT_EQ(0, sched_setaffinity(0, sizeof(pinned), &pinned));
+
+    EXPECT_EQ(target, CoreLocal<long>::Cpu());
+    EXPECT_EQ(sched_getcpu(), CoreLocal<long>::Cpu());
+
+    sched_setaffinity(0, sizeof(saved), &saved);
+}
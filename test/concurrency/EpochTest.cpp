@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Epoch.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+std::atomic<int> destroyed(0);
+
+struct Tracked {
+    ~Tracked() { destroyed++; }
+};
+
+} // namespace
+
+TEST(EpochTest, RetiredWaitsForReaders) {
+    destroyed = 0;
+    EpochManager manager;
+
+    // Reader enters before retirement and stays until told to go
+    std::atomic<bool> entered(false), release(false);
+    std::thread reader([&]() {
+        EpochManager::Guard guard(manager);
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    manager.Retire(new Tracked());
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(0, manager.Collect());
+    }
+    EXPECT_EQ(0, destroyed.load());
+
+    release = true;
+    reader.join();
+
+    // Two advances are needed after the reader is gone
+    size_t freed = 0;
+    for (int i = 0; i < 3; i++) {
+        freed += manager.Collect();
+    }
+    EXPECT_EQ(1, freed);
+    EXPECT_EQ(1, destroyed.load());
+}
+
+TEST(EpochTest, NestedSections) {
+    destroyed = 0;
+    EpochManager manager;
+
+    std::atomic<int> stage(0);
+    std::thread reader([&]() {
+        EpochManager::Guard outer(manager);
+        {
+            EpochManager::Guard inner(manager);
+        }
+
+        // Still inside the outer section
+        stage = 1;
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    manager.Retire(new Tracked());
+    for (int i = 0; i < 5; i++) {
+        manager.Collect();
+    }
+    EXPECT_EQ(0, destroyed.load());
+
+    stage = 2;
+    reader.join();
+    for (int i = 0; i < 3; i++) {
+        manager.Collect();
+    }
+    EXPECT_EQ(1, destroyed.load());
+}
+
+TEST(EpochTest, LeftoversDestroyedWithManager) {
+    destroyed = 0;
+    {
+        EpochManager manager;
+        std::thread retirer([&manager]() {
+            for (int i = 0; i < 10; i++) {
+                manager.Retire(new Tracked());
+            }
+        });
+        retirer.join();
+        EXPECT_EQ(0, destroyed.load());
+    }
+    EXPECT_EQ(10, destroyed.load());
+}
+
+TEST(EpochTest, ReadersNeverSeeReclaimed) {
+    // Object is marked dead on reclamation and kept, so that reader touching it could tell
+    struct Object {
+        std::atomic<bool> dead{false};
+        long value = 0;
+    };
+
+    // Manager is destroyed first, reclaiming the rest into the graveyard
+    std::vector<std::unique_ptr<Object>> graveyard;
+    static std::vector<std::unique_ptr<Object>> *bury;
+    bury = &graveyard;
+
+    EpochManager manager;
+    std::atomic<Object *> current(new Object());
+
+    std::atomic<bool> running(true);
+    std::atomic<long> reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&]() {
+            while (running.load(std::memory_order_relaxed)) {
+                EpochManager::Guard guard(manager);
+                Object *o = current.load(std::memory_order_acquire);
+                ASSERT_FALSE(o->dead.load());
+                std::this_thread::yield();
+                ASSERT_FALSE(o->dead.load());
+                reads++;
+            }
+        });
+    }
+
+    // Writer replaces the object and retires the old one, reclamation only marks it
+    for (long i = 1; i <= 20000; i++) {
+        Object *o = new Object();
+        o->value = i;
+        Object *old = current.exchange(o, std::memory_order_acq_rel);
+        manager.Retire(old, [](void *p) {
+            Object *o = static_cast<Object *>(p);
+            o->dead = true;
+            bury->emplace_back(o);
+        });
+    }
+
+    running = false;
+    for (auto &r : readers) {
+        r.join();
+    }
+
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_GT(graveyard.size(), 0);
+    delete current.load();
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+TEST(ExecutorTest, RunsAllTasks) {
+    std::atomic<int> done(0);
+    {
+        Executor executor("test", 4);
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(executor.Execute([&done]() { done++; }));
+        }
+        executor.Stop(true);
+        EXPECT_EQ(Executor::State::kStopped, executor.state());
+    }
+    EXPECT_EQ(1000, done.load());
+}
+
+TEST(ExecutorTest, PassesArguments) {
+    std::atomic<int> sum(0);
+    Executor executor("test", 2);
+    for (int i = 1; i <= 100; i++) {
+        EXPECT_TRUE(executor.Execute([&sum](int a, int b) { sum += a * b; }, i, 2));
+    }
+    executor.Stop(true);
+    EXPECT_EQ(10100, sum.load());
+}
+
+TEST(ExecutorTest, RejectsAfterStop) {
+    std::atomic<int> done(0);
+    Executor executor("test", 2);
+    executor.Stop(true);
+
+    EXPECT_FALSE(executor.Execute([&done]() { done++; }));
+    EXPECT_EQ(0, done.load());
+}
+
+TEST(ExecutorTest, StopCompletesQueuedTasks) {
+    std::atomic<int> done(0);
+    Executor executor("test", 1);
+    for (int i = 0; i < 10; i++) {
+        executor.Execute([&done]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            done++;
+        });
+    }
+
+    executor.Stop(false);
+    EXPECT_FALSE(executor.Execute([]() {}));
+    executor.Stop(true);
+    EXPECT_EQ(10, done.load());
+}
+
+// Tasks spawned by tasks go to the local deque and get stolen by idle workers
+TEST(ExecutorTest, NestedTasks) {
+    std::atomic<int> done(0);
+    Executor executor("test", 4);
+
+    std::function<void(int)> spawn = [&](int depth) {
+        done++;
+        if (depth > 0) {
+            executor.Execute(spawn, depth - 1);
+            executor.Execute(spawn, depth - 1);
+        }
+    };
+    executor.Execute(spawn, 12);
+
+    // Root task and its descendants must be done before pool stops accepting new ones
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done.load() < (1 << 13) - 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.Stop(true);
+    EXPECT_EQ((1 << 13) - 1, done.load());
+}
+
+TEST(ExecutorTest, ConcurrentProducers) {
+    const int producers = 4;
+    const int tasks = 10000;
+
+    std::atomic<int> accepted(0), done(0);
+    Executor executor("test", 4, 1 << 16);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < tasks; i++) {
+                if (executor.Execute([&done]() { done++; })) {
+                    accepted++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    executor.Stop(true);
+    EXPECT_EQ(producers * tasks, accepted.load());
+    EXPECT_EQ(accepted.load(), done.load());
+}
+
+TEST(ExecutorTest, SurvivesThrowingTask) {
+    std::atomic<int> done(0);
+    Executor executor("test", 1);
+    executor.Execute([]() { throw std::runtime_error("task failed"); });
+    executor.Execute([&done]() { done++; });
+    executor.Stop(true);
+    EXPECT_EQ(1, done.load());
+}
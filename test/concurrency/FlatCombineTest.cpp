@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+// Plain counter, correct only if operations never overlap
+struct Increment {
+    void operator()() {
+        if (fail) {
+            throw std::runtime_error("fail");
+        }
+        long value = *counter;
+        *counter = value + 1;
+    }
+
+    long *counter;
+    bool fail;
+};
+
+} // namespace
+
+TEST(FlatCombineTest, OperationsDoNotOverlap) {
+    FlatCombine<Increment> combine;
+    long counter = 0;
+
+    const int kThreads = 8, kIncrements = 20000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&combine, &counter]() {
+            for (int j = 0; j < kIncrements; j++) {
+                Increment op{&counter, false};
+                combine.Apply(op);
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(long(kThreads) * kIncrements, counter);
+}
+
+TEST(FlatCombineTest, ExceptionReachesCaller) {
+    FlatCombine<Increment> combine;
+    long counter = 0;
+
+    Increment bad{&counter, true};
+    EXPECT_THROW(combine.Apply(bad), std::runtime_error);
+
+    // Slot is released despite of the error
+    Increment good{&counter, false};
+    combine.Apply(good);
+    EXPECT_EQ(1, counter);
+}
+
+TEST(FlatCombineTest, MoreThreadsThanSlots) {
+    FlatCombine<Increment> combine;
+    long counter = 0;
+
+    const int kThreads = FlatCombine<Increment>::kSlots + 16, kIncrements = 200;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&combine, &counter]() {
+            for (int j = 0; j < kIncrements; j++) {
+                Increment op{&counter, false};
+                combine.Apply(op);
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(long(kThreads) * kIncrements, counter);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(ThreadLocalTest, InstancePerThread) {
+    ThreadLocal<std::atomic<long>> local;
+    std::atomic<long> *main = &local.Local();
+    EXPECT_EQ(main, &local.Local());
+
+    // Threads run one after another would share one instance, so keep them all alive at once
+    const int kThreads = 4;
+    std::vector<std::atomic<long> *> seen(kThreads);
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&local, &seen, &ready, i]() {
+            seen[i] = &local.Local();
+            ready++;
+            while (ready.load() < kThreads) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::set<std::atomic<long> *> distinct(seen.begin(), seen.end());
+    distinct.insert(main);
+    EXPECT_EQ(kThreads + 1, distinct.size());
+    EXPECT_EQ(kThreads + 1, local.size());
+
+    const long line = ThreadLocal<long>::kCacheLine;
+    for (auto value : distinct) {
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(value) % line);
+    }
+}
+
+TEST(ThreadLocalTest, CombineSeesAllIncrements) {
+    ThreadLocal<std::atomic<long>> local;
+
+    const int kThreads = 8, kIncrements = 100000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&local]() {
+            for (int j = 0; j < kIncrements; j++) {
+                local.Local().fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Threads have exited, their instances are still counted
+    long total = local.Combine(0L, [](long sum, std::atomic<long> &value) { return sum + value.load(); });
+    EXPECT_EQ(long(kThreads) * kIncrements, total);
+}
+
+TEST(ThreadLocalTest, ExitedThreadInstanceReused) {
+    ThreadLocal<std::atomic<long>> local;
+
+    for (int i = 0; i < 10; i++) {
+        std::thread([&local]() { local.Local()++; }).join();
+    }
+
+    EXPECT_EQ(1, local.size());
+    long total = 0;
+    local.ForEach([&total](std::atomic<long> &value) { total += value.load(); });
+    EXPECT_EQ(10, total);
+}
+
+TEST(ThreadLocalTest, Independent) {
+    ThreadLocal<long> a, b;
+    a.Local() = 1;
+    b.Local() = 2;
+    EXPECT_EQ(1, a.Local());
+    EXPECT_EQ(2, b.Local());
+}
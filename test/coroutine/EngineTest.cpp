@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <afina/coroutine/Engine.h>
 
@@ -62,3 +64,214 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+using Afina::Coroutine::Engine;
+
+class EngineModeTest : public ::testing::TestWithParam<Engine::Mode> {};
+
+TEST_P(EngineModeTest, SimpleStart) {
+    Engine engine(GetParam());
+
+    int result = 0;
+    engine.start(_calculator_add, result, 1, 2);
+
+    ASSERT_EQ(3, result);
+}
+
+struct PingPong {
+    std::stringstream out;
+    void *pa = nullptr;
+    void *pb = nullptr;
+};
+
+void _ping_pong(Engine &pe, PingPong &state, std::string &result) {
+    state.pa = pe.run(printa, pe, state.out, state.pb);
+    state.pb = pe.run(printb, pe, state.out, state.pa);
+    pe.sched(state.pa);
+
+    state.out << "END";
+    result = state.out.str();
+}
+
+TEST_P(EngineModeTest, Printer) {
+    Engine engine(GetParam());
+
+    PingPong state;
+    std::string result;
+    engine.start(_ping_pong, engine, state, result);
+    ASSERT_EQ("A1 B1 A2 B2 A3 B3 END", result);
+}
+
+void _counter(Engine &pe, std::vector<int> &trace, int id, int rounds) {
+    for (int i = 0; i < rounds; i++) {
+        trace.push_back(id);
+        pe.yield();
+    }
+}
+
+void _spawner(Engine &pe, std::vector<int> &trace, int routines, int rounds) {
+    for (int i = 0; i < routines; i++) {
+        pe.run(_counter, pe, trace, int(i), int(rounds));
+    }
+}
+
+TEST_P(EngineModeTest, YieldRunsEveryone) {
+    Engine engine(GetParam());
+
+    const int routines = 100, rounds = 10;
+    std::vector<int> trace;
+    engine.start(_spawner, engine, trace, int(routines), int(rounds));
+
+    // Every routine made all of its steps, and no routine got ahead of the others by more than a round
+    ASSERT_EQ(routines * rounds, trace.size());
+    std::vector<int> steps(routines, 0);
+    for (int id : trace) {
+        ASSERT_GE(id, 0);
+        ASSERT_LT(id, routines);
+        steps[id]++;
+        for (int count : steps) {
+            ASSERT_LE(steps[id] - count, 1);
+        }
+    }
+    for (int count : steps) {
+        EXPECT_EQ(rounds, count);
+    }
+}
+
+int _deep(Engine &pe, int depth) {
+    // Something on the stack that must survive switches
+    volatile char frame[512];
+    frame[0] = char(depth);
+    frame[sizeof(frame) - 1] = char(depth);
+
+    int result = 0;
+    if (depth > 0) {
+        result = _deep(pe, depth - 1);
+    } else {
+        pe.yield();
+    }
+
+    pe.yield();
+    return result + (frame[0] == char(depth)) + (frame[sizeof(frame) - 1] == char(depth));
+}
+
+void _deep_routine(Engine &pe, int &result, int depth) { result = _deep(pe, depth); }
+
+void _deep_spawner(Engine &pe, int &left, int &right, int depth) {
+    pe.run(_deep_routine, pe, left, int(depth));
+    pe.run(_deep_routine, pe, right, int(depth));
+}
+
+TEST_P(EngineModeTest, DeepStacks) {
+    Engine engine(GetParam());
+
+    const int depth = 64;
+    int left = 0, right = 0;
+    engine.start(_deep_spawner, engine, left, right, int(depth));
+
+    EXPECT_EQ(2 * (depth + 1), left);
+    EXPECT_EQ(2 * (depth + 1), right);
+}
+
+TEST_P(EngineModeTest, Restart) {
+    Engine engine(GetParam());
+
+    // Engine could be started again once all coroutines are done, stacks are reused
+    for (int i = 0; i < 3; i++) {
+        std::vector<int> trace;
+        engine.start(_spawner, engine, trace, int(50), int(3));
+        ASSERT_EQ(150, trace.size());
+    }
+}
+
+struct Mailbox {
+    std::vector<int> values;
+    void *reader = nullptr;
+    std::vector<std::string> trace;
+};
+
+void _reader(Engine &pe, Mailbox &box, int expected) {
+    box.reader = pe.current();
+    while (box.values.size() < size_t(expected)) {
+        box.trace.push_back("wait");
+        pe.block();
+    }
+    box.trace.push_back("done");
+}
+
+void _writer(Engine &pe, Mailbox &box, int count) {
+    for (int i = 0; i < count; i++) {
+        box.values.push_back(i);
+        box.trace.push_back("put");
+        pe.unblock(box.reader);
+        pe.yield();
+    }
+}
+
+void _mailbox(Engine &pe, Mailbox &box, int count) {
+    void *reader = pe.run(_reader, pe, box, int(count));
+    pe.sched(reader);
+    pe.run(_writer, pe, box, int(count));
+}
+
+TEST_P(EngineModeTest, BlockUnblock) {
+    Engine engine(GetParam());
+
+    Mailbox box;
+    engine.start(_mailbox, engine, box, int(2));
+
+    std::vector<std::string> expected = {"wait", "put", "wait", "put", "done"};
+    ASSERT_EQ(expected, box.trace);
+}
+
+void _sleeper(Engine &pe, std::vector<void *> &sleeping, int &woken) {
+    sleeping.push_back(pe.current());
+    pe.block();
+    woken++;
+}
+
+void _sleepers(Engine &pe, std::vector<void *> &sleeping, int &woken, int count) {
+    for (int i = 0; i < count; i++) {
+        pe.run(_sleeper, pe, sleeping, woken);
+    }
+}
+
+TEST_P(EngineModeTest, Unblocker) {
+    // Plays the role of event loop: everybody is blocked, so wake up one of them
+    std::vector<void *> sleeping;
+    int calls = 0;
+    Engine *engine = nullptr;
+    Engine instance(GetParam(), Engine::kDefaultStackSize, [&]() {
+        calls++;
+        ASSERT_FALSE(sleeping.empty());
+        engine->unblock(sleeping.back());
+        sleeping.pop_back();
+    });
+    engine = &instance;
+
+    int woken = 0;
+    instance.start(_sleepers, instance, sleeping, woken, int(10));
+
+    EXPECT_EQ(10, woken);
+    EXPECT_EQ(10, calls);
+    EXPECT_TRUE(sleeping.empty());
+}
+
+TEST_P(EngineModeTest, BlockedLeftOnShutdown) {
+    // Nobody unblocks sleepers, they are released once start() returns
+    Engine engine(GetParam());
+
+    std::vector<void *> sleeping;
+    int woken = 0;
+    engine.start(_sleepers, engine, sleeping, woken, int(10));
+    EXPECT_EQ(10, sleeping.size());
+    EXPECT_EQ(0, woken);
+
+    // Engine is still usable after that
+    sleeping.clear();
+    engine.start(_sleepers, engine, sleeping, woken, int(1));
+    EXPECT_EQ(1, sleeping.size());
+}
+
+INSTANTIATE_TEST_CASE_P(Modes, EngineModeTest,
+                        ::testing::Values(Engine::Mode::kCopyStack, Engine::Mode::kSeparateStack));
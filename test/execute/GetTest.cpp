@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+TEST(GetTest, ResponseMatchesText) {
+    Backend::SimpleLRU storage(1024 * 1024);
+    storage.Put("small", "value");
+    storage.Put("large", std::string(4096, 'x'));
+
+    Get get({"small", "missing", "large"});
+
+    std::string text;
+    get.Execute(storage, "", text);
+
+    Response response;
+    get.Execute(storage, "", response);
+    EXPECT_EQ(text, response.str());
+    EXPECT_EQ(text.size(), response.size());
+}
+
+TEST(GetTest, ValueIsNotCopied) {
+    Backend::SimpleLRU storage(1024 * 1024);
+    storage.Put("large", std::string(4096, 'x'));
+
+    SharedValue stored;
+    ASSERT_TRUE(storage.GetShared("large", stored));
+
+    Response response;
+    Get({"large"}).Execute(storage, "", response);
+
+    // VALUE header, value itself, trailer with END
+    std::vector<Response::Segment> &segments = response.segments();
+    ASSERT_EQ(3, segments.size());
+    EXPECT_EQ("VALUE large 0 4096\r\n", segments[0].text);
+    EXPECT_EQ(stored->data(), segments[1].data());
+    EXPECT_EQ("\r\nEND", segments[2].text);
+}
+
+TEST(ResponseTest, MergesText) {
+    Response response;
+    response.Append("STORED");
+    response.Append("\r\n", 2);
+    response.Append(SharedValue());
+    response.Append(std::make_shared<const std::string>("abc"));
+    response.Append("END");
+
+    ASSERT_EQ(3, response.segments().size());
+    EXPECT_EQ("STORED\r\n", response.segments()[0].text);
+    EXPECT_EQ("STORED\r\nabcEND", response.str());
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <afina/Statistics.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Stats.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+// Runs stats command and parses "STAT <name> <value>" lines
+static std::map<std::string, long long> Collect(Storage &storage) {
+    std::string out;
+    Stats().Execute(storage, "", out);
+
+    std::map<std::string, long long> result;
+    std::istringstream lines(out);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string stat, name;
+        long long value;
+        if (fields >> stat >> name >> value && stat == "STAT") {
+            result[name] = value;
+        }
+    }
+
+    EXPECT_EQ("END", out.substr(out.size() - 3));
+    return result;
+}
+
+TEST(StatsTest, CountsCommands) {
+    Backend::SimpleLRU storage(1024 * 1024);
+    auto before = Collect(storage);
+
+    std::string out;
+    Set("a", 0, 0).Execute(storage, "1", out);
+    Set("b", 0, 0).Execute(storage, "22", out);
+    Get({"a", "b", "missing"}).Execute(storage, "", out);
+
+    Response response;
+    Get({"a", "missing"}).Execute(storage, "", response);
+
+    auto after = Collect(storage);
+    EXPECT_EQ(2, after["cmd_set"] - before["cmd_set"]);
+    EXPECT_EQ(5, after["cmd_get"] - before["cmd_get"]);
+    EXPECT_EQ(3, after["get_hits"] - before["get_hits"]);
+    EXPECT_EQ(2, after["get_misses"] - before["get_misses"]);
+
+    size_t bytes = Backend::SimpleLRU::EntrySize(1, 1) + Backend::SimpleLRU::EntrySize(1, 2);
+    EXPECT_EQ(2, after["curr_items"]);
+    EXPECT_EQ(bytes, after["bytes"]);
+    EXPECT_EQ(getpid(), after["pid"]);
+}
+
+TEST(StatsTest, CountsEvictions) {
+    const std::string value(100, 'x');
+    const size_t entry = Backend::SimpleLRU::EntrySize(2, value.size());
+    Backend::SimpleLRU storage(entry * 3);
+
+    long long before = Statistics::Get(Statistics::kEvictions);
+    for (int i = 0; i < 10; i++) {
+        storage.Put("k" + std::to_string(i), value);
+    }
+
+    EXPECT_EQ(7, Statistics::Get(Statistics::kEvictions) - before);
+    EXPECT_EQ(3, Collect(storage)["curr_items"]);
+}
@@ -1,14 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/ClientError.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Replace.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
 #include <protocol/Parser.h>
+#include <protocol/Scanner.h>
 
 using namespace Afina;
 
@@ -58,6 +63,56 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify multi-digit and negative expiration time
+TEST(MemcachedParserTest, ExpireTime) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("replace foo 0 3600 6\r\n", consumed));
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+
+    Execute::Replace *tmp = reinterpret_cast<Execute::Replace *>(cmd.get());
+    ASSERT_EQ(3600, tmp->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 0 -120 6\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_EQ(-120, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+
+    parser.Reset();
+    ASSERT_THROW(parser.Parse("set foo 0 99999999999 6\r\n", consumed), std::runtime_error);
+}
+
+// Verify keys over the limit are answered with client error and body is still skipped
+TEST(MemcachedParserTest, KeyTooLong) {
+    for (auto mode : {Protocol::Parser::Mode::kScalar, Protocol::Parser::Mode::kVector}) {
+        Protocol::Parser parser(mode);
+        std::string longest(Protocol::Parser::kMaxKeySize, 'k');
+
+        size_t consumed = 0, value_size = 0;
+        ASSERT_TRUE(parser.Parse("set " + longest + " 0 0 6\r\n", consumed));
+        std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+        ASSERT_NE(nullptr, dynamic_cast<Execute::Set *>(cmd.get()));
+
+        parser.Reset();
+        consumed = 0;
+        ASSERT_TRUE(parser.Parse("set " + longest + "k 0 0 6\r\n", consumed));
+        cmd = parser.Build(value_size);
+        ASSERT_NE(nullptr, dynamic_cast<Execute::ClientError *>(cmd.get()));
+        ASSERT_EQ(6, value_size);
+
+        parser.Reset();
+        consumed = 0;
+        ASSERT_TRUE(parser.Parse("get foo " + longest + "k\r\n", consumed));
+        cmd = parser.Build(value_size);
+        ASSERT_NE(nullptr, dynamic_cast<Execute::ClientError *>(cmd.get()));
+        ASSERT_EQ(0, value_size);
+    }
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -98,3 +153,111 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+// Feeds input to the parser in pieces of given size, the way connection does, and describes every
+// command built out of it
+static std::vector<std::string> Feed(Protocol::Parser::Mode mode, const std::string &input, size_t step) {
+    std::vector<std::string> result;
+    Protocol::Parser parser(mode);
+
+    size_t offset = 0;
+    try {
+        while (offset < input.size()) {
+            size_t parsed = 0;
+            bool complete = parser.Parse(input.data() + offset, std::min(step, input.size() - offset), parsed);
+            offset += parsed;
+            if (!complete) {
+                continue;
+            }
+
+            size_t body_size = 0;
+            std::unique_ptr<Execute::Command> cmd = parser.Build(body_size);
+            std::string out = parser.Name() + " body=" + std::to_string(body_size) + " at=" + std::to_string(offset);
+            if (auto *insert = dynamic_cast<Execute::InsertCommand *>(cmd.get())) {
+                out += " key=" + insert->key() + " flags=" + std::to_string(insert->flags()) +
+                       " expire=" + std::to_string(insert->expire());
+            } else if (auto *get = dynamic_cast<Execute::Get *>(cmd.get())) {
+                for (auto &key : get->keys()) {
+                    out += " key=" + key;
+                }
+            }
+            result.push_back(out);
+
+            parser.Reset();
+            offset += body_size > 0 ? body_size + 2 : 0;
+        }
+    } catch (std::runtime_error &ex) {
+        result.push_back(std::string("error: ") + ex.what());
+    }
+    return result;
+}
+
+// Vector parser must produce exactly the same commands and errors as byte-by-byte one
+TEST(MemcachedParserTest, VectorEquivalence) {
+    const std::string long_key(250, 'k');
+    const std::vector<std::string> inputs = {
+        "set foo 0 0 6\r\nfooval\r\n",
+        "add bar 10 -1 60\r\n",
+        "replace k 4294967295 2592000 0\r\n",
+        "append key 1 -2147483648 0\r\n",
+        "prepend p 0 0 1\r\nx\r\n",
+        "get a\r\n",
+        "get a bb ccc dddd eeeee ffffff ggggggg hhhhhhhh iiiiiiiii jjjjjjjjjj\r\n",
+        "gets x y\r\n",
+        "stats\r\n",
+        "set " + long_key + " 0 0 3\r\nabc\r\nget " + long_key + " " + long_key + "\r\n",
+        "get a\r\nget b\r\nset c 1 2 3\r\nxyz\r\nstats\r\nget d e\r\n",
+        "set foo 0 0 6 noreply\r\nfooval\r\n",
+        "set foo 00012 -0 06\r\nfooval\r\n",
+        "get  a\r\n",
+        "get a \r\n",
+        "set foo 0 99999999999 6\r\n",
+        "set foo 5000000000 0 6\r\n",
+        "set foo 0 0 6\n",
+        "set foo x 0 6\r\n",
+        "set foo 0 0 6\rx",
+        "bogus key\r\n",
+        "stats x\r\n",
+        "get\r\n",
+        "\r\n",
+    };
+
+    for (auto &input : inputs) {
+        for (size_t step : {input.size(), size_t(1), size_t(2), size_t(7), size_t(33)}) {
+            ASSERT_EQ(Feed(Protocol::Parser::Mode::kScalar, input, step), Feed(Protocol::Parser::Mode::kVector, input, step))
+                << input << " by " << step;
+        }
+    }
+}
+
+// Every vector scanner must find the same delimiter as the scalar one, wherever it is
+TEST(MemcachedParserTest, ScannerEquivalence) {
+    std::string buffer(256, 'a');
+    for (size_t i = 0; i < buffer.size(); i++) {
+        buffer[i] = char('a' + i % 26);
+    }
+
+    for (Protocol::Isa isa : {Protocol::Isa::kSSE2, Protocol::Isa::kAVX2}) {
+        if (!Protocol::Supported(isa)) {
+            continue;
+        }
+
+        for (char delimiter : {' ', '\r', '\n'}) {
+            for (size_t at = 0; at < 100; at++) {
+                std::string input = buffer;
+                input[at] = delimiter;
+                input[at + 1 + at % 3] = ' ';
+
+                for (size_t begin = 0; begin < 40; begin++) {
+                    for (size_t end = begin; end < 140; end += 3) {
+                        const char *data = input.data();
+                        ASSERT_EQ(Protocol::FindDelimiter(Protocol::Isa::kScalar, data + begin, data + end),
+                                  Protocol::FindDelimiter(isa, data + begin, data + end));
+                    }
+                }
+            }
+        }
+        ASSERT_EQ(Protocol::FindDelimiter(Protocol::Isa::kScalar, buffer.data(), buffer.data() + buffer.size()),
+                  Protocol::FindDelimiter(buffer.data(), buffer.data() + buffer.size()));
+    }
+}
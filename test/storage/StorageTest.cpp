@@ -1,7 +1,12 @@
 #include "gtest/gtest.h"
+#include <atomic>
 #include <iomanip>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <map>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,17 +15,31 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/ARC.h"
+#include "storage/ClockLRU.h"
+#include "storage/EpochLRU.h"
+#include "storage/FlatCombineLRU.h"
+#include "storage/FrequencySketch.h"
+#include "storage/HashLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/Slab.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TimingWheel.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
 using namespace std;
 
+// Every storage with a single global LRU order must pass all the tests below
+template <typename T> class StorageTest : public ::testing::Test {};
 
+typedef ::testing::Types<SimpleLRU, ThreadSafeSimplLRU, HashLRU, FlatCombineLRU, ClockLRU, ARC> StorageTypes;
+TYPED_TEST_CASE(StorageTest, StorageTypes);
 
-
-TEST(StorageTest, PutGet) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, PutGet) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
     EXPECT_TRUE(storage.Put("KEY2", "val2"));
@@ -33,8 +52,8 @@ TEST(StorageTest, PutGet) {
     EXPECT_TRUE(value == "val2");
 }
 
-TEST(StorageTest, PutOverwrite) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, PutOverwrite) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
     EXPECT_TRUE(storage.Put("KEY1", "val2"));
@@ -44,8 +63,8 @@ TEST(StorageTest, PutOverwrite) {
     EXPECT_TRUE(value == "val2");
 }
 
-TEST(StorageTest, PutIfAbsent) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, PutIfAbsent) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.PutIfAbsent("KEY1", "val1"));
 
@@ -56,8 +75,8 @@ TEST(StorageTest, PutIfAbsent) {
     EXPECT_TRUE(value == "val1");
 }
 
-TEST(StorageTest, PutSetGet) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, PutSetGet) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
     EXPECT_TRUE(storage.Set("KEY1", "val2"));
@@ -69,8 +88,8 @@ TEST(StorageTest, PutSetGet) {
     EXPECT_TRUE(value == "val2");
 }
 
-TEST(StorageTest, SetIfAbsent) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, SetIfAbsent) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
 
@@ -80,8 +99,8 @@ TEST(StorageTest, SetIfAbsent) {
     EXPECT_TRUE(value == "val1");
 }
 
-TEST(StorageTest, PutDeleteGet) {
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, PutDeleteGet) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
     EXPECT_TRUE(storage.Put("KEY2", "val2"));
@@ -95,9 +114,8 @@ TEST(StorageTest, PutDeleteGet) {
 }
 
 
-TEST(StorageTest, GetIfAbsent)
-{
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, GetIfAbsent) {
+    TypeParam storage;
 
 
     std::string value;
@@ -108,9 +126,8 @@ TEST(StorageTest, GetIfAbsent)
     EXPECT_FALSE(storage.Get("KEY3", value));
 }
 
-TEST(StorageTest, DeleteIfAbsent)
-{
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, DeleteIfAbsent) {
+    TypeParam storage;
     EXPECT_FALSE(storage.Delete("KEY1"));
 
     EXPECT_FALSE(storage.Delete("KEY2"));
@@ -118,9 +135,8 @@ TEST(StorageTest, DeleteIfAbsent)
     EXPECT_FALSE(storage.Delete("KEY3"));
 }
 
-TEST(StorageTest, DeleteHeadAndTailNode)
-{
-    SimpleLRU storage;
+TYPED_TEST(StorageTest, DeleteHeadAndTailNode) {
+    TypeParam storage;
 
     EXPECT_TRUE(storage.Put("KEY1", "val1"));
     EXPECT_TRUE(storage.Put("KEY2", "val2"));
@@ -139,15 +155,152 @@ TEST(StorageTest, DeleteHeadAndTailNode)
     EXPECT_TRUE(storage.Delete("KEY1"));
 }
 
+TYPED_TEST(StorageTest, ResizeValue) {
+    TypeParam storage(16 * 1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Set("KEY1", std::string(1000, 'x')));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(1000, 'x'), value);
+
+    EXPECT_TRUE(storage.Set("KEY1", "short"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("short", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ("val3", value);
+}
+
+TYPED_TEST(StorageTest, GetShared) {
+    TypeParam storage(64 * 1024);
+
+    const std::string large(8 * 1024, 'x');
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", large));
+
+    Afina::SharedValue small_value, large_value;
+    EXPECT_TRUE(storage.GetShared("KEY1", small_value));
+    EXPECT_TRUE(storage.GetShared("KEY2", large_value));
+    EXPECT_FALSE(storage.GetShared("KEY3", small_value));
+    EXPECT_EQ("val1", *small_value);
+    EXPECT_EQ(large, *large_value);
+
+    // Handed out buffers are immutable and outlive association
+    EXPECT_TRUE(storage.Set("KEY2", std::string(8 * 1024, 'y')));
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_EQ("val1", *small_value);
+    EXPECT_EQ(large, *large_value);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(std::string(8 * 1024, 'y'), value);
+}
+
+TYPED_TEST(StorageTest, GetSharedMany) {
+    TypeParam storage(64 * 1024);
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    // Stale value gets reset for the missing key
+    std::string k1 = "KEY1", k2 = "KEY2", k3 = "KEY3";
+    std::vector<const std::string *> keys = {&k2, &k3, &k1, &k2};
+    std::vector<Afina::SharedValue> values = {nullptr, std::make_shared<const std::string>("stale")};
+    EXPECT_EQ(3, storage.GetSharedMany(keys, values));
+    ASSERT_EQ(4, values.size());
+    EXPECT_EQ("val2", *values[0]);
+    EXPECT_FALSE(values[1]);
+    EXPECT_EQ("val1", *values[2]);
+    EXPECT_EQ("val2", *values[3]);
+}
+
+TEST(SimpleLRUTest, SharedValueWithoutCopy) {
+    SimpleLRU storage(64 * 1024);
+    EXPECT_TRUE(storage.Put("KEY", std::string(SimpleLRU::kSharedValueSize, 'x')));
+
+    Afina::SharedValue first, second;
+    EXPECT_TRUE(storage.GetShared("KEY", first));
+    EXPECT_TRUE(storage.GetShared("KEY", second));
+    EXPECT_EQ(first.get(), second.get());
+
+    // Large values are accounted by their size, so that they push out others
+    SimpleLRU limited(2 * SimpleLRU::EntrySize(3, 4096));
+    EXPECT_TRUE(limited.Put("KE1", std::string(4096, 'a')));
+    EXPECT_TRUE(limited.Put("KE2", std::string(4096, 'b')));
+    EXPECT_TRUE(limited.Put("KE3", std::string(4096, 'c')));
+
+    std::string value;
+    EXPECT_FALSE(limited.Get("KE1", value));
+    EXPECT_TRUE(limited.Get("KE2", value));
+    EXPECT_TRUE(limited.Get("KE3", value));
+}
+
+TEST(SimpleLRUTest, CompactLayout) {
+    // Entry without TTL is the header packed in a few dozens of bytes, key and value
+    EXPECT_LE(SimpleLRU::EntrySize(10, 20), SlabAllocator::ChunkSize(40 + 30));
+
+    SimpleLRU storage(64 * 1024);
+    EXPECT_TRUE(storage.Put(std::string(SimpleLRU::kMaxKeySize, 'k'), "val"));
+    EXPECT_FALSE(storage.Put(std::string(SimpleLRU::kMaxKeySize + 1, 'k'), "val"));
+    EXPECT_TRUE(storage.Delete(std::string(SimpleLRU::kMaxKeySize, 'k')));
+
+    // Timer is there only once entry gets TTL
+    size_t items, bytes;
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    storage.Usage(items, bytes);
+    EXPECT_EQ(SimpleLRU::EntrySize(4, 4), bytes);
+
+    EXPECT_TRUE(storage.Set("KEY1", "val1", 1));
+    EXPECT_TRUE(storage.Put("KEY2", std::string(SimpleLRU::kSharedValueSize, 'x'), 1));
+    storage.Usage(items, bytes);
+    EXPECT_LT(SimpleLRU::EntrySize(4, 4) + SimpleLRU::EntrySize(4, SimpleLRU::kSharedValueSize), bytes);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    storage.Usage(items, bytes);
+    EXPECT_EQ(0, items);
+    EXPECT_EQ(0, bytes);
+}
+
+TEST(SimpleLRUTest, SetKeepsTimer) {
+    // Entry updated in place keeps its timer, so it is larger than untimed entry of the same size
+    SimpleLRU storage(SimpleLRU::EntrySize(1, 2000));
+    EXPECT_TRUE(storage.Put("k", std::string(1100, 'a'), 100));
+    EXPECT_FALSE(storage.Set("k", std::string(2000, 'b'), 0));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("k", value));
+    EXPECT_EQ(std::string(1100, 'a'), value);
+
+    // Once it fits, value is replaced and nothing else is lost
+    EXPECT_TRUE(storage.Set("k", std::string(1900, 'c'), 0));
+    EXPECT_TRUE(storage.Get("k", value));
+    EXPECT_EQ(std::string(1900, 'c'), value);
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(1, items);
+    EXPECT_LE(bytes, SimpleLRU::EntrySize(1, 2000));
+}
+
 std::string pad_space(const std::string &s, size_t length) {
     std::string result = s;
     result.resize(length, ' ');
     return result;
 }
 
-TEST(StorageTest, BigTest) {
+TYPED_TEST(StorageTest, BigTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 100000 * length);
+    TypeParam storage(100000 * TypeParam::EntrySize(length, length));
 
     for (long i = 0; i < 100000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
@@ -166,9 +319,9 @@ TEST(StorageTest, BigTest) {
     }
 }
 
-TEST(StorageTest, MaxTest) {
+TYPED_TEST(StorageTest, MaxTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 1000 * length);
+    TypeParam storage(1000 * TypeParam::EntrySize(length, length));
 
     std::stringstream ss;
 
@@ -195,3 +348,754 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TYPED_TEST(StorageTest, LruOrder) {
+    const size_t length = 20;
+    TypeParam storage(100 * TypeParam::EntrySize(length, length));
+
+    for (long i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    // Refresh every even key and delete every 7th, then push out half of the cache
+    std::string res;
+    for (long i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+    for (long i = 0; i < 100; i += 7) {
+        EXPECT_TRUE(storage.Delete(pad_space("Key " + std::to_string(i), length)));
+    }
+    for (long i = 100; i < 158; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    for (long i = 0; i < 100; ++i) {
+        bool expected = (i % 2 == 0) && (i % 7 != 0);
+        EXPECT_EQ(expected, storage.Get(pad_space("Key " + std::to_string(i), length), res)) << i;
+    }
+    for (long i = 100; i < 158; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+}
+
+TYPED_TEST(StorageTest, Expiration) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.Put("short", "val1", 1));
+    EXPECT_TRUE(storage.Put("long", "val2", 3600));
+    EXPECT_TRUE(storage.Put("forever", "val3"));
+    EXPECT_TRUE(storage.Put("reset", "val4", 1));
+    EXPECT_TRUE(storage.Set("reset", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("short", value));
+    EXPECT_TRUE(value == "val1");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+    EXPECT_FALSE(storage.Get("short", value));
+    EXPECT_FALSE(storage.Set("short", "val6"));
+    EXPECT_FALSE(storage.Delete("short"));
+    EXPECT_TRUE(storage.PutIfAbsent("short", "val7"));
+
+    EXPECT_TRUE(storage.Get("long", value));
+    EXPECT_TRUE(value == "val2");
+    EXPECT_TRUE(storage.Get("forever", value));
+    EXPECT_TRUE(value == "val3");
+    EXPECT_TRUE(storage.Get("reset", value));
+    EXPECT_TRUE(value == "val5");
+}
+
+TYPED_TEST(StorageTest, AppendKeepsExpiration) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.Put("short", "val1", 1));
+    EXPECT_TRUE(storage.Put("forever", "val2"));
+
+    std::string out;
+    Append("short", 0, 0).Execute(storage, "+", out);
+    EXPECT_EQ("STORED", out);
+    // Large enough to move the entry to another place
+    Append("short", 0, 0).Execute(storage, std::string(500, 'x'), out);
+    EXPECT_EQ("STORED", out);
+    Append("forever", 0, 0).Execute(storage, "+", out);
+    EXPECT_EQ("STORED", out);
+    Append("missing", 0, 0).Execute(storage, "+", out);
+    EXPECT_EQ("NOT_STORED", out);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("short", value));
+    EXPECT_EQ("val1+" + std::string(500, 'x'), value);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+    EXPECT_FALSE(storage.Get("short", value));
+    EXPECT_TRUE(storage.Get("forever", value));
+    EXPECT_EQ("val2+", value);
+}
+
+TEST(StripedLRUTest, PutGetDelete) {
+    StripedLRU storage(1024 * 1024, 8);
+
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Val " + std::to_string(i)));
+    }
+
+    EXPECT_FALSE(storage.PutIfAbsent("Key 10", "other"));
+    EXPECT_TRUE(storage.Set("Key 10", "Val 10 updated"));
+    EXPECT_TRUE(storage.Delete("Key 20"));
+    EXPECT_FALSE(storage.Delete("Key 20"));
+
+    std::string res;
+    EXPECT_TRUE(storage.Get("Key 10", res));
+    EXPECT_EQ("Val 10 updated", res);
+    EXPECT_FALSE(storage.Get("Key 20", res));
+
+    for (long i = 21; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Get("Key " + std::to_string(i), res));
+        EXPECT_EQ("Val " + std::to_string(i), res);
+    }
+}
+
+TEST(StripedLRUTest, MaxTest) {
+    const size_t length = 20;
+    const size_t stripes = 4;
+    const size_t limit = 1000 * SimpleLRU::EntrySize(length, length);
+    StripedLRU storage(limit, stripes);
+
+    for (long i = 0; i < 2000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    // Each shard keeps its own budget, so no more than 1000 items could survive in total
+    size_t found = 0;
+    for (long i = 0; i < 2000; ++i) {
+        std::string res;
+        if (storage.Get(pad_space("Key " + std::to_string(i), length), res)) {
+            found++;
+        }
+    }
+    EXPECT_LE(found, 1000);
+    EXPECT_GE(found, 1000 - stripes);
+
+    // Pair that doesn't fit into a single shard must be rejected
+    EXPECT_FALSE(storage.Put("big", std::string(limit / stripes, 'x')));
+}
+
+TEST(StripedLRUTest, GetSharedMany) {
+    StripedLRU storage(16 * 1024 * 1024, 4);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) {
+        names.push_back("key" + std::to_string(i));
+        if (i % 3 != 0) {
+            EXPECT_TRUE(storage.Put(names.back(), std::to_string(i)));
+        }
+    }
+
+    // Keys of all shards mixed up, values come back in the order of keys
+    std::vector<const std::string *> keys;
+    for (auto &name : names) {
+        keys.push_back(&name);
+    }
+    std::vector<Afina::SharedValue> values;
+    EXPECT_EQ(66, storage.GetSharedMany(keys, values));
+    for (int i = 0; i < 100; i++) {
+        if (i % 3 == 0) {
+            EXPECT_FALSE(values[i]);
+        } else {
+            ASSERT_TRUE(values[i]);
+            EXPECT_EQ(std::to_string(i), *values[i]);
+        }
+    }
+}
+
+TEST(StripedLRUTest, Concurrent) {
+    StripedLRU storage(16 * 1024 * 1024);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&storage, t]() {
+            std::string res;
+            for (int i = 0; i < 10000; i++) {
+                auto key = std::to_string(t) + ":" + std::to_string(i);
+                storage.Put(key, key);
+                storage.Get(key, res);
+            }
+        });
+    }
+
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    std::string res;
+    for (int t = 0; t < 4; t++) {
+        for (int i = 0; i < 10000; i++) {
+            auto key = std::to_string(t) + ":" + std::to_string(i);
+            EXPECT_TRUE(storage.Get(key, res));
+            EXPECT_EQ(key, res);
+        }
+    }
+}
+
+TEST(StripedLRUTest, Expiration) {
+    StripedLRU storage(1024, 4);
+    storage.Start();
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 1));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+    storage.Stop();
+}
+
+TEST(ClockLRUTest, SecondChance) {
+    ClockLRU storage(4 * ClockLRU::EntrySize(4, 4));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + std::to_string(i), "val" + std::to_string(i)));
+    }
+
+    // Referenced entries survive one turn of the hand, the rest go in ring order
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY0", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+    EXPECT_TRUE(storage.Put("KEY5", "val5"));
+
+    EXPECT_TRUE(storage.Get("KEY0", value));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+    EXPECT_TRUE(storage.Get("KEY5", value));
+
+    // Growing value never pushes out the entry itself
+    EXPECT_TRUE(storage.Set("KEY5", std::string(ClockLRU::EntrySize(4, 4) * 4 - 4, 'x')));
+    EXPECT_TRUE(storage.Get("KEY5", value));
+    EXPECT_FALSE(storage.Get("KEY0", value));
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(1, items);
+}
+
+TEST(ClockLRUTest, ConcurrentReadersAndWriters) {
+    const size_t length = 16;
+    ClockLRU storage(200 * ClockLRU::EntrySize(length, length));
+    for (int i = 0; i < 100; i++) {
+        auto key = pad_space("hot" + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, key));
+    }
+
+    // Readers keep hot keys referenced while writer pushes cold ones through
+    std::atomic<bool> running(true);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&storage, &running, length, t]() {
+            std::string res;
+            for (int i = t; running.load(); i++) {
+                auto key = pad_space("hot" + std::to_string(i % 100), length);
+                if (storage.Get(key, res)) {
+                    EXPECT_EQ(key, res);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 20000; i++) {
+        auto key = pad_space("cold" + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, key));
+    }
+    running = false;
+    for (auto &r : readers) {
+        r.join();
+    }
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_LE(bytes, 200 * ClockLRU::EntrySize(length, length));
+    EXPECT_EQ(items * ClockLRU::EntrySize(length, length), bytes);
+}
+
+TEST(EpochLRUTest, PutGetDelete) {
+    EpochLRU storage(64 * 1024);
+    std::string value;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val2"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    Afina::SharedValue shared;
+    EXPECT_TRUE(storage.GetShared("KEY1", shared));
+    EXPECT_TRUE(storage.Set("KEY1", std::string(1000, 'x')));
+    EXPECT_EQ("val1", *shared);
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(1000, 'x'), value);
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(2, items);
+    EXPECT_EQ(EpochLRU::EntrySize(4, 1000) + EpochLRU::EntrySize(4, 4), bytes);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Put("BIG", std::string(64 * 1024, 'x')));
+}
+
+TEST(EpochLRUTest, MaxTest) {
+    const size_t length = 20;
+    EpochLRU storage(1000 * EpochLRU::EntrySize(length, length));
+
+    for (long i = 0; i < 10000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, key));
+
+        // Entry just put is referenced, so hand doesn't take it on the first turn
+        std::string res;
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_EQ(key, res);
+    }
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_LE(bytes, 1000 * EpochLRU::EntrySize(length, length));
+    EXPECT_EQ(items * EpochLRU::EntrySize(length, length), bytes);
+}
+
+TEST(EpochLRUTest, Expiration) {
+    EpochLRU storage(1024);
+    storage.Start();
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 1));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Set("KEY1", "val1+", Afina::Storage::kKeepTTL));
+    EXPECT_TRUE(storage.Set("KEY2", "val2", Afina::Storage::kKeepTTL));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Set("KEY1", "val3"));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val2", value);
+    storage.Stop();
+
+    // Whatever reaper hasn't taken out yet
+    storage.Expire();
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(1, items);
+}
+
+TEST(EpochLRUTest, Linearizability) {
+    EpochLRU storage(16 * 1024 * 1024);
+
+    // Every key has a single writer putting growing versions, reader of a linearizable register
+    // never sees a version older than the one it has already seen
+    const int kKeys = 64, kWriters = 4, kReaders = 4;
+    std::atomic<bool> running(true);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < kWriters; w++) {
+        threads.emplace_back([&storage, w]() {
+            for (long version = 1; version <= 5000; version++) {
+                for (int k = w; k < kKeys; k += kWriters) {
+                    auto key = "key" + std::to_string(k);
+                    storage.Put(key, key + ":" + std::to_string(version) + std::string(version % 64, '.'));
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < kReaders; r++) {
+        threads.emplace_back([&storage, &running, r]() {
+            std::vector<long> seen(kKeys, 0);
+            std::vector<std::string> keys;
+            std::vector<const std::string *> batch;
+            for (int k = 0; k < kKeys; k++) {
+                keys.push_back("key" + std::to_string(k));
+            }
+            for (auto &key : keys) {
+                batch.push_back(&key);
+            }
+
+            auto check = [&seen, &keys](int k, const std::string &value) {
+                // Value is whole: no torn or reclaimed buffer
+                long version = std::stol(value.substr(keys[k].size() + 1));
+                ASSERT_EQ(keys[k] + ":" + std::to_string(version) + std::string(version % 64, '.'), value);
+                ASSERT_GE(version, seen[k]);
+                seen[k] = version;
+            };
+
+            std::string value;
+            std::vector<Afina::SharedValue> values;
+            for (int i = r; running.load(); i++) {
+                int k = i % kKeys;
+                if (storage.Get(keys[k], value)) {
+                    check(k, value);
+                }
+                if (i % 100 == 0) {
+                    storage.GetSharedMany(batch, values);
+                    for (int j = 0; j < kKeys; j++) {
+                        if (values[j]) {
+                            check(j, *values[j]);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // PutIfAbsent/Delete pair acts as a lock: only one thread could hold it at a time
+    std::atomic<int> holders(0), acquired(0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, &holders, &acquired, t]() {
+            auto id = std::to_string(t);
+            std::string value;
+            for (int i = 0; i < 2000; i++) {
+                if (!storage.PutIfAbsent("lock", id)) {
+                    continue;
+                }
+
+                EXPECT_EQ(1, ++holders);
+                EXPECT_TRUE(storage.Get("lock", value));
+                EXPECT_EQ(id, value);
+                acquired++;
+                holders--;
+                EXPECT_TRUE(storage.Delete("lock"));
+            }
+        });
+    }
+
+    for (size_t i = 0; i < kWriters; i++) {
+        threads[i].join();
+    }
+    running = false;
+    for (size_t i = kWriters; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    EXPECT_GT(acquired.load(), 0);
+
+    std::string value;
+    for (int k = 0; k < kKeys; k++) {
+        auto key = "key" + std::to_string(k);
+        EXPECT_TRUE(storage.Get(key, value));
+        EXPECT_EQ(key + ":5000" + std::string(5000 % 64, '.'), value);
+    }
+}
+
+TEST(FlatCombineLRUTest, HotKeysConcurrent) {
+    FlatCombineLRU storage(16 * 1024 * 1024);
+
+    // Every thread keeps overwriting the same few keys and checks its own ones
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; t++) {
+        workers.emplace_back([&storage, t]() {
+            std::string res;
+            for (int i = 0; i < 10000; i++) {
+                storage.Put("hot" + std::to_string(i % 4), std::to_string(i));
+                auto key = std::to_string(t) + ":" + std::to_string(i % 100);
+                storage.Put(key, key);
+                EXPECT_TRUE(storage.Get(key, res));
+                EXPECT_EQ(key, res);
+            }
+        });
+    }
+
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(4 + 8 * 100, items);
+}
+
+TEST(FrequencySketchTest, CountsAndAges) {
+    FrequencySketch sketch(1024);
+
+    for (int i = 0; i < 6; i++) {
+        sketch.Increment(42);
+    }
+    sketch.Increment(7);
+
+    EXPECT_EQ(6, sketch.Estimate(42));
+    EXPECT_EQ(1, sketch.Estimate(7));
+    EXPECT_EQ(0, sketch.Estimate(100500));
+
+    // Counters saturate
+    for (int i = 0; i < 100; i++) {
+        sketch.Increment(42);
+    }
+    EXPECT_EQ(FrequencySketch::kMaxCount, sketch.Estimate(42));
+
+    sketch.Age();
+    EXPECT_EQ(FrequencySketch::kMaxCount / 2, sketch.Estimate(42));
+    EXPECT_EQ(0, sketch.Estimate(7));
+}
+
+TEST(ARCTest, ScanDoesntFlushFrequent) {
+    const size_t entry = ARC::EntrySize(8, 8);
+    ARC storage(100 * entry);
+
+    // Keys read once after put are frequent ones
+    char key[16];
+    std::string value;
+    for (int i = 0; i < 50; i++) {
+        std::snprintf(key, sizeof(key), "hot%05d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+
+    // Scan goes through T1 only
+    for (int i = 0; i < 1000; i++) {
+        std::snprintf(key, sizeof(key), "cold%04d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+
+        size_t items, bytes;
+        storage.Usage(items, bytes);
+        ASSERT_LE(bytes, 100 * entry);
+        ASSERT_EQ(items * entry, bytes);
+    }
+
+    for (int i = 0; i < 50; i++) {
+        std::snprintf(key, sizeof(key), "hot%05d", i);
+        EXPECT_TRUE(storage.Get(key, value)) << key;
+    }
+}
+
+TEST(ARCTest, AdaptsTarget) {
+    const size_t entry = ARC::EntrySize(8, 8);
+    ARC storage(10 * entry);
+    EXPECT_EQ(0, storage.target());
+
+    // Key pushed out of T1 and put again right away: T1 deserves more room
+    char key[16];
+    std::string value;
+    for (int i = 0; i < 2; i++) {
+        std::snprintf(key, sizeof(key), "frq%05d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+    for (int i = 0; i < 9; i++) {
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+    }
+    EXPECT_FALSE(storage.Get("key00000", value));
+    EXPECT_TRUE(storage.Put("key00000", "valvalva"));
+    size_t grown = storage.target();
+    EXPECT_GT(grown, 0);
+
+    // Frequent keys pushed out of T2 and put again: T2 deserves it back
+    for (int i = 0; i < 10; i++) {
+        std::snprintf(key, sizeof(key), "frq%05d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+    for (int i = 0; i < 10; i++) {
+        std::snprintf(key, sizeof(key), "frq%05d", i);
+        if (!storage.Get(key, value)) {
+            EXPECT_TRUE(storage.Put(key, "valvalva"));
+        }
+    }
+    EXPECT_LT(storage.target(), grown);
+}
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage(1024);
+    std::string value;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val2"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "longer value"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "longer value");
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_EQ(2, items);
+    EXPECT_EQ(TinyLFU::EntrySize(4, 12) + TinyLFU::EntrySize(4, 4), bytes);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Put("BIG", std::string(1024, 'x')));
+}
+
+TEST(TinyLFUTest, MaxTest) {
+    const size_t entry = TinyLFU::EntrySize(8, 8);
+    TinyLFU storage(100 * entry);
+
+    char key[16];
+    for (int i = 0; i < 10000; i++) {
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        EXPECT_TRUE(storage.Put(key, "valvalva"));
+
+        size_t items, bytes;
+        storage.Usage(items, bytes);
+        ASSERT_LE(bytes, 100 * entry);
+        ASSERT_EQ(items * entry, bytes);
+    }
+}
+
+TEST(TinyLFUTest, UpdateSkipsAdmission) {
+    const size_t entry = TinyLFU::EntrySize(8, 8);
+    TinyLFU storage(10000);
+
+    // Main part is full of keys which are read often
+    char key[16];
+    std::string value;
+    const int keys = 10000 / entry;
+    for (int i = 0; i < keys; i++) {
+        std::snprintf(key, sizeof(key), "key%05d", i);
+        storage.Put(key, "valvalva");
+    }
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < keys; i++) {
+            std::snprintf(key, sizeof(key), "key%05d", i);
+            storage.Get(key, value);
+        }
+    }
+
+    // Updated value overflows the window, still it must not lose to the frequent keys
+    EXPECT_TRUE(storage.Put("x", "1"));
+    EXPECT_TRUE(storage.Put("x", std::string(500, 'x')));
+    EXPECT_TRUE(storage.Get("x", value));
+    EXPECT_EQ(std::string(500, 'x'), value);
+
+    size_t items, bytes;
+    storage.Usage(items, bytes);
+    EXPECT_LE(bytes, 10000);
+}
+
+TEST(TinyLFUTest, ScanDoesntFlushHotKeys) {
+    const size_t entry = TinyLFU::EntrySize(8, 8);
+    TinyLFU storage(200 * entry);
+
+    // Hot keys are asked every round, in between comes a scan as large as the whole cache
+    char key[16];
+    std::string value;
+    size_t hits = 0;
+    for (int round = 0; round < 50; round++) {
+        hits = 0;
+        for (int i = 0; i < 50; i++) {
+            std::snprintf(key, sizeof(key), "hot%05d", i);
+            if (storage.Get(key, value)) {
+                hits++;
+            } else {
+                storage.Put(key, "valvalva");
+            }
+        }
+
+        for (int i = 0; i < 200; i++) {
+            std::snprintf(key, sizeof(key), "cold%04d", (round * 200 + i) % 10000);
+            storage.Put(key, "valvalva");
+        }
+    }
+    EXPECT_EQ(50, hits);
+
+    // Plain LRU loses all of them on the same trace
+    SimpleLRU lru(200 * SimpleLRU::EntrySize(8, 8));
+    for (int i = 0; i < 50; i++) {
+        std::snprintf(key, sizeof(key), "hot%05d", i);
+        lru.Put(key, "valvalva");
+    }
+    for (int i = 0; i < 200; i++) {
+        std::snprintf(key, sizeof(key), "cold%04d", i);
+        lru.Put(key, "valvalva");
+    }
+    EXPECT_FALSE(lru.Get("hot00000", value));
+}
+
+TEST(TinyLFUTest, Expiration) {
+    TinyLFU storage(1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 1));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Set("KEY1", "val1+", Afina::Storage::kKeepTTL));
+    EXPECT_TRUE(storage.Set("KEY2", "val2", Afina::Storage::kKeepTTL));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    EXPECT_EQ(1, storage.Expire());
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+}
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+    TimingWheel wheel(1);
+
+    // Deadlines covers root wheel, every level and parked timers
+    std::vector<uint32_t> deadlines = {2, 3, 255, 256, 257, 300, 16383, 16384, 20000, (1 << 20) + 7, (1 << 26) + 1000};
+    std::vector<TimerHook> hooks(deadlines.size());
+    std::map<TimerHook *, uint32_t> expected;
+    for (size_t i = 0; i < hooks.size(); i++) {
+        wheel.Schedule(hooks[i], deadlines[i]);
+        expected[&hooks[i]] = deadlines[i];
+    }
+
+    // Advance tick by tick, so every timer must fire exactly at its deadline
+    size_t fired = 0;
+    for (uint32_t now = 2; fired < hooks.size() && now < (uint32_t(1) << 27); now++) {
+        fired += wheel.Advance(now, [&](TimerHook &hook) {
+            EXPECT_FALSE(hook.Linked());
+            EXPECT_EQ(expected[&hook], now);
+        });
+    }
+    EXPECT_EQ(hooks.size(), fired);
+
+    for (auto &hook : hooks) {
+        EXPECT_FALSE(hook.Linked());
+    }
+}
+
+TEST(TimingWheelTest, CancelAndReschedule) {
+    TimingWheel wheel(10);
+
+    TimerHook canceled, moved, rescheduled, source;
+    wheel.Schedule(canceled, 20);
+    wheel.Schedule(rescheduled, 20);
+    wheel.Schedule(source, 1000);
+
+    wheel.Cancel(canceled);
+    EXPECT_FALSE(canceled.Linked());
+
+    wheel.Schedule(rescheduled, 5000);
+    wheel.Move(source, moved);
+    EXPECT_FALSE(source.Linked());
+    EXPECT_TRUE(moved.Linked());
+
+    std::vector<TimerHook *> fired;
+    auto record = [&fired](TimerHook &hook) { fired.push_back(&hook); };
+
+    EXPECT_EQ(0, wheel.Advance(999, record));
+    EXPECT_EQ(1, wheel.Advance(1000, record));
+    EXPECT_EQ(&moved, fired.back());
+
+    EXPECT_EQ(1, wheel.Advance(6000, record));
+    EXPECT_EQ(&rescheduled, fired.back());
+
+    // Zero deadline disarms timer
+    wheel.Schedule(canceled, 7000);
+    wheel.Schedule(canceled, 0);
+    EXPECT_EQ(0, wheel.Advance(8000, record));
+}